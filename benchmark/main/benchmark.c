@@ -0,0 +1,415 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_bridge.h"
+#include "ieee802154_sim.h"
+
+/*
+ * Off-target benchmarks of the transceiver pipeline, run over the simulated radio.
+ *
+ * Every result is printed as one JSON object per line on stdout:
+ *   {"bench":"rx_handoff","psdu_len":127,"frames":20000,"ns_per_frame":412.3,"frames_per_s":2425400}
+ *   {"bench":"rx_latency","psdu_len":127,"frames":2000,"avg_us":21.4,"max_us":180.2}
+ *
+ * rx_handoff   ieee802154_transceiver_handle_receive_done(), ISR to receive ring
+ * rx_dispatch  Receive task: dequeue, parse and callback, measured from a filled ring
+ * rx_latency   Receive ISR of a peer's frame to the end of its callback, one frame in flight
+ * tx_build     ieee802154_transceiver_transmit_channel(): build and hand to the radio, not
+ *              waiting for the transmission (tx_sync_wait is off)
+ * relay        Bridge round trip, one frame in flight, peer to peer across channels
+ */
+
+#define RX_CHANNEL 11
+#define TX_CHANNEL 13
+
+#define RX_FRAMES 20000
+#define LATENCY_FRAMES 2000
+#define TX_FRAMES 5000
+#define RELAY_FRAMES 2000
+#define WAIT_TIMEOUT_MS 1000
+
+// Frames per receive burst. The receive task releases a slot only after its callback
+// returns, so the slot of the last frame counted may still be held when the next burst starts.
+#define RX_BURST (CONFIG_IEEE802154_TRANSCEIVER_RX_QUEUE_DEPTH > 1 ? CONFIG_IEEE802154_TRANSCEIVER_RX_QUEUE_DEPTH - 1 : 1)
+
+// Runs above the transceiver tasks, like the radio ISR, so a burst is never interrupted
+#define BENCH_PRIORITY (configMAX_PRIORITIES - 2)
+
+// From a bare ACK to the largest data frame
+static const uint8_t psdu_lengths[] = { 5, 16, 32, 64, 127 };
+
+static TaskHandle_t bench_task_handle = NULL;
+
+static volatile uint32_t rx_count = 0;
+static volatile uint32_t rx_target = 0;
+static volatile int64_t rx_done_ns = 0;
+static volatile bool tx_done = false;
+
+// Receive ISR time of each sequence number, and the latency of the frames delivered since
+static volatile int64_t rx_isr_ns[256];
+static int64_t latency_sum_ns = 0;
+static int64_t latency_max_ns = 0;
+
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+//=========================================================================================
+// esp_ieee802154 callbacks, raised by the simulated radio
+
+void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info)
+{
+    rx_isr_ns[frame[3]] = now_ns();
+    ieee802154_transceiver_handle_receive_done(frame, frame_info);
+}
+
+void esp_ieee802154_transmit_done(const uint8_t *frame, const uint8_t *ack, esp_ieee802154_frame_info_t *ack_frame_info)
+{
+    ieee802154_transceiver_handle_transmit_done(frame, ack, ack_frame_info);
+    tx_done = true;
+    xTaskNotifyGive(bench_task_handle);
+}
+
+void esp_ieee802154_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error)
+{
+    ieee802154_transceiver_handle_transmit_failed(frame, error);
+    tx_done = true;
+    xTaskNotifyGive(bench_task_handle);
+}
+
+
+//=========================================================================================
+// Helpers
+
+static void report(const char *bench, uint8_t psdu_len, uint32_t frames, int64_t elapsed_ns) {
+    double ns_per_frame = frames ? (double)elapsed_ns / frames : 0;
+    double frames_per_s = elapsed_ns > 0 ? frames * 1e9 / elapsed_ns : 0;
+    printf("{\"bench\":\"%s\",\"psdu_len\":%u,\"frames\":%lu,\"ns_per_frame\":%.1f,\"frames_per_s\":%.0f}\n",
+           bench, psdu_len, (unsigned long)frames, ns_per_frame, frames_per_s);
+    fflush(stdout);
+}
+
+static void report_latency(const char *bench, uint8_t psdu_len, uint32_t frames) {
+    double avg_us = frames ? latency_sum_ns / 1e3 / frames : 0;
+    printf("{\"bench\":\"%s\",\"psdu_len\":%u,\"frames\":%lu,\"avg_us\":%.1f,\"max_us\":%.1f}\n",
+           bench, psdu_len, (unsigned long)frames, avg_us, latency_max_ns / 1e3);
+    fflush(stdout);
+}
+
+// Raw frame of the given PSDU length: an ACK for 5 bytes, otherwise a data frame
+// with PAN ID compression and short addresses, padded with payload
+static void make_raw_frame(uint8_t *frame, uint8_t psdu_len, uint8_t seq) {
+    memset(frame, 0, psdu_len + 1);
+    frame[0] = psdu_len;
+    if (psdu_len == 5) {
+        frame[1] = 0x02;
+        frame[3] = seq;
+        return;
+    }
+    const uint8_t header[] = { 0x41, 0x98, seq, 0x34, 0x12, 0xff, 0xff, 0xcd, 0xab };
+    memcpy(&frame[1], header, sizeof(header));
+    memset(&frame[1 + sizeof(header)], 0x5a, psdu_len - sizeof(header) - 2);
+}
+
+// Same frames as make_raw_frame(), in the form ieee802154_frame_build() takes
+static void make_frame(ieee802154_frame_t *frame, uint8_t *payload, uint8_t psdu_len) {
+    memset(frame, 0, sizeof(*frame));
+    frame->fcf.frameVersion = IEEE802154_VERSION_2006;
+    if (psdu_len == 5) {
+        frame->fcf.frameType = IEEE802154_FRAME_TYPE_ACK;
+        return;
+    }
+    frame->fcf.frameType = IEEE802154_FRAME_TYPE_DATA;
+    frame->fcf.panIdCompression = 1;
+    frame->fcf.destAddrMode = IEEE802154_ADDR_MODE_SHORT;
+    frame->fcf.srcAddrMode = IEEE802154_ADDR_MODE_SHORT;
+    frame->destPanId = 0x1234;
+    frame->srcPanId = 0x1234;
+    frame->destAddress[0] = 0xff;
+    frame->destAddress[1] = 0xff;
+    frame->destAddrLen = 2;
+    frame->srcAddress[0] = 0xcd;
+    frame->srcAddress[1] = 0xab;
+    frame->srcAddrLen = 2;
+    frame->payloadLen = psdu_len - 11;
+    memset(payload, 0x5a, frame->payloadLen);
+    frame->payload = payload;
+}
+
+static void count_rx(void) {
+    if (++rx_count == rx_target) {
+        rx_done_ns = now_ns();
+        xTaskNotifyGive(bench_task_handle);
+    }
+}
+
+static void bench_rx_raw_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    count_rx();
+}
+
+static void bench_rx_callback(ieee802154_frame_t *frame, esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    count_rx();
+}
+
+// Both the ACK and the data frames carry their sequence number in frame[3]
+static void latency_rx_raw_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info,
+                                    void *user_data) {
+    int64_t latency_ns = now_ns() - rx_isr_ns[frame[3]];
+    latency_sum_ns += latency_ns;
+    if (latency_ns > latency_max_ns) {
+        latency_max_ns = latency_ns;
+    }
+    count_rx();
+}
+
+// Wait until the receive task has delivered rx_target frames
+static bool wait_rx(void) {
+    while (rx_count < rx_target) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAIT_TIMEOUT_MS)) == 0 && rx_count < rx_target) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//=========================================================================================
+// Receive handoff: cost of the ISR path, in bursts that fit the ring
+
+static void bench_rx_handoff(uint8_t psdu_len) {
+    uint8_t frame[128];
+    esp_ieee802154_frame_info_t frame_info = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    ieee802154_transceiver_stats_t stats;
+    int64_t elapsed_ns = 0;
+
+    ieee802154_transceiver_set_rx_raw_callback(bench_rx_raw_callback, NULL);
+    make_raw_frame(frame, psdu_len, 0);
+    rx_count = 0;
+    rx_target = 0;
+
+    for (uint32_t sent = 0; sent < RX_FRAMES; sent += RX_BURST) {
+        rx_target = sent + RX_BURST;
+        int64_t start_ns = now_ns();
+        for (int i = 0; i < RX_BURST; i++) {
+            ieee802154_transceiver_handle_receive_done(frame, &frame_info);
+        }
+        elapsed_ns += now_ns() - start_ns;
+        if (!wait_rx()) {
+            break;
+        }
+    }
+
+    ieee802154_transceiver_set_rx_raw_callback(NULL, NULL);
+    ieee802154_transceiver_get_stats(&stats, true);
+    if (stats.rx_dropped_queue_full) {
+        printf("{\"bench\":\"rx_handoff\",\"error\":\"%lu frames dropped\"}\n", (unsigned long)stats.rx_dropped_queue_full);
+    }
+    report("rx_handoff", psdu_len, rx_count, elapsed_ns);
+}
+
+
+//=========================================================================================
+// Receive dispatch: a filled ring drained by the receive task
+
+static void bench_rx_dispatch(uint8_t psdu_len) {
+    uint8_t frame[128];
+    esp_ieee802154_frame_info_t frame_info = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    ieee802154_transceiver_stats_t stats;
+    int64_t elapsed_ns = 0;
+
+    ieee802154_transceiver_set_rx_callback(bench_rx_callback, NULL);
+    make_raw_frame(frame, psdu_len, 0);
+    rx_count = 0;
+    rx_target = 0;
+
+    for (uint32_t sent = 0; sent < RX_FRAMES; sent += RX_BURST) {
+        for (int i = 0; i < RX_BURST; i++) {
+            ieee802154_transceiver_handle_receive_done(frame, &frame_info);
+        }
+        // The receive task only runs once this task blocks
+        rx_target = sent + RX_BURST;
+        int64_t start_ns = now_ns();
+        if (!wait_rx()) {
+            break;
+        }
+        elapsed_ns += rx_done_ns - start_ns;
+    }
+
+    ieee802154_transceiver_set_rx_callback(NULL, NULL);
+    ieee802154_transceiver_get_stats(&stats, true);
+    report("rx_dispatch", psdu_len, rx_count, elapsed_ns);
+}
+
+
+//=========================================================================================
+// Receive latency: a peer's frames, one at a time, from the receive ISR to the callback
+
+static void bench_rx_latency(uint8_t psdu_len) {
+    uint8_t frame[128];
+    uint32_t frames = 0;
+
+    ieee802154_sim_reset();
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+    ieee802154_transceiver_set_rx_raw_callback(latency_rx_raw_callback, NULL);
+
+    // Below the transceiver tasks, as an application would be
+    vTaskPrioritySet(NULL, tskIDLE_PRIORITY + 1);
+
+    rx_count = 0;
+    latency_sum_ns = 0;
+    latency_max_ns = 0;
+    for (uint32_t i = 0; i < LATENCY_FRAMES; i++) {
+        rx_target = i + 1;
+        make_raw_frame(frame, psdu_len, (uint8_t)i);
+        ieee802154_sim_node_transmit(sender, frame);
+        if (!wait_rx()) {
+            break;
+        }
+        frames++;
+    }
+
+    vTaskPrioritySet(NULL, BENCH_PRIORITY);
+
+    ieee802154_transceiver_set_rx_raw_callback(NULL, NULL);
+    ieee802154_sim_reset();
+    report_latency("rx_latency", psdu_len, frames);
+}
+
+
+//=========================================================================================
+// Transmit build: frame structure to radio, one transmission at a time
+
+static void bench_tx_build(uint8_t psdu_len) {
+    ieee802154_frame_t frame;
+    uint8_t payload[128];
+    int64_t elapsed_ns = 0;
+    uint32_t frames = 0;
+
+    make_frame(&frame, payload, psdu_len);
+
+    for (uint32_t i = 0; i < TX_FRAMES; i++) {
+        frame.sequenceNumber = (uint8_t)i;
+        tx_done = false;
+        int64_t start_ns = now_ns();
+        if (ieee802154_transceiver_transmit_channel(&frame, TX_CHANNEL) != ESP_OK) {
+            break;
+        }
+        elapsed_ns += now_ns() - start_ns;
+        frames++;
+
+        // Wait for the radio before reusing the transmit buffer, outside the measurement
+        while (!tx_done) {
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAIT_TIMEOUT_MS)) == 0 && !tx_done) {
+                break;
+            }
+        }
+    }
+
+    ieee802154_transceiver_set_channel(RX_CHANNEL);
+    report("tx_build", psdu_len, frames, elapsed_ns);
+}
+
+
+//=========================================================================================
+// Relay: frames/s through the bridge, from a peer on one channel to a peer on another
+
+static void relay_peer_callback(int node, const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info,
+                                void *ctx) {
+    count_rx();
+}
+
+static void bench_relay(uint8_t psdu_len) {
+    uint8_t frame[128];
+    uint32_t frames = 0;
+
+    ieee802154_sim_reset();
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+    config.channel = TX_CHANNEL;
+    config.rx_cb = relay_peer_callback;
+    ieee802154_sim_node_create(&config);
+
+    ieee802154_transceiver_bridge_config_t bridge_config = {
+        .src_channel = RX_CHANNEL,
+        .dst_channel = TX_CHANNEL,
+        .max_batch = 1,
+    };
+    if (ieee802154_transceiver_bridge_start(&bridge_config) != ESP_OK) {
+        printf("{\"bench\":\"relay\",\"error\":\"bridge start failed\"}\n");
+        return;
+    }
+
+    // Below the transceiver tasks, so the next frame is only sent once the
+    // transmit task has finished and returned the radio to the source channel
+    vTaskPrioritySet(NULL, tskIDLE_PRIORITY + 1);
+
+    rx_count = 0;
+    int64_t start_ns = now_ns();
+    for (uint32_t i = 0; i < RELAY_FRAMES; i++) {
+        rx_target = i + 1;
+        make_raw_frame(frame, psdu_len, (uint8_t)i);
+        ieee802154_sim_node_transmit(sender, frame);
+        if (!wait_rx()) {
+            break;
+        }
+        while (esp_ieee802154_get_channel() != RX_CHANNEL) {
+            vTaskDelay(1);
+        }
+        frames++;
+    }
+    int64_t elapsed_ns = now_ns() - start_ns;
+
+    vTaskPrioritySet(NULL, BENCH_PRIORITY);
+
+    ieee802154_transceiver_bridge_stop();
+    ieee802154_sim_reset();
+    report("relay", psdu_len, frames, elapsed_ns);
+}
+
+
+//=========================================================================================
+// Main
+
+void app_main(void)
+{
+    bench_task_handle = xTaskGetCurrentTaskHandle();
+    vTaskPrioritySet(NULL, BENCH_PRIORITY);
+
+    // tx_sync_wait stays off, so tx_build never includes the transmission itself
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(RX_CHANNEL);
+    config.tx_sync_wait = false;
+    if (ieee802154_transceiver_init_with_config(&config) != ESP_OK) {
+        printf("{\"error\":\"transceiver init failed\"}\n");
+        exit(1);
+    }
+
+    for (size_t i = 0; i < sizeof(psdu_lengths); i++) {
+        bench_rx_handoff(psdu_lengths[i]);
+    }
+    for (size_t i = 0; i < sizeof(psdu_lengths); i++) {
+        bench_rx_dispatch(psdu_lengths[i]);
+    }
+    for (size_t i = 0; i < sizeof(psdu_lengths); i++) {
+        bench_rx_latency(psdu_lengths[i]);
+    }
+    for (size_t i = 0; i < sizeof(psdu_lengths); i++) {
+        bench_tx_build(psdu_lengths[i]);
+    }
+    for (size_t i = 0; i < sizeof(psdu_lengths); i++) {
+        bench_relay(psdu_lengths[i]);
+    }
+
+    ieee802154_transceiver_deinit();
+    exit(0);
+}
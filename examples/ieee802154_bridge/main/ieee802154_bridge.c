@@ -1,182 +1,148 @@
-#include <stdio.h>
-
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-
-#include "nvs_flash.h"
-
-#include <esp_ieee802154.h>
-#include <esp_log.h>
-//#include <esp_mac.h>
-#include <esp_timer.h>
-
-#include "ieee802154_transceiver.h"
-
-
-#define TAG "IEEE802154_BRIDGE"
-
-#define RX_CHANNEL 11
-#define TX_CHANNEL 13
-
-static bool transmitting = false;
-
-
-
-//=========================================================================================
-// Log performance
-
-#define NUM_SAMPLES 100
-static int64_t total_time_us = 0;
-static uint32_t sample_count = 0;
-static int64_t start_time = 0;
-static QueueHandle_t log_queue = NULL;
-
-void capture_start()
-{
-    start_time = esp_timer_get_time();
-}
-
-void capture_done()
-{
-    int64_t end_time = esp_timer_get_time();
-    int64_t elapsed_time = end_time - start_time;
-
-    total_time_us += elapsed_time;
-    sample_count++;
-
-    if (sample_count >= NUM_SAMPLES) {
-        float average_time_us = (float)total_time_us / NUM_SAMPLES;
-        if (log_queue != NULL) {
-            xQueueSendFromISR(log_queue, &average_time_us, NULL);
-        }
-        total_time_us = 0;
-        sample_count = 0;
-    }
-}
-
-void log_task(void *pvParameters)
-{
-    float average_time_us;
-    while (1) {
-        if (xQueueReceive(log_queue, &average_time_us, portMAX_DELAY)) {
-            ESP_LOGI(TAG, "Average execution time over %d samples: %.2f us", NUM_SAMPLES, average_time_us);
-        }
-    }
-}
-
-
-
-//=========================================================================================
-// esp_ieee802154 interrupt callbacks
-
-// The SFD field of the frame was received.
-void esp_ieee802154_receive_sfd_done(void)
-{
-	// ESP_EARLY_LOGI(TAG, "rx sfd done");
-}
-
-// Callback for received IEEE 802.15.4 frames.
-void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info)
-{
-    capture_start();
-    ieee802154_transceiver_handle_receive_done(frame, frame_info);
-}
-
-// The Frame Transmission succeeded.
-void esp_ieee802154_transmit_done(const uint8_t *frame, const uint8_t *ack, esp_ieee802154_frame_info_t *ack_frame_info)
-{
-    transmitting = false;
-    capture_done();
-	// ESP_EARLY_LOGI(TAG, "tx OK, sent %d bytes, ack %d", frame[0], ack != NULL);
-}
-
-// The Frame Transmission failed.
-void esp_ieee802154_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error)
-{
-    transmitting = false;
-    capture_done();
-	ESP_EARLY_LOGW(TAG, "tx failed, error %d", error);
-}
-
-// The SFD field of the frame was transmitted.
-void esp_ieee802154_transmit_sfd_done(uint8_t *frame)
-{
-	// ESP_EARLY_LOGI(TAG, "tx sfd done");
-}
-
-
-
-//=========================================================================================
-// Callback for received frames.
-static void rx_callback(ieee802154_frame_t *frame, esp_ieee802154_frame_info_t *frame_info, void *user_data)
-{
-    // ESP_LOGI(TAG, "Received.");
-    // ESP_LOGI(TAG, "payloadLen: %d", frame->payloadLen);
-
-    // Send to another channel
-    esp_err_t ret;
-    ret = ieee802154_transceiver_transmit_channel(frame, TX_CHANNEL);
-    if (ret) {
-        ESP_LOGE(TAG, "transmit failed.");
-    }
-
-    // Wait for the end of transmitting
-    transmitting = true;
-    while (transmitting) { vTaskDelay( 1 / portTICK_PERIOD_MS ); }
-
-    // Back to receiving channel
-    ret = ieee802154_transceiver_set_channel(RX_CHANNEL);
-    if (ret) {
-        ESP_LOGE(TAG, "recover channel failed.");
-    }
-}
-
-
-//=========================================================================================
-// main
-void app_main(void)
-{
-    // Initialize NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ret = nvs_flash_erase();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to erase NVS: %d", ret);
-            return;
-        }
-        ret = nvs_flash_init();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
-            return;
-        }
-    } else if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
-        return;
-    }
-
-    // Prepare performance log
-    log_queue = xQueueCreate(10, sizeof(float));
-    if (log_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create log queue");
-        return;
-    }
-    xTaskCreate(log_task, "log_task", 2048, NULL, 5, NULL);
-
-
-    // Set receive callback
-    ret = ieee802154_transceiver_set_rx_callback(rx_callback, NULL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set receive callback: %d", ret);
-        return;
-    }
-
-    // Initialize transceiver with channel
-    ret = ieee802154_transceiver_init(RX_CHANNEL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize transceiver: %d", ret);
-        return;
-    }
-
-    ESP_LOGI(TAG, "esp_ieee802154_get_pending_mode: %d", esp_ieee802154_get_pending_mode());
-    ESP_LOGI(TAG, "esp_ieee802154_get_txpower: %d", esp_ieee802154_get_txpower());
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "nvs_flash.h"
+
+#include <esp_ieee802154.h>
+#include <esp_log.h>
+//#include <esp_mac.h>
+#include <esp_timer.h>
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_bridge.h"
+#include "ieee802154_transceiver_trace.h"
+
+
+#define TAG "IEEE802154_BRIDGE"
+
+#define RX_CHANNEL 11
+#define TX_CHANNEL 13
+#define MAX_BATCH 4
+#define MAX_HOLD_MS 2
+
+
+
+//=========================================================================================
+// Log performance
+
+#define LOG_INTERVAL_MS 5000
+
+void log_task(void *pvParameters)
+{
+    ieee802154_transceiver_bridge_stats_t stats;
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(LOG_INTERVAL_MS));
+        ieee802154_transceiver_bridge_get_stats(&stats, true);
+        if (stats.latency_samples > 0) {
+            ESP_LOGI(TAG, "Average relay latency over %lu samples: %lu us (max %lu us)",
+                     stats.latency_samples, stats.latency_avg_us, stats.latency_max_us);
+        }
+        ESP_LOGI(TAG, "forwarded %lu, dropped %lu, tx failed %lu, batches %lu",
+                 stats.forwarded, stats.dropped, stats.tx_failed, stats.batches);
+
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+        // Where the relay time goes, stage by stage
+        ieee802154_transceiver_trace_hist_t hist;
+        for (int stage = 0; stage < IEEE802154_TRANSCEIVER_TRACE_STAGE_MAX; stage++) {
+            if (ieee802154_transceiver_trace_get(stage, &hist) != ESP_OK || hist.count == 0) {
+                continue;
+            }
+            ESP_LOGI(TAG, "  %-8s n=%lu p50=%lu p99=%lu max=%lu us",
+                     ieee802154_transceiver_trace_stage_name(stage), hist.count,
+                     ieee802154_transceiver_trace_percentile(&hist, 50),
+                     ieee802154_transceiver_trace_percentile(&hist, 99), hist.max_us);
+        }
+        ieee802154_transceiver_trace_reset();
+#endif
+    }
+}
+
+
+
+//=========================================================================================
+// esp_ieee802154 interrupt callbacks
+
+// The SFD field of the frame was received.
+void esp_ieee802154_receive_sfd_done(void)
+{
+	// ESP_EARLY_LOGI(TAG, "rx sfd done");
+}
+
+// Callback for received IEEE 802.15.4 frames.
+void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info)
+{
+    ieee802154_transceiver_handle_receive_done(frame, frame_info);
+}
+
+// The Frame Transmission succeeded.
+void esp_ieee802154_transmit_done(const uint8_t *frame, const uint8_t *ack, esp_ieee802154_frame_info_t *ack_frame_info)
+{
+    ieee802154_transceiver_handle_transmit_done(frame, ack, ack_frame_info);
+}
+
+// The Frame Transmission failed.
+void esp_ieee802154_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error)
+{
+    ieee802154_transceiver_handle_transmit_failed(frame, error);
+}
+
+// The SFD field of the frame was transmitted.
+void esp_ieee802154_transmit_sfd_done(uint8_t *frame)
+{
+	// ESP_EARLY_LOGI(TAG, "tx sfd done");
+}
+
+
+
+//=========================================================================================
+// main
+void app_main(void)
+{
+    // Initialize NVS
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ret = nvs_flash_erase();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to erase NVS: %d", ret);
+            return;
+        }
+        ret = nvs_flash_init();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
+            return;
+        }
+    } else if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
+        return;
+    }
+
+    // Initialize transceiver with channel
+    ret = ieee802154_transceiver_init(RX_CHANNEL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize transceiver: %d", ret);
+        return;
+    }
+
+    // Forward everything from RX_CHANNEL to TX_CHANNEL. The bridge queues frames,
+    // sends up to MAX_BATCH per channel switch and returns to RX_CHANNEL by itself.
+    ieee802154_transceiver_bridge_config_t bridge_config = {
+        .src_channel = RX_CHANNEL,
+        .dst_channel = TX_CHANNEL,
+        .filter = NULL,
+        .max_batch = MAX_BATCH,
+        .max_hold_ms = MAX_HOLD_MS,
+    };
+    ret = ieee802154_transceiver_bridge_start(&bridge_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start bridge: %d", ret);
+        return;
+    }
+
+    // Prepare performance log
+    xTaskCreate(log_task, "log_task", 2048 + 512, NULL, 5, NULL);
+
+    ESP_LOGI(TAG, "esp_ieee802154_get_pending_mode: %d", esp_ieee802154_get_pending_mode());
+    ESP_LOGI(TAG, "esp_ieee802154_get_txpower: %d", esp_ieee802154_get_txpower());
 }
\ No newline at end of file
@@ -1,128 +1,240 @@
-#include <stdio.h>
-
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-
-#include "esp_log.h"
-#include "nvs_flash.h"
-
-#include "ieee802154_transceiver.h"
-
-#define TAG "IEEE802154_SNIFFER"
-
-#define RX_CHANNEL 11
-
-
-
-// Function to format a byte buffer as a hexadecimal string in one line
-int hex_dump_in_oneline(char *line, size_t line_size, const uint8_t *buffer, size_t len)
-{
-    size_t line_pos = 0; // Current position in the output line
-
-    // Check if the output buffer size is valid
-    if (line_size == 0) {
-        return 0; // Return 0 if no space is available
-    }
-
-    // Iterate through each byte in the input buffer
-    for (size_t i = 0; i < len; i++) {
-        // Append the byte as a two-digit hexadecimal value
-        int written = snprintf(line + line_pos, line_size - line_pos, "%02x", buffer[i]);
-        if (written < 0 || (size_t)written >= line_size - line_pos) {
-            ESP_LOGE(TAG, "Buffer overflow at byte %zu", i);
-            break; // Stop if there's not enough space
-        }
-        line_pos += written;
-
-        // Add a double space every 8 bytes, except for the last byte
-        if ((i + 1) % 8 == 0 && i != len - 1) {
-            written = snprintf(line + line_pos, line_size - line_pos, "  ");
-            if (written < 0 || (size_t)written >= line_size - line_pos) {
-                ESP_LOGE(TAG, "Buffer overflow at delimiter %zu", i);
-                break; // Stop if there's not enough space
-            }
-            line_pos += written;
-        } else if (i != len - 1) {
-            // Add a single space between bytes, except for the last byte
-            written = snprintf(line + line_pos, line_size - line_pos, " ");
-            if (written < 0 || (size_t)written >= line_size - line_pos) {
-                ESP_LOGE(TAG, "Buffer overflow at space %zu", i);
-                break; // Stop if there's not enough space
-            }
-            line_pos += written;
-        }
-    }
-
-    // Ensure the output string is null-terminated
-    if (line_pos < line_size) {
-        line[line_pos] = '\0';
-    } else {
-        line[line_size - 1] = '\0'; // Truncate if buffer is full
-    }
-
-    return line_pos; // Return the number of characters written
-}
-
-
-
-// Callback for received IEEE 802.15.4 frames.
-void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info)
-{
-    ieee802154_transceiver_handle_receive_done(frame, frame_info);
-}
-
-// Callback for received frames.
-static void rx_callback(ieee802154_frame_t *frame, esp_ieee802154_frame_info_t *frame_info, void *user_data)
-{
-    char buff[512] = {0};
-    int pos = 0;
-    pos += sprintf(&buff[pos], "frameType: %s", ieee802154_frame_type_to_str(frame->fcf.frameType));
-    pos += sprintf(&buff[pos], ", seqNum: %02x", frame->sequenceNumber);
-    pos += sprintf(&buff[pos], ", dstPanId: %04x", frame->destPanId);
-
-    pos += sprintf(&buff[pos], ", dstAddr: ");
-    pos += hex_dump_in_oneline(&buff[pos], sizeof(buff) - pos, frame->destAddress, frame->destAddrLen);
-
-    pos += sprintf(&buff[pos], ", srcAddr: ");
-    pos += hex_dump_in_oneline(&buff[pos], sizeof(buff) - pos, frame->srcAddress, frame->srcAddrLen);
-
-    pos += sprintf(&buff[pos], ", payload: ");
-    pos += hex_dump_in_oneline(&buff[pos], sizeof(buff) - pos, frame->payload, frame->payloadLen);
-
-    ESP_LOGI(TAG, "%s", buff);
-}
-
-void app_main(void)
-{
-    // Initialize NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ret = nvs_flash_erase();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to erase NVS: %d", ret);
-            return;
-        }
-        ret = nvs_flash_init();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
-            return;
-        }
-    } else if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
-        return;
-    }
-
-    // Set receive callback
-    ret = ieee802154_transceiver_set_rx_callback(rx_callback, NULL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set receive callback: %d", ret);
-        return;
-    }
-
-    // Initialize transceiver with channel
-    ret = ieee802154_transceiver_init(RX_CHANNEL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize transceiver: %d", ret);
-        return;
-    }
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "nvs_flash.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_hop.h"
+#include "ieee802154_transceiver_pcap.h"
+
+#define TAG "IEEE802154_SNIFFER"
+
+#define RX_CHANNEL 11
+
+// Set to 1 to cycle through all 16 channels instead of staying on RX_CHANNEL
+#define HOP_ENABLED 0
+#define HOP_DWELL_MS 50
+#define HOP_MAX_DWELL_MS 200
+#define HOP_EXTEND_MS 50
+#define HOP_STATS_INTERVAL_MS 10000
+
+// Set to 1 to stream a pcapng capture over the console port instead of logging frames
+#define PCAP_ENABLED 0
+#define PCAP_BAUD_RATE 921600
+
+#if PCAP_ENABLED
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+#include "driver/usb_serial_jtag.h"
+#else
+#include "driver/uart.h"
+#endif
+#endif
+
+
+
+// Function to format a byte buffer as a hexadecimal string in one line
+int hex_dump_in_oneline(char *line, size_t line_size, const uint8_t *buffer, size_t len)
+{
+    size_t line_pos = 0; // Current position in the output line
+
+    // Check if the output buffer size is valid
+    if (line_size == 0) {
+        return 0; // Return 0 if no space is available
+    }
+
+    // Iterate through each byte in the input buffer
+    for (size_t i = 0; i < len; i++) {
+        // Append the byte as a two-digit hexadecimal value
+        int written = snprintf(line + line_pos, line_size - line_pos, "%02x", buffer[i]);
+        if (written < 0 || (size_t)written >= line_size - line_pos) {
+            ESP_LOGE(TAG, "Buffer overflow at byte %zu", i);
+            break; // Stop if there's not enough space
+        }
+        line_pos += written;
+
+        // Add a double space every 8 bytes, except for the last byte
+        if ((i + 1) % 8 == 0 && i != len - 1) {
+            written = snprintf(line + line_pos, line_size - line_pos, "  ");
+            if (written < 0 || (size_t)written >= line_size - line_pos) {
+                ESP_LOGE(TAG, "Buffer overflow at delimiter %zu", i);
+                break; // Stop if there's not enough space
+            }
+            line_pos += written;
+        } else if (i != len - 1) {
+            // Add a single space between bytes, except for the last byte
+            written = snprintf(line + line_pos, line_size - line_pos, " ");
+            if (written < 0 || (size_t)written >= line_size - line_pos) {
+                ESP_LOGE(TAG, "Buffer overflow at space %zu", i);
+                break; // Stop if there's not enough space
+            }
+            line_pos += written;
+        }
+    }
+
+    // Ensure the output string is null-terminated
+    if (line_pos < line_size) {
+        line[line_pos] = '\0';
+    } else {
+        line[line_size - 1] = '\0'; // Truncate if buffer is full
+    }
+
+    return line_pos; // Return the number of characters written
+}
+
+
+
+// Callback for received IEEE 802.15.4 frames.
+void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info)
+{
+    ieee802154_transceiver_handle_receive_done(frame, frame_info);
+}
+
+#if !PCAP_ENABLED
+// Callback for received frames.
+static void rx_callback(ieee802154_frame_t *frame, esp_ieee802154_frame_info_t *frame_info, void *user_data)
+{
+    char buff[512] = {0};
+    int pos = 0;
+    pos += sprintf(&buff[pos], "ch: %d, ", frame_info->channel);
+    pos += sprintf(&buff[pos], "frameType: %s", ieee802154_frame_type_to_str(frame->fcf.frameType));
+    pos += sprintf(&buff[pos], ", seqNum: %02x", frame->sequenceNumber);
+    pos += sprintf(&buff[pos], ", dstPanId: %04x", frame->destPanId);
+
+    pos += sprintf(&buff[pos], ", dstAddr: ");
+    pos += hex_dump_in_oneline(&buff[pos], sizeof(buff) - pos, frame->destAddress, frame->destAddrLen);
+
+    pos += sprintf(&buff[pos], ", srcAddr: ");
+    pos += hex_dump_in_oneline(&buff[pos], sizeof(buff) - pos, frame->srcAddress, frame->srcAddrLen);
+
+    pos += sprintf(&buff[pos], ", payload: ");
+    pos += hex_dump_in_oneline(&buff[pos], sizeof(buff) - pos, frame->payload, frame->payloadLen);
+
+    ESP_LOGI(TAG, "%s", buff);
+}
+#endif
+
+#if PCAP_ENABLED
+// Capture output: the console port, with logging turned off
+static void pcap_output(const uint8_t *data, size_t len, void *ctx)
+{
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+    usb_serial_jtag_write_bytes(data, len, portMAX_DELAY);
+#else
+    uart_write_bytes(CONFIG_ESP_CONSOLE_UART_NUM, data, len);
+#endif
+}
+
+// Callback for received frames, recorded as is without parsing
+static void rx_raw_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data)
+{
+    ieee802154_transceiver_pcap_record(frame, frame_info);
+}
+
+static esp_err_t pcap_output_init(void)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+    usb_serial_jtag_driver_config_t config = {
+        .tx_buffer_size = 8192,
+        .rx_buffer_size = 256,
+    };
+    return usb_serial_jtag_driver_install(&config);
+#else
+    esp_err_t ret = uart_driver_install(CONFIG_ESP_CONSOLE_UART_NUM, 256, 8192, 0, NULL, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return uart_set_baudrate(CONFIG_ESP_CONSOLE_UART_NUM, PCAP_BAUD_RATE);
+#endif
+}
+#endif
+
+#if HOP_ENABLED
+// Task to periodically trace per-channel hopping statistics
+static void hop_stats_task(void *pvParameters)
+{
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(HOP_STATS_INTERVAL_MS));
+
+        for (uint8_t channel = 11; channel <= 26; channel++) {
+            ieee802154_transceiver_hop_stats_t stats;
+            if (ieee802154_transceiver_hop_get_stats(channel, &stats) == ESP_OK) {
+                ESP_LOGI(TAG, "ch %2d: frames %lu, bytes %lu, drops %lu, visits %lu, dwell %lu ms",
+                         channel, (unsigned long)stats.frames, (unsigned long)stats.bytes,
+                         (unsigned long)stats.drops, (unsigned long)stats.visits, (unsigned long)stats.dwell_ms);
+            }
+        }
+    }
+}
+#endif
+
+void app_main(void)
+{
+    // Initialize NVS
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ret = nvs_flash_erase();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to erase NVS: %d", ret);
+            return;
+        }
+        ret = nvs_flash_init();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
+            return;
+        }
+    } else if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize NVS: %d", ret);
+        return;
+    }
+
+#if PCAP_ENABLED
+    // Stream every frame to the host as pcapng
+    ret = pcap_output_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up capture output: %d", ret);
+        return;
+    }
+    ieee802154_transceiver_pcap_config_t pcap_config = {
+        .output = pcap_output,
+    };
+    ret = ieee802154_transceiver_pcap_start(&pcap_config);
+    if (ret != ESP_OK) {
+        return;
+    }
+    ret = ieee802154_transceiver_set_rx_raw_callback(rx_raw_callback, NULL);
+#else
+    // Set receive callback
+    ret = ieee802154_transceiver_set_rx_callback(rx_callback, NULL);
+#endif
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set receive callback: %d", ret);
+        return;
+    }
+
+    // Initialize transceiver with channel
+    ret = ieee802154_transceiver_init(RX_CHANNEL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize transceiver: %d", ret);
+        return;
+    }
+
+#if HOP_ENABLED
+    // Cycle through every channel, staying longer where there is traffic
+    ieee802154_transceiver_hop_config_t hop_config = {
+        .channel_mask = IEEE802154_TRANSCEIVER_HOP_ALL_CHANNELS,
+        .dwell_ms = HOP_DWELL_MS,
+        .max_dwell_ms = HOP_MAX_DWELL_MS,
+        .extend_ms = HOP_EXTEND_MS,
+    };
+    ret = ieee802154_transceiver_hop_start(&hop_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start hopping: %d", ret);
+        return;
+    }
+    xTaskCreate(hop_stats_task, "hop_stats", 3072, NULL, 4, NULL);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "host_test.h"
+
+void setUp(void) {
+    // Do nothing
+}
+
+void tearDown(void) {
+    // Do nothing
+}
+
+//=========================================================================================
+// Shared helpers
+
+volatile uint32_t peer_rx_count;
+volatile uint32_t tx_done_count;
+volatile uint32_t tx_done_errors;
+
+const uint8_t broadcast_addr[2] = { 0xff, 0xff };
+
+size_t build_frame(uint8_t *frame, const test_frame_t *fields) {
+    uint16_t fcf = fields->type | (fields->ack_request ? 1 << 5 : 0);
+    if (fields->dest_len) {
+        fcf |= (fields->dest_len == 8 ? 3 : 2) << 10;
+        fcf |= fields->src_len ? 1 << 6 : 0; // PAN ID compression
+    }
+    if (fields->src_len) {
+        fcf |= (fields->src_len == 8 ? 3 : 2) << 14;
+    }
+
+    uint8_t *p = &frame[1];
+    *p++ = fcf & 0xff;
+    *p++ = fcf >> 8;
+    *p++ = fields->seq;
+    if (fields->dest_len || fields->src_len) {
+        *p++ = fields->pan_id & 0xff;
+        *p++ = fields->pan_id >> 8;
+    }
+    if (fields->dest_len) {
+        memcpy(p, fields->dest, fields->dest_len);
+        p += fields->dest_len;
+    }
+    if (fields->src_len) {
+        memcpy(p, fields->src, fields->src_len);
+        p += fields->src_len;
+    }
+
+    size_t payload = p - frame;
+    if (fields->payload) {
+        memcpy(p, fields->payload, fields->payload_len);
+    } else {
+        memset(p, fields->seq, fields->payload_len);
+    }
+    p += fields->payload_len;
+    frame[0] = (p - &frame[1]) + 2;
+    return payload;
+}
+
+size_t make_data_frame(uint8_t *frame, uint8_t seq, uint16_t dest, uint16_t src, uint8_t payload_len) {
+    const uint8_t dest_addr[2] = { dest & 0xff, dest >> 8 };
+    const uint8_t src_addr[2] = { src & 0xff, src >> 8 };
+    test_frame_t fields = {
+        .type = 1,
+        .seq = seq,
+        .pan_id = TEST_PAN_ID,
+        .dest = dest_addr,
+        .dest_len = 2,
+        .src = src_addr,
+        .src_len = 2,
+        .payload_len = payload_len,
+    };
+    return build_frame(frame, &fields);
+}
+
+void fill_frame(uint8_t *frame, uint8_t psdu_len, uint8_t first) {
+    frame[0] = psdu_len;
+    for (int i = 1; i <= psdu_len; i++) {
+        frame[i] = (uint8_t)(first + i);
+    }
+}
+
+bool wait_for(volatile uint32_t *counter, uint32_t expected) {
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(WAIT_TIMEOUT_MS);
+    while (*counter < expected && xTaskGetTickCount() < deadline) {
+        vTaskDelay(1);
+    }
+    return *counter >= expected;
+}
+
+void reset_traffic_counters(void) {
+    peer_rx_count = 0;
+    tx_done_count = 0;
+    tx_done_errors = 0;
+}
+
+void count_peer_callback(int node, const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *ctx) {
+    peer_rx_count++;
+}
+
+void count_tx_done(const ieee802154_transceiver_tx_result_t *result, void *ctx) {
+    uint8_t channel = (uint8_t)(uintptr_t)ctx;
+    if (result->status != ESP_OK || (channel && result->channel != channel)) {
+        tx_done_errors++;
+    }
+    tx_done_count++;
+}
+
+//=========================================================================================
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    run_frame_ring_tests();
+    run_trace_hist_tests();
+    run_pipeline_tests();
+    run_pcapng_tests();
+    run_capture_ring_tests();
+    run_subscriber_tests();
+    run_dedupe_cache_tests();
+    run_neighbor_table_tests();
+    run_energy_scan_tests();
+    run_address_filter_tests();
+    run_tx_policy_tests();
+    run_frag_tests();
+    run_filter_table_tests();
+    exit(UNITY_END());
+}
@@ -0,0 +1,84 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_ieee802154.h"
+#include "ieee802154_transceiver.h"
+
+#define WAIT_TIMEOUT_MS 2000 // Longest wait for simulated traffic to settle
+#define TEST_PAN_ID 0x1234
+
+// Test groups, one per source file
+void run_frame_ring_tests(void);
+void run_trace_hist_tests(void);
+void run_pipeline_tests(void);
+void run_pcapng_tests(void);
+void run_capture_ring_tests(void);
+void run_subscriber_tests(void);
+void run_dedupe_cache_tests(void);
+void run_neighbor_table_tests(void);
+void run_energy_scan_tests(void);
+void run_address_filter_tests(void);
+void run_tx_policy_tests(void);
+void run_frag_tests(void);
+void run_filter_table_tests(void);
+
+// Shared helpers, in host_test.c
+
+// Fields of a MAC frame for build_frame(); an address length of 0 leaves that address out
+typedef struct {
+    uint8_t type; // Frame type, 1 for data, 3 for MAC command
+    bool ack_request;
+    uint8_t seq;
+    uint16_t pan_id;         // Destination PAN, or the source PAN without a destination
+    const uint8_t *dest;     // Little-endian, as sent
+    uint8_t dest_len;        // 0, 2 or 8
+    const uint8_t *src;      // Little-endian, as sent
+    uint8_t src_len;         // 0, 2 or 8; PAN ID compression is set when both addresses are present
+    const uint8_t *payload;  // NULL for payload_len bytes set to seq
+    uint8_t payload_len;
+} test_frame_t;
+
+extern const uint8_t broadcast_addr[2];
+
+/**
+ * @brief Build a MAC frame with a 2-byte FCS placeholder.
+ *
+ * @return Offset of the payload in frame (frame[0] is the PSDU length).
+ */
+size_t build_frame(uint8_t *frame, const test_frame_t *fields);
+
+/**
+ * @brief Build a data frame on TEST_PAN_ID with short addresses and PAN ID compression.
+ *
+ * The payload_len payload bytes are all set to seq.
+ *
+ * @return Offset of the payload in frame (frame[0] is the PSDU length).
+ */
+size_t make_data_frame(uint8_t *frame, uint8_t seq, uint16_t dest, uint16_t src, uint8_t payload_len);
+
+/**
+ * @brief Wait up to WAIT_TIMEOUT_MS for a counter to reach expected.
+ */
+bool wait_for(volatile uint32_t *counter, uint32_t expected);
+
+// Fill a psdu_len frame with the byte pattern first + 1, first + 2, ... for codec round trips
+void fill_frame(uint8_t *frame, uint8_t psdu_len, uint8_t first);
+
+// Frames received by simulated peers, and transmit outcomes; cleared by reset_traffic_counters()
+extern volatile uint32_t peer_rx_count;
+extern volatile uint32_t tx_done_count;
+extern volatile uint32_t tx_done_errors;
+
+void reset_traffic_counters(void);
+
+// ieee802154_sim_rx_callback_t counting into peer_rx_count
+void count_peer_callback(int node, const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *ctx);
+
+// Transmit done callback counting into tx_done_count; ctx is the channel expected, or NULL for any
+void count_tx_done(const ieee802154_transceiver_tx_result_t *result, void *ctx);
+
+#endif // HOST_TEST_H
@@ -0,0 +1,257 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 11
+#define PAN_ID 0x1234
+#define SHORT_ADDR 0x0001
+#define PEER_ADDR 0x00aa
+
+static const uint8_t ext_addr[8] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+static const uint8_t peer_short[2] = { PEER_ADDR & 0xff, PEER_ADDR >> 8 };
+
+// Acknowledgments heard by the peer
+static volatile uint32_t ack_count;
+static volatile uint8_t ack_seq;
+static volatile bool ack_pending;
+
+static void peer_callback(int node, const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *ctx) {
+    if ((frame[1] & 0x07) == 0x02) {
+        ack_seq = frame[3];
+        ack_pending = (frame[1] >> 4) & 0x01;
+        ack_count++;
+    }
+}
+
+static const uint8_t own_short[2] = { SHORT_ADDR & 0xff, SHORT_ADDR >> 8 };
+static const uint8_t other_short[2] = { 0x02, 0x00 };
+static const uint8_t data_request[] = { 0x04 };
+
+// Acknowledged data frame from the peer's short address to ours
+static const test_frame_t peer_frame = {
+    .type = 0x01,
+    .ack_request = true,
+    .pan_id = PAN_ID,
+    .dest = own_short,
+    .dest_len = 2,
+    .src = peer_short,
+    .src_len = 2,
+    .payload = (const uint8_t[]){ 0xaa },
+    .payload_len = 1,
+};
+
+// Beacon from the peer, without a destination; pan_id is the source PAN
+static const test_frame_t peer_beacon = {
+    .type = 0x00,
+    .src = peer_short,
+    .src_len = 2,
+    .payload = (const uint8_t[]){ 0xff, 0xcf, 0x00, 0x00 },
+    .payload_len = 4,
+};
+
+// Send a frame and return whether the transceiver received it
+static bool peer_send(int node, const uint8_t *frame) {
+    ieee802154_transceiver_stats_t before, after;
+    ieee802154_transceiver_get_stats(&before, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    ieee802154_transceiver_get_stats(&after, false);
+    return after.rx_frames != before.rx_frames;
+}
+
+static esp_err_t init_filtered(esp_ieee802154_pending_mode_t pending_mode) {
+    ieee802154_transceiver_address_t address = {
+        .pan_id = PAN_ID,
+        .short_addr = SHORT_ADDR,
+        .pending_mode = pending_mode,
+    };
+    memcpy(address.ext_addr, ext_addr, sizeof(ext_addr));
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(RX_CHANNEL);
+    config.promiscuous = false;
+    config.address = &address;
+    return ieee802154_transceiver_init_with_config(&config);
+}
+
+//=========================================================================================
+// Tests
+
+static void test_promiscuous_receives_everything(void) {
+    ieee802154_sim_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rx_cb = peer_callback };
+    int node = ieee802154_sim_node_create(&node_config);
+    ack_count = 0;
+
+    // Foreign frames are received, nothing is acknowledged
+    uint8_t frame[32];
+    test_frame_t fields = peer_frame;
+    fields.pan_id = 0x4321;
+    fields.dest = other_short;
+    fields.seq = 1;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    TEST_ASSERT_EQUAL_UINT32(0, ack_count);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_address_filter(void) {
+    ieee802154_sim_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, init_filtered(ESP_IEEE802154_AUTO_PENDING_DISABLE));
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rx_cb = peer_callback };
+    int node = ieee802154_sim_node_create(&node_config);
+    ack_count = 0;
+
+    uint8_t frame[32];
+    test_frame_t fields;
+
+    // Unicast to the short address is received and acknowledged
+    fields = peer_frame;
+    fields.seq = 10;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    TEST_ASSERT_EQUAL_UINT32(1, ack_count);
+    TEST_ASSERT_EQUAL(10, ack_seq);
+    TEST_ASSERT_FALSE(ack_pending);
+
+    // To the extended address, or through the broadcast PAN
+    fields = peer_frame;
+    fields.dest = ext_addr;
+    fields.dest_len = 8;
+    fields.seq = 11;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    fields = peer_frame;
+    fields.ack_request = false;
+    fields.pan_id = 0xffff;
+    fields.seq = 12;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+
+    // Broadcasts are received but never acknowledged
+    fields = peer_frame;
+    fields.dest = broadcast_addr;
+    fields.seq = 13;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    TEST_ASSERT_EQUAL_UINT32(2, ack_count);
+    TEST_ASSERT_EQUAL(11, ack_seq);
+
+    // Other addresses, other PANs and their beacons never reach the receive ISR
+    fields = peer_frame;
+    fields.dest = other_short;
+    fields.seq = 14;
+    build_frame(frame, &fields);
+    TEST_ASSERT_FALSE(peer_send(node, frame));
+    fields = peer_frame;
+    fields.pan_id = 0x4321;
+    fields.seq = 15;
+    build_frame(frame, &fields);
+    TEST_ASSERT_FALSE(peer_send(node, frame));
+    fields = peer_beacon;
+    fields.pan_id = 0x4321;
+    fields.seq = 16;
+    build_frame(frame, &fields);
+    TEST_ASSERT_FALSE(peer_send(node, frame));
+    fields = peer_beacon;
+    fields.pan_id = PAN_ID;
+    fields.seq = 17;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+
+    ieee802154_sim_stats_t sim_stats;
+    ieee802154_sim_get_stats(&sim_stats);
+    TEST_ASSERT_EQUAL_UINT32(3, sim_stats.filtered);
+    TEST_ASSERT_EQUAL_UINT32(2, sim_stats.acked);
+
+    // A new short address takes effect at once
+    ieee802154_transceiver_address_t address = { .pan_id = PAN_ID, .short_addr = 0x0002 };
+    memcpy(address.ext_addr, ext_addr, sizeof(ext_addr));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_set_address(NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_address(&address));
+    fields = peer_frame;
+    fields.dest = other_short;
+    fields.seq = 18;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    fields = peer_frame;
+    fields.seq = 19;
+    build_frame(frame, &fields);
+    TEST_ASSERT_FALSE(peer_send(node, frame));
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_set_address(&address));
+}
+
+static void test_address_filter_pending(void) {
+    ieee802154_sim_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, init_filtered(ESP_IEEE802154_AUTO_PENDING_ENABLE));
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rx_cb = peer_callback };
+    int node = ieee802154_sim_node_create(&node_config);
+    ack_count = 0;
+
+    uint8_t frame[32];
+    test_frame_t fields;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_set_pending(peer_short, 4, true));
+
+    // A data request from a marked neighbor is acknowledged with frame pending, data frames are not
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_pending(peer_short, 2, true));
+    fields = peer_frame;
+    fields.type = 0x03;
+    fields.payload = data_request;
+    fields.seq = 20;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    TEST_ASSERT_EQUAL_UINT32(1, ack_count);
+    TEST_ASSERT_TRUE(ack_pending);
+    fields = peer_frame;
+    fields.seq = 21;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    TEST_ASSERT_EQUAL_UINT32(2, ack_count);
+    TEST_ASSERT_FALSE(ack_pending);
+
+    // Once cleared, the next poll finds nothing
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_pending(peer_short, 2, false));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_pending(peer_short, 2, false));
+    fields = peer_frame;
+    fields.type = 0x03;
+    fields.payload = data_request;
+    fields.seq = 22;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    TEST_ASSERT_EQUAL_UINT32(3, ack_count);
+    TEST_ASSERT_FALSE(ack_pending);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_pending(peer_short, 2, true));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_clear_pending());
+    fields = peer_frame;
+    fields.type = 0x03;
+    fields.payload = data_request;
+    fields.seq = 23;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(peer_send(node, frame));
+    vTaskDelay(pdMS_TO_TICKS(5));
+    TEST_ASSERT_EQUAL_UINT32(4, ack_count);
+    TEST_ASSERT_FALSE(ack_pending);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+void run_address_filter_tests(void) {
+    RUN_TEST(test_promiscuous_receives_everything);
+    RUN_TEST(test_address_filter);
+    RUN_TEST(test_address_filter_pending);
+}
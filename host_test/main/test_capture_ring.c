@@ -0,0 +1,202 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "capture_ring.h"
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_capture.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 11
+#define RING_IMAGE_LEN 1024
+
+static uint64_t ring_image[RING_IMAGE_LEN / sizeof(uint64_t)];
+
+//=========================================================================================
+// Codec
+
+static void test_capture_ring_empty(void) {
+    capture_ring_t *ring = (capture_ring_t *)ring_image;
+    TEST_ASSERT_FALSE(capture_ring_init(ring, sizeof(capture_ring_t) + CAPTURE_RING_RECORD_MAX - 1));
+    TEST_ASSERT_TRUE(capture_ring_init(ring, sizeof(ring_image)));
+    TEST_ASSERT_EQUAL_HEX32(CAPTURE_RING_MAGIC, ring->magic);
+    TEST_ASSERT_EQUAL(sizeof(ring_image), capture_ring_image_len(ring));
+
+    capture_ring_iter_t iter;
+    uint8_t frame[128];
+    esp_ieee802154_frame_info_t info;
+    capture_ring_iter_begin(ring, &iter);
+    TEST_ASSERT_FALSE(capture_ring_iter_next(ring, &iter, frame, &info));
+}
+
+static void test_capture_ring_keeps_newest(void) {
+    capture_ring_t *ring = (capture_ring_t *)ring_image;
+    TEST_ASSERT_TRUE(capture_ring_init(ring, sizeof(ring_image)));
+
+    // Far more than fits, with uneven lengths so records straddle the wrap point
+    uint8_t frame[128];
+    esp_ieee802154_frame_info_t info = { .channel = 20, .rssi = -70, .lqi = 90 };
+    uint32_t evicted = 0;
+    int64_t time_us = 5000000;
+    for (int i = 0; i < 300; i++) {
+        fill_frame(frame, 3 + (i * 37) % 125, (uint8_t)(i * 3));
+        info.rssi = (int8_t)(-i % 100);
+        time_us += 1 + (i % 7) * 150000; // Up to a 3-byte delta
+        evicted += capture_ring_append(ring, frame, &info, time_us);
+        TEST_ASSERT_TRUE(ring->used <= ring->capacity);
+        TEST_ASSERT_TRUE(ring->head_time_us == time_us);
+    }
+    TEST_ASSERT_GREATER_THAN(0, evicted);
+    TEST_ASSERT_EQUAL_UINT32(300, ring->records + evicted);
+
+    // What is left is the newest records, in order, with exact times
+    int first = 300 - (int)ring->records;
+    int64_t expected_us = 5000000;
+    for (int i = 0; i < first; i++) {
+        expected_us += 1 + (i % 7) * 150000;
+    }
+    capture_ring_iter_t iter;
+    capture_ring_iter_begin(ring, &iter);
+    uint8_t expected[128];
+    for (int i = first; i < 300; i++) {
+        expected_us += 1 + (i % 7) * 150000;
+        TEST_ASSERT_TRUE(capture_ring_iter_next(ring, &iter, frame, &info));
+        fill_frame(expected, 3 + (i * 37) % 125, (uint8_t)(i * 3));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame, expected[0] + 1);
+        TEST_ASSERT_EQUAL_UINT8(20, info.channel);
+        TEST_ASSERT_EQUAL_INT8((int8_t)(-i % 100), info.rssi);
+        TEST_ASSERT_EQUAL_UINT8(90, info.lqi);
+        TEST_ASSERT_TRUE(info.timestamp == (uint64_t)expected_us);
+    }
+    TEST_ASSERT_FALSE(capture_ring_iter_next(ring, &iter, frame, &info));
+    TEST_ASSERT_TRUE(ring->tail_time_us <= ring->head_time_us);
+}
+
+static void test_capture_ring_record_size(void) {
+    capture_ring_t *ring = (capture_ring_t *)ring_image;
+    TEST_ASSERT_TRUE(capture_ring_init(ring, sizeof(ring_image)));
+
+    // A 10-byte frame 1 ms after the previous one costs 2 + 2 + 3 + 10 bytes
+    uint8_t frame[128];
+    esp_ieee802154_frame_info_t info = { .channel = 15 };
+    fill_frame(frame, 10, 0);
+    capture_ring_append(ring, frame, &info, 1000);
+    TEST_ASSERT_EQUAL_UINT32(1 + 1 + CAPTURE_RING_META_LEN + 10, ring->used);
+    capture_ring_append(ring, frame, &info, 2000);
+    TEST_ASSERT_EQUAL_UINT32(2 * (1 + CAPTURE_RING_META_LEN + 10) + 1 + 2, ring->used);
+
+    // Time going backwards is recorded as no time at all
+    capture_ring_append(ring, frame, &info, 1500);
+    TEST_ASSERT_TRUE(ring->head_time_us == 2000);
+}
+
+//=========================================================================================
+// Trigger and freeze over the simulated radio
+
+static volatile uint32_t raw_rx_count;
+
+static void count_raw_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    raw_rx_count++;
+}
+
+static void send_frames(int node, int count, uint8_t first_seq) {
+    uint8_t frame[128];
+    uint32_t expected = raw_rx_count + count;
+    for (int i = 0; i < count; i++) {
+        fill_frame(frame, 20, (uint8_t)((first_seq + i) * 3));
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(node, frame));
+        vTaskDelay(1);
+    }
+    wait_for(&raw_rx_count, expected);
+    TEST_ASSERT_EQUAL_UINT32(expected, raw_rx_count);
+}
+
+static void test_capture_trigger_and_freeze(void) {
+    ieee802154_sim_reset();
+    raw_rx_count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_transceiver_set_rx_raw_callback(count_raw_callback, NULL);
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rssi = -55, .lqi = 200 };
+    int sender = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_THAN(0, sender);
+
+    const uint8_t *image;
+    size_t image_len;
+    ieee802154_transceiver_capture_config_t config = { .size = 4096, .post_trigger_ms = 50 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_capture_trigger());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_start(&config));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_capture_start(&config));
+
+    send_frames(sender, 20, 0);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_capture_get_image(&image, &image_len));
+
+    // Frames keep coming in for the post-trigger time, then the ring freezes
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_trigger());
+    send_frames(sender, 5, 20);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    ieee802154_transceiver_capture_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_get_stats(&stats, false));
+    TEST_ASSERT_TRUE(stats.triggered);
+    TEST_ASSERT_TRUE(stats.frozen);
+    send_frames(sender, 10, 25);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_get_stats(&stats, false));
+    TEST_ASSERT_EQUAL_UINT32(25, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.ignored);
+    TEST_ASSERT_EQUAL_UINT32(25, stats.records);
+
+    // The image decodes on its own, with the trigger inside the recorded span
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_get_image(&image, &image_len));
+    TEST_ASSERT_EQUAL(4096, image_len);
+    static uint64_t copy[4096 / sizeof(uint64_t)];
+    memcpy(copy, image, image_len);
+    capture_ring_t *ring = (capture_ring_t *)copy;
+    TEST_ASSERT_EQUAL_HEX32(CAPTURE_RING_MAGIC, ring->magic);
+    TEST_ASSERT_EQUAL_HEX32(CAPTURE_RING_FLAG_TRIGGERED | CAPTURE_RING_FLAG_FROZEN, ring->flags);
+    TEST_ASSERT_TRUE(ring->trigger_time_us > ring->tail_time_us);
+    TEST_ASSERT_TRUE(ring->trigger_time_us < ring->head_time_us);
+
+    capture_ring_iter_t iter;
+    uint8_t frame[128];
+    uint8_t expected[128];
+    esp_ieee802154_frame_info_t info;
+    uint64_t last_us = 0;
+    capture_ring_iter_begin(ring, &iter);
+    for (int i = 0; i < 25; i++) {
+        TEST_ASSERT_TRUE(capture_ring_iter_next(ring, &iter, frame, &info));
+        fill_frame(expected, 20, (uint8_t)(i * 3));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame, 21);
+        TEST_ASSERT_EQUAL_UINT8(RX_CHANNEL, info.channel);
+        TEST_ASSERT_EQUAL_INT8(-55, info.rssi);
+        TEST_ASSERT_EQUAL_UINT8(200, info.lqi);
+        TEST_ASSERT_TRUE(info.timestamp > last_us);
+        last_us = info.timestamp;
+    }
+    TEST_ASSERT_FALSE(capture_ring_iter_next(ring, &iter, frame, &info));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, ieee802154_transceiver_capture_save());
+
+    // Resumed, it records again and can be triggered again
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_resume());
+    send_frames(sender, 5, 35);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_get_stats(&stats, true));
+    TEST_ASSERT_FALSE(stats.frozen);
+    TEST_ASSERT_EQUAL_UINT32(30, stats.frames);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_freeze());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_get_image(&image, &image_len));
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_capture_stop());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_capture_stop());
+    ieee802154_transceiver_set_rx_raw_callback(NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+void run_capture_ring_tests(void) {
+    RUN_TEST(test_capture_ring_empty);
+    RUN_TEST(test_capture_ring_keeps_newest);
+    RUN_TEST(test_capture_ring_record_size);
+    RUN_TEST(test_capture_trigger_and_freeze);
+}
@@ -0,0 +1,184 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "dedupe_cache.h"
+#include "ieee802154_transceiver.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 11
+#define EXPIRY_US 100000
+
+// Broadcast data frame from a short source; the extended source keeps the same low bytes
+static const uint8_t sender_addr[8] = { 0x01, 0x00 };
+static const test_frame_t broadcast_frame = {
+    .type = 1,
+    .seq = 7,
+    .pan_id = TEST_PAN_ID,
+    .dest = broadcast_addr,
+    .dest_len = 2,
+    .src = sender_addr,
+    .src_len = 2,
+    .payload = (const uint8_t[]){ 0xee },
+    .payload_len = 1,
+};
+
+static bool frame_key(const uint8_t *frame, dedupe_key_t *key) {
+    ieee802154_transceiver_header_t header;
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_decode(frame, &header));
+    return dedupe_cache_key(&header, key);
+}
+
+//=========================================================================================
+// Cache
+
+static void test_dedupe_cache_key(void) {
+    uint8_t frame[128];
+    dedupe_key_t a, b;
+
+    // Sequence number, source address and length, PAN and frame type all tell frames apart
+    test_frame_t fields = broadcast_frame;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(frame_key(frame, &a));
+    TEST_ASSERT_EQUAL_HEX16(TEST_PAN_ID, a.pan_id);
+    fields.seq = 8;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(frame_key(frame, &b));
+    TEST_ASSERT_FALSE(dedupe_key_equal(&a, &b));
+    fields = broadcast_frame;
+    fields.src_len = 8;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(frame_key(frame, &b));
+    TEST_ASSERT_FALSE(dedupe_key_equal(&a, &b));
+    fields = broadcast_frame;
+    fields.pan_id = 0x4321;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(frame_key(frame, &b));
+    TEST_ASSERT_FALSE(dedupe_key_equal(&a, &b));
+    fields = broadcast_frame;
+    fields.type = 0; // Beacons number separately
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(frame_key(frame, &b));
+    TEST_ASSERT_FALSE(dedupe_key_equal(&a, &b));
+    build_frame(frame, &broadcast_frame);
+    TEST_ASSERT_TRUE(frame_key(frame, &b));
+    TEST_ASSERT_TRUE(dedupe_key_equal(&a, &b));
+
+    // An acknowledgment has no source address
+    const uint8_t ack[] = { 5, 0x02, 0x00, 7, 0, 0 };
+    TEST_ASSERT_FALSE(frame_key(ack, &a));
+}
+
+static void test_dedupe_cache_expiry(void) {
+    dedupe_entry_t entries[8];
+    dedupe_cache_t cache;
+    dedupe_cache_init(&cache, entries, 8);
+    dedupe_key_t key = { .addr = 0x0001, .pan_id = 0x1234, .seq = 1, .kind = 1 | 2 << 3 };
+
+    // A frame is remembered from its first copy until the expiry
+    TEST_ASSERT_FALSE(dedupe_cache_check(&cache, &key, 1000, EXPIRY_US));
+    TEST_ASSERT_TRUE(dedupe_cache_check(&cache, &key, 2000, EXPIRY_US));
+    TEST_ASSERT_TRUE(dedupe_cache_check(&cache, &key, 1000 + EXPIRY_US - 1, EXPIRY_US));
+    TEST_ASSERT_FALSE(dedupe_cache_check(&cache, &key, 1000 + EXPIRY_US, EXPIRY_US));
+    TEST_ASSERT_TRUE(dedupe_cache_check(&cache, &key, 1000 + EXPIRY_US + 1, EXPIRY_US));
+}
+
+static void test_dedupe_cache_full(void) {
+    dedupe_entry_t entries[16];
+    dedupe_cache_t cache;
+    dedupe_cache_init(&cache, entries, 16);
+
+    // 256 distinct frames in quick succession: all new, and the most recent ones still remembered
+    dedupe_key_t key = { .addr = 0x0001, .pan_id = 0x1234, .kind = 1 | 2 << 3 };
+    for (int i = 0; i < 256; i++) {
+        key.seq = i;
+        TEST_ASSERT_FALSE(dedupe_cache_check(&cache, &key, 1000 + i, EXPIRY_US));
+    }
+    key.seq = 255;
+    TEST_ASSERT_TRUE(dedupe_cache_check(&cache, &key, 2000, EXPIRY_US));
+
+    // Every entry is in use, each found from its key's home entry
+    int remembered = 0;
+    for (int i = 0; i < 256; i++) {
+        key.seq = i;
+        int64_t seen_us = 0;
+        uint32_t home = dedupe_cache_home(&cache, &key);
+        for (int probe = 0; probe < DEDUPE_CACHE_PROBES; probe++) {
+            dedupe_entry_t *entry = &entries[(home + probe) % 16];
+            if (dedupe_key_equal(&entry->key, &key)) {
+                seen_us = entry->time_us;
+            }
+        }
+        remembered += seen_us != 0;
+    }
+    TEST_ASSERT_EQUAL(16, remembered);
+}
+
+//=========================================================================================
+// Suppression over the simulated radio
+
+static volatile uint32_t rx_count;
+
+static void count_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    rx_count++;
+}
+
+static void test_dedupe_receive(void) {
+    ieee802154_sim_reset();
+    rx_count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_transceiver_get_stats(&(ieee802154_transceiver_stats_t){0}, true);
+    ieee802154_transceiver_set_rx_raw_callback(count_callback, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_dedupe(1000));
+
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rssi = -50, .lqi = 220 };
+    int sender = ieee802154_sim_node_create(&node_config);
+    int relay = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_THAN(0, sender);
+    TEST_ASSERT_GREATER_THAN(0, relay);
+
+    // 20 frames, each retransmitted once and echoed by a relay; acknowledgments always pass
+    uint8_t frame[128];
+    const uint8_t ack[] = { 5, 0x02, 0x00, 7, 0, 0 };
+    test_frame_t fields = broadcast_frame;
+    for (int i = 0; i < 20; i++) {
+        fields.seq = (uint8_t)i;
+        build_frame(frame, &fields);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(relay, frame));
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, ack));
+        vTaskDelay(1);
+    }
+    wait_for(&rx_count, 40);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    TEST_ASSERT_EQUAL_UINT32(40, rx_count);
+
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(80, stats.rx_queued);
+    TEST_ASSERT_EQUAL_UINT32(40, stats.rx_dropped_duplicate);
+
+    // Disabled, every copy is delivered
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_dedupe(0));
+    fields.seq = 0;
+    build_frame(frame, &fields);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+    wait_for(&rx_count, 42);
+    TEST_ASSERT_EQUAL_UINT32(42, rx_count);
+
+    ieee802154_transceiver_set_rx_raw_callback(NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+void run_dedupe_cache_tests(void) {
+    RUN_TEST(test_dedupe_cache_key);
+    RUN_TEST(test_dedupe_cache_expiry);
+    RUN_TEST(test_dedupe_cache_full);
+    RUN_TEST(test_dedupe_receive);
+}
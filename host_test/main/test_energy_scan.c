@@ -0,0 +1,183 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_scan.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 15
+#define BUSY_CHANNEL 13
+// Energy survey run from another task
+static volatile bool scan_running;
+
+static void scan_task(void *arg) {
+    ieee802154_transceiver_scan_config_t config = { .listen_ms = 5 };
+    ieee802154_transceiver_scan_result_t result;
+    ieee802154_transceiver_scan_energy(&config, &result);
+    scan_running = false;
+    vTaskDelete(NULL);
+}
+
+// Peer node sending one frame per tick until told to stop
+static volatile bool sender_running;
+static TaskHandle_t sender_waiter;
+
+static void sender_task(void *arg) {
+    int node = (int)(intptr_t)arg;
+    uint8_t frame[16];
+    for (uint8_t seq = 0; sender_running; seq++) {
+        make_data_frame(frame, seq, 0xffff, 0x0001, 0);
+        ieee802154_sim_node_transmit(node, frame);
+        vTaskDelay(1);
+    }
+    xTaskNotifyGive(sender_waiter);
+    vTaskDelete(NULL);
+}
+
+//=========================================================================================
+// Tests
+
+static void test_scan_ranks_channels(void) {
+    ieee802154_transceiver_scan_result_t result;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_scan_energy(NULL, &result));
+
+    ieee802154_sim_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+
+    ieee802154_transceiver_scan_config_t config = { .channel_mask = 1 << 10 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_scan_energy(&config, &result));
+    config.channel_mask = 0;
+    config.samples = 64;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_scan_energy(&config, &result));
+
+    // Wi-Fi-like noise over the lower channels, one channel quieter than the floor
+    for (uint8_t channel = 11; channel <= 14; channel++) {
+        ieee802154_sim_set_noise(channel, -60 - channel);
+    }
+    ieee802154_sim_set_noise(20, -105);
+
+    // The whole band with the defaults is surveyed in tens of milliseconds
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_scan_energy(NULL, &result));
+    TEST_ASSERT_EQUAL_HEX32(0x07FFF800, result.channel_mask);
+    TEST_ASSERT_TRUE(result.duration_us < 50000);
+    TEST_ASSERT_EQUAL(4, result.channels[0].samples);
+    TEST_ASSERT_EQUAL(-71, result.channels[0].energy_mean);
+    TEST_ASSERT_EQUAL(-71, result.channels[0].energy_max);
+    TEST_ASSERT_EQUAL(-105, result.channels[20 - 11].energy_mean);
+    TEST_ASSERT_EQUAL(-100, result.channels[26 - 11].energy_max);
+
+    // Quietest first, ties by channel number, the noisiest last
+    uint8_t ranked[16];
+    size_t count;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_scan_rank(&result, ranked, 16, &count));
+    TEST_ASSERT_EQUAL(16, count);
+    TEST_ASSERT_EQUAL(20, ranked[0]);
+    TEST_ASSERT_EQUAL(15, ranked[1]);
+    TEST_ASSERT_EQUAL(14, ranked[12]);
+    TEST_ASSERT_EQUAL(11, ranked[15]);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_scan_rank(&result, ranked, 1, &count));
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(20, ranked[0]);
+
+    // A partial survey ranks only its channels
+    config = (ieee802154_transceiver_scan_config_t){ .channel_mask = (1 << 11) | (1 << 12), .samples = 2 };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_scan_energy(&config, &result));
+    TEST_ASSERT_EQUAL(2, result.channels[0].samples);
+    TEST_ASSERT_EQUAL(0, result.channels[2].samples);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_scan_rank(&result, ranked, 16, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(12, ranked[0]);
+
+    // Back on the receive channel, listening
+    TEST_ASSERT_EQUAL(RX_CHANNEL, esp_ieee802154_get_channel());
+    TEST_ASSERT_EQUAL(ESP_IEEE802154_RADIO_RECEIVE, esp_ieee802154_get_state());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_scan_counts_frames(void) {
+    ieee802154_sim_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, true);
+
+    ieee802154_sim_node_config_t node_config = { .channel = BUSY_CHANNEL, .rssi = -40, .lqi = 220 };
+    int node = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, node);
+    sender_running = true;
+    sender_waiter = xTaskGetCurrentTaskHandle();
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(sender_task, "SENDER", 4096, (void *)(intptr_t)node, 5, NULL));
+
+    // Frames heard while listening are counted on their channel and received as usual
+    ieee802154_transceiver_scan_config_t config = {
+        .channel_mask = (1 << 12) | (1 << BUSY_CHANNEL) | (1 << 14),
+        .listen_ms = 20,
+    };
+    ieee802154_transceiver_scan_result_t result;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_scan_energy(&config, &result));
+    sender_running = false;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAIT_TIMEOUT_MS));
+
+    TEST_ASSERT_EQUAL_UINT32(0, result.channels[12 - 11].frames);
+    TEST_ASSERT_GREATER_THAN_UINT32(5, result.channels[BUSY_CHANNEL - 11].frames);
+    TEST_ASSERT_EQUAL_UINT32(0, result.channels[14 - 11].frames);
+    TEST_ASSERT_TRUE(result.duration_us >= 60000);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(result.channels[BUSY_CHANNEL - 11].frames, stats.rx_frames);
+
+    TEST_ASSERT_EQUAL(RX_CHANNEL, esp_ieee802154_get_channel());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_scan_holds_transmit(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(RX_CHANNEL);
+    config.tx_sync_wait = true;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init_with_config(&config));
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rx_cb = count_peer_callback };
+    TEST_ASSERT_GREATER_OR_EQUAL(1, ieee802154_sim_node_create(&node_config));
+    reset_traffic_counters();
+
+    // Frames queued around a survey all go out on the receive channel
+    uint8_t frame[16];
+    for (uint8_t i = 0; i < 4; i++) {
+        make_data_frame(frame, i, 0xffff, 0x0001, 0);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_transmit_raw_async(frame, 0, count_tx_done, (void *)RX_CHANNEL));
+    }
+    ieee802154_transceiver_scan_result_t result;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_scan_energy(NULL, &result));
+    for (uint8_t i = 4; i < 8; i++) {
+        make_data_frame(frame, i, 0xffff, 0x0001, 0);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_transmit_raw_async(frame, 0, count_tx_done, (void *)RX_CHANNEL));
+    }
+
+    wait_for(&tx_done_count, 8);
+    TEST_ASSERT_EQUAL_UINT32(8, tx_done_count);
+    TEST_ASSERT_EQUAL_UINT32(0, tx_done_errors);
+    TEST_ASSERT_EQUAL_UINT32(8, peer_rx_count);
+
+    // Synchronous transmissions wait for a survey as well, instead of going out on the channel it measures,
+    // and keep the radio from it until they are out
+    scan_running = true;
+    uint32_t sent = 0;
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(scan_task, "scan", 4096, NULL, uxTaskPriorityGet(NULL) + 1, NULL));
+    while (scan_running) {
+        make_data_frame(frame, 8 + sent, 0xffff, 0x0001, 0);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_transmit_raw(frame, 0));
+        sent++;
+        vTaskDelay(1);
+    }
+    wait_for(&peer_rx_count, 8 + sent);
+    TEST_ASSERT_GREATER_THAN_UINT32(1, sent);
+    TEST_ASSERT_EQUAL_UINT32(8 + sent, peer_rx_count);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+void run_energy_scan_tests(void) {
+    RUN_TEST(test_scan_ranks_channels);
+    RUN_TEST(test_scan_counts_frames);
+    RUN_TEST(test_scan_holds_transmit);
+}
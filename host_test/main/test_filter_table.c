@@ -0,0 +1,185 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 11
+#define FOREIGN_PAN 0x4321
+#define MIN_RSSI -70
+
+static const uint8_t sender_addr[2] = { 0x01, 0x00 };
+
+// Broadcast data frame on TEST_PAN_ID
+static const test_frame_t data_frame = {
+    .type = 1,
+    .pan_id = TEST_PAN_ID,
+    .dest = broadcast_addr,
+    .dest_len = 2,
+    .src = sender_addr,
+    .src_len = 2,
+    .payload_len = 4,
+};
+
+static volatile uint32_t rx_count;
+static uint8_t next_seq;
+
+static void count_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    rx_count++;
+}
+
+// Send count frames built from fields, each with its own sequence number so that none is a duplicate
+static void send_frames(int node, test_frame_t fields, int count) {
+    uint8_t frame[128];
+    for (int i = 0; i < count; i++) {
+        fields.seq = next_seq++;
+        build_frame(frame, &fields);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(node, frame));
+        vTaskDelay(1);
+    }
+}
+
+// Wait until the radio has delivered frames in all, then give the receive task time to finish
+static void settle(uint32_t frames) {
+    ieee802154_transceiver_stats_t stats;
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(WAIT_TIMEOUT_MS);
+    do {
+        vTaskDelay(1);
+        ieee802154_transceiver_get_stats(&stats, false);
+    } while (stats.rx_frames < frames && xTaskGetTickCount() < deadline);
+    vTaskDelay(pdMS_TO_TICKS(10));
+}
+
+static int start(int8_t weak_rssi, int *weak) {
+    ieee802154_sim_reset();
+    rx_count = 0;
+    next_seq = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_transceiver_get_stats(&(ieee802154_transceiver_stats_t){0}, true);
+    ieee802154_transceiver_set_rx_raw_callback(count_callback, NULL);
+
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rssi = -50, .lqi = 220 };
+    int strong = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_THAN(0, strong);
+    node_config.rssi = weak_rssi;
+    node_config.lqi = 60;
+    *weak = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_THAN(0, *weak);
+    return strong;
+}
+
+static void stop(void) {
+    ieee802154_transceiver_set_rx_raw_callback(NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_clear_filters());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+//=========================================================================================
+// Filtering over the simulated radio
+
+static void test_filter_table_pan(void) {
+    int weak;
+    int strong = start(-85, &weak);
+
+    ieee802154_transceiver_filter_t filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_DEST_PAN,
+        .dest_pan_id = TEST_PAN_ID,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_add_filter(&filter));
+
+    // Frames to other PANs are released in the ISR and never reach the callback
+    test_frame_t foreign = data_frame;
+    foreign.pan_id = FOREIGN_PAN;
+    send_frames(strong, data_frame, 5);
+    send_frames(strong, foreign, 7);
+    settle(12);
+
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(12, stats.rx_frames);
+    TEST_ASSERT_EQUAL_UINT32(7, stats.rx_dropped_filtered);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.rx_queued);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.rx_callbacks);
+    TEST_ASSERT_EQUAL_UINT32(5, rx_count);
+
+    // With the table cleared everything is accepted again
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_clear_filters());
+    send_frames(strong, foreign, 3);
+    settle(15);
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(7, stats.rx_dropped_filtered);
+    TEST_ASSERT_EQUAL_UINT32(8, rx_count);
+
+    stop();
+}
+
+static void test_filter_table_type_and_rssi(void) {
+    int weak;
+    int strong = start(-85, &weak);
+
+    // Data frames heard at MIN_RSSI or better
+    ieee802154_transceiver_filter_t filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE | IEEE802154_TRANSCEIVER_FILTER_MIN_RSSI,
+        .frame_types = 1 << 1,
+        .min_rssi = MIN_RSSI,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_add_filter(&filter));
+
+    test_frame_t command = data_frame;
+    command.type = 3;
+    command.payload = (const uint8_t[]){ 0x04 }; // Data request
+    command.payload_len = 1;
+    send_frames(strong, data_frame, 4);
+    send_frames(strong, command, 3);
+    send_frames(weak, data_frame, 5);
+    settle(12);
+
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(8, stats.rx_dropped_filtered);
+    TEST_ASSERT_EQUAL_UINT32(4, rx_count);
+
+    // A frame is accepted when it matches any entry
+    ieee802154_transceiver_filter_t commands = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE,
+        .frame_types = 1 << 3,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_add_filter(&commands));
+    send_frames(strong, command, 3);
+    send_frames(weak, command, 2);
+    send_frames(weak, data_frame, 2);
+    settle(19);
+
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.rx_dropped_filtered);
+    TEST_ASSERT_EQUAL_UINT32(9, stats.rx_callbacks);
+    TEST_ASSERT_EQUAL_UINT32(9, rx_count);
+
+    stop();
+}
+
+static void test_filter_table_full(void) {
+    ieee802154_transceiver_filter_t filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_DEST_PAN,
+        .dest_pan_id = TEST_PAN_ID,
+    };
+    for (int i = 0; i < CONFIG_IEEE802154_TRANSCEIVER_FILTER_MAX; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_add_filter(&filter));
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, ieee802154_transceiver_add_filter(&filter));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_add_filter(NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_clear_filters());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_add_filter(&filter));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_clear_filters());
+}
+
+void run_filter_table_tests(void) {
+    RUN_TEST(test_filter_table_pan);
+    RUN_TEST(test_filter_table_type_and_rssi);
+    RUN_TEST(test_filter_table_full);
+}
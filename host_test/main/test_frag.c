@@ -0,0 +1,407 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_frag.h"
+#include "ieee802154_sim.h"
+#include "reassembly.h"
+#include "host_test.h"
+
+#define TX_CHANNEL 21
+#define DATAGRAM_LEN 3000
+#define PEER_CHUNK 96
+
+static uint8_t pool_storage[4096] __attribute__((aligned(8)));
+
+static uint8_t pattern(size_t i) {
+    return (uint8_t)(i * 7 + (i >> 8));
+}
+
+static reassembly_pool_t make_pool(uint16_t slots, uint16_t max_size) {
+    TEST_ASSERT_TRUE(reassembly_storage_size(slots, max_size) <= sizeof(pool_storage));
+    reassembly_pool_t pool;
+    reassembly_init(&pool, pool_storage, slots, max_size, 1000);
+    return pool;
+}
+
+static reassembly_status_t add(reassembly_pool_t *pool, uint16_t tag, uint16_t size, uint16_t index, int64_t now_us,
+                               reassembly_slot_t **slot) {
+    static const uint8_t addr[2] = { 0x01, 0x00 };
+    uint8_t data[8];
+    size_t offset = (size_t)index * 8;
+    size_t len = offset < size && size - offset < 8 ? size - offset : 8;
+    for (size_t i = 0; i < len; i++) {
+        data[i] = pattern(offset + i);
+    }
+    reassembly_key_t key = reassembly_key(addr, sizeof(addr), TEST_PAN_ID, tag);
+    reassembly_fragment_t fragment = { .tag = tag, .size = size, .index = index, .chunk = 8 };
+    return reassembly_add(pool, &key, &fragment, data, len, now_us, slot);
+}
+
+// Fragments received by the peer node, placed by index
+static uint8_t peer_data[DATAGRAM_LEN];
+static volatile uint32_t peer_fragments;
+static uint8_t peer_last_seq;
+static bool peer_in_order;
+
+static void peer_rx(int node, const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *ctx) {
+    ieee802154_transceiver_header_t header;
+    if (!ieee802154_transceiver_header_decode(frame, &header)) {
+        return;
+    }
+    const uint8_t *p = &frame[header.payload_offset];
+    size_t len = frame[0] - 1 - header.payload_offset - IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN;
+    if (p[0] != IEEE802154_TRANSCEIVER_FRAG_DISPATCH) {
+        return;
+    }
+    uint16_t index = p[6] | (p[7] << 8);
+    if (peer_fragments > 0 && frame[3] != (uint8_t)(peer_last_seq + 1)) {
+        peer_in_order = false;
+    }
+    peer_last_seq = frame[3];
+    memcpy(&peer_data[index * p[1]], &p[IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN], len);
+    peer_fragments++;
+}
+
+// Datagrams delivered by the reassembly
+static uint8_t rx_data[DATAGRAM_LEN];
+static size_t rx_len;
+static ieee802154_transceiver_frag_source_t rx_source;
+static TaskHandle_t rx_waiter;
+
+static void frag_rx(const uint8_t *data, size_t len, const ieee802154_transceiver_frag_source_t *source, void *ctx) {
+    memcpy(rx_data, data, len);
+    rx_len = len;
+    rx_source = *source;
+    (*(uint32_t *)ctx)++;
+    xTaskNotifyGive(rx_waiter);
+}
+
+// Fragment from the peer's short address 0x0001, PAN ID compressed, to 0xffff
+static void peer_send_fragment(int node, uint16_t tag, uint16_t size, uint16_t index, uint8_t seq) {
+    uint8_t frame[128];
+    size_t offset = (size_t)index * PEER_CHUNK;
+    size_t len = size - offset < PEER_CHUNK ? size - offset : PEER_CHUNK;
+    uint8_t *p = &frame[make_data_frame(frame, seq, 0xffff, 0x0001, IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN + len)];
+    p[0] = IEEE802154_TRANSCEIVER_FRAG_DISPATCH;
+    p[1] = PEER_CHUNK;
+    p[2] = tag & 0xff;
+    p[3] = tag >> 8;
+    p[4] = size & 0xff;
+    p[5] = size >> 8;
+    p[6] = index & 0xff;
+    p[7] = index >> 8;
+    for (size_t i = 0; i < len; i++) {
+        p[IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN + i] = pattern(offset + i);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(node, frame));
+}
+
+static ieee802154_frame_t make_header(void) {
+    ieee802154_frame_t frame = {
+        .fcf = {
+            .frameType = IEEE802154_FRAME_TYPE_DATA,
+            .panIdCompression = 1,
+            .destAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .srcAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .frameVersion = IEEE802154_VERSION_2006,
+        },
+        .sequenceNumber = 250,
+        .destPanId = TEST_PAN_ID,
+        .destAddress = { 0x01, 0x00 },
+        .destAddrLen = 2,
+        .srcPanId = TEST_PAN_ID,
+        .srcAddress = { 0x02, 0x00 },
+        .srcAddrLen = 2,
+    };
+    return frame;
+}
+
+// The peer sends back-to-back, faster than the air would carry its frames: leave room for all of them
+static esp_err_t init_receiver(void) {
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(TX_CHANNEL);
+    config.rx_queue_depth = 64;
+    return ieee802154_transceiver_init_with_config(&config);
+}
+
+//=========================================================================================
+// Tests
+
+static void test_reassembly_out_of_order(void) {
+    reassembly_pool_t pool = make_pool(2, 64);
+    reassembly_slot_t *slot = NULL;
+
+    // 30 bytes in four fragments, the last one 6 bytes long, in any order and with repeats
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 1, 30, 3, 0, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 1, 30, 1, 0, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_DUPLICATE, add(&pool, 1, 30, 1, 0, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 1, 30, 0, 0, &slot));
+    TEST_ASSERT_NULL(slot);
+    TEST_ASSERT_EQUAL(REASSEMBLY_COMPLETE, add(&pool, 1, 30, 2, 0, &slot));
+    TEST_ASSERT_NOT_NULL(slot);
+    TEST_ASSERT_EQUAL(30, slot->size);
+    TEST_ASSERT_EQUAL(4, slot->fragments);
+    for (size_t i = 0; i < 30; i++) {
+        TEST_ASSERT_EQUAL_HEX8(pattern(i), slot->data[i]);
+    }
+    reassembly_release(&pool, slot);
+
+    // The released slot takes the same tag as a new datagram
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 1, 30, 0, 0, &slot));
+}
+
+static void test_reassembly_rejects(void) {
+    reassembly_pool_t pool = make_pool(2, 64);
+    reassembly_slot_t *slot = NULL;
+    static const uint8_t addr[2] = { 0x01, 0x00 };
+    reassembly_key_t key = reassembly_key(addr, sizeof(addr), TEST_PAN_ID, 9);
+    uint8_t data[8] = { 0 };
+
+    reassembly_fragment_t fragment = { .tag = 9, .size = 30, .index = 4, .chunk = 8 };
+    TEST_ASSERT_EQUAL(REASSEMBLY_INVALID, reassembly_add(&pool, &key, &fragment, data, 8, 0, &slot));
+    fragment.index = 0;
+    TEST_ASSERT_EQUAL(REASSEMBLY_INVALID, reassembly_add(&pool, &key, &fragment, data, 7, 0, &slot));
+    fragment.index = 3;
+    TEST_ASSERT_EQUAL(REASSEMBLY_INVALID, reassembly_add(&pool, &key, &fragment, data, 8, 0, &slot));
+    fragment = (reassembly_fragment_t){ .tag = 9, .size = 30, .index = 0, .chunk = 4 };
+    TEST_ASSERT_EQUAL(REASSEMBLY_INVALID, reassembly_add(&pool, &key, &fragment, data, 4, 0, &slot));
+    fragment = (reassembly_fragment_t){ .tag = 9, .size = 0, .index = 0, .chunk = 8 };
+    TEST_ASSERT_EQUAL(REASSEMBLY_INVALID, reassembly_add(&pool, &key, &fragment, data, 0, 0, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_TOO_LARGE, add(&pool, 9, 65, 0, 0, &slot));
+
+    // A fragment disagreeing with the datagram in progress is refused
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 9, 30, 0, 0, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_INVALID, add(&pool, 9, 40, 1, 0, &slot));
+
+    // Keys differ by tag, address and, for short addresses only, PAN
+    static const uint8_t ext[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    reassembly_key_t a = reassembly_key(ext, sizeof(ext), 0x1111, 1);
+    reassembly_key_t b = reassembly_key(ext, sizeof(ext), 0x2222, 1);
+    TEST_ASSERT_TRUE(reassembly_key_equal(&a, &b));
+    a = reassembly_key(addr, sizeof(addr), 0x1111, 1);
+    b = reassembly_key(addr, sizeof(addr), 0x2222, 1);
+    TEST_ASSERT_FALSE(reassembly_key_equal(&a, &b));
+}
+
+static void test_reassembly_slots_and_expiry(void) {
+    reassembly_pool_t pool = make_pool(2, 64);
+    reassembly_slot_t *slot = NULL;
+
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 1, 30, 0, 0, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 2, 30, 0, 500, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_NO_SLOT, add(&pool, 3, 30, 0, 600, &slot));
+
+    // Each fragment restarts its datagram's timeout
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 1, 30, 1, 900, &slot));
+    TEST_ASSERT_EQUAL(0, reassembly_expire(&pool, 1400));
+    TEST_ASSERT_EQUAL(1, reassembly_expire(&pool, 1600));
+    TEST_ASSERT_EQUAL(REASSEMBLY_ADDED, add(&pool, 3, 30, 0, 1600, &slot));
+    TEST_ASSERT_EQUAL(REASSEMBLY_NO_SLOT, add(&pool, 2, 30, 1, 1600, &slot));
+    TEST_ASSERT_EQUAL(2, reassembly_expire(&pool, 5000));
+}
+
+static void test_frag_send(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_frag_stats_t stats;
+    ieee802154_transceiver_frag_get_stats(&stats, true);
+
+    // Arguments are checked before the radio is needed
+    static uint8_t datagram[DATAGRAM_LEN];
+    for (size_t i = 0; i < sizeof(datagram); i++) {
+        datagram[i] = pattern(i);
+    }
+    ieee802154_frame_t header = make_header();
+    ieee802154_transceiver_frag_iov_t iov[3] = {
+        { datagram, 1000 },
+        { &datagram[1000], 1 },
+        { &datagram[1001], DATAGRAM_LEN - 1001 },
+    };
+    ieee802154_transceiver_frag_iov_t empty = { NULL, 0 };
+    ieee802154_transceiver_frag_iov_t huge = { datagram, 65536 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_frag_send(NULL, iov, 3, 0, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_frag_send(&header, NULL, 3, 0, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_frag_send(&header, iov, 3, 27, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, ieee802154_transceiver_frag_send(&header, &empty, 1, 0, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, ieee802154_transceiver_frag_send(&header, &huge, 1, 0, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_frag_send(&header, iov, 3, 0, NULL));
+
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(TX_CHANNEL);
+    config.tx_queue_depth = 4;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init_with_config(&config));
+    ieee802154_sim_node_config_t node_config = { .channel = TX_CHANNEL, .rx_cb = peer_rx, .ack = true };
+    TEST_ASSERT_GREATER_OR_EQUAL(1, ieee802154_sim_node_create(&node_config));
+    memset(peer_data, 0, sizeof(peer_data));
+    peer_fragments = 0;
+    peer_in_order = true;
+
+    // Three pieces go out as one stream of fragments, through a queue much shorter than the datagram
+    header.fcf.ackRequest = 1;
+    ieee802154_transceiver_frag_send_result_t result;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_frag_send(&header, iov, 3, 0, &result));
+    uint32_t fragments = (DATAGRAM_LEN + 107) / 108; // 9-byte MAC header, 8-byte fragment header
+    TEST_ASSERT_EQUAL(fragments, result.fragments);
+    TEST_ASSERT_EQUAL(fragments, result.sent);
+    TEST_ASSERT_EQUAL(0, result.retries);
+    TEST_ASSERT_TRUE(result.duration_us > 0);
+    wait_for(&peer_fragments, fragments);
+    TEST_ASSERT_EQUAL_UINT32(fragments, peer_fragments);
+    TEST_ASSERT_TRUE(peer_in_order);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(250 + fragments - 1), peer_last_seq);
+    TEST_ASSERT_EQUAL_MEMORY(datagram, peer_data, DATAGRAM_LEN);
+
+    // The next datagram takes the next tag
+    ieee802154_transceiver_frag_send_result_t next;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_frag_send(&header, iov, 1, 0, &next));
+    TEST_ASSERT_EQUAL((uint16_t)(result.tag + 1), next.tag);
+
+    ieee802154_transceiver_frag_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.tx_datagrams);
+    TEST_ASSERT_EQUAL_UINT32(fragments + next.fragments, stats.tx_fragments);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.tx_failed);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_frag_send_failure(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_frag_stats_t stats;
+    ieee802154_transceiver_frag_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(TX_CHANNEL));
+    ieee802154_transceiver_stats_t tx_stats;
+    ieee802154_transceiver_get_stats(&tx_stats, true);
+
+    // Nobody acknowledges: sending stops after the first lost fragment, not at the end of the datagram
+    static uint8_t datagram[DATAGRAM_LEN];
+    ieee802154_transceiver_frag_iov_t iov = { datagram, sizeof(datagram) };
+    ieee802154_frame_t header = make_header();
+    header.fcf.ackRequest = 1;
+    ieee802154_transceiver_frag_send_result_t result;
+    TEST_ASSERT_EQUAL(ESP_FAIL, ieee802154_transceiver_frag_send(&header, &iov, 1, 0, &result));
+    TEST_ASSERT_EQUAL(0, result.sent);
+    ieee802154_transceiver_frag_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.tx_datagrams);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.tx_failed);
+
+    ieee802154_transceiver_get_stats(&tx_stats, false);
+    TEST_ASSERT_TRUE(tx_stats.tx_queued < result.fragments);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_frag_reassembly(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_frag_stats_t stats;
+    ieee802154_transceiver_frag_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL(ESP_OK, init_receiver());
+    ieee802154_sim_node_config_t node_config = { .channel = TX_CHANNEL };
+    int node = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, node);
+
+    uint32_t delivered = 0;
+    ieee802154_transceiver_frag_rx_config_t rx_config = { .callback = NULL };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_frag_rx_start(NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_frag_rx_start(&rx_config));
+    rx_config = (ieee802154_transceiver_frag_rx_config_t){ .slots = 17, .callback = frag_rx, .ctx = &delivered };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_frag_rx_start(&rx_config));
+    rx_config.slots = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_frag_rx_stop());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_frag_rx_start(&rx_config));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_frag_rx_start(&rx_config));
+    rx_waiter = xTaskGetCurrentTaskHandle();
+
+    // Fragments arrive backwards, every third one after a repeat of the one before it
+    uint16_t count = (DATAGRAM_LEN + PEER_CHUNK - 1) / PEER_CHUNK;
+    uint8_t seq = 0;
+    for (int index = count - 1; index >= 0; index--) {
+        if (index % 3 == 0 && index + 1 < count) {
+            peer_send_fragment(node, 77, DATAGRAM_LEN, index + 1, seq++);
+        }
+        peer_send_fragment(node, 77, DATAGRAM_LEN, index, seq++);
+    }
+    TEST_ASSERT_EQUAL(1, ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAIT_TIMEOUT_MS)));
+    TEST_ASSERT_EQUAL_UINT32(1, delivered);
+    TEST_ASSERT_EQUAL(DATAGRAM_LEN, rx_len);
+    for (size_t i = 0; i < DATAGRAM_LEN; i++) {
+        TEST_ASSERT_EQUAL_HEX8(pattern(i), rx_data[i]);
+    }
+    TEST_ASSERT_EQUAL(2, rx_source.addr_len);
+    TEST_ASSERT_EQUAL_HEX8(0x01, rx_source.addr[0]);
+    TEST_ASSERT_EQUAL_HEX16(TEST_PAN_ID, rx_source.pan_id);
+    TEST_ASSERT_EQUAL(77, rx_source.tag);
+    TEST_ASSERT_EQUAL(count, rx_source.fragments);
+
+    // Datagrams over max_size are refused; a missing fragment never completes its datagram
+    peer_send_fragment(node, 78, 4097, 0, seq++);
+    peer_send_fragment(node, 79, 200, 0, seq++);
+    peer_send_fragment(node, 80, 100, 0, seq++);
+    peer_send_fragment(node, 80, 100, 1, seq++);
+    TEST_ASSERT_EQUAL(1, ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAIT_TIMEOUT_MS)));
+    TEST_ASSERT_EQUAL_UINT32(2, delivered);
+    TEST_ASSERT_EQUAL(100, rx_len);
+
+    ieee802154_transceiver_frag_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.rx_datagrams);
+    TEST_ASSERT_EQUAL_UINT32(count + 3, stats.rx_fragments);
+    TEST_ASSERT_EQUAL_UINT32((count + 1) / 3, stats.rx_duplicates);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rx_too_large);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rx_invalid);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_frag_rx_stop());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_frag_reassembly_timeout(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_frag_stats_t stats;
+    ieee802154_transceiver_frag_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL(ESP_OK, init_receiver());
+    ieee802154_sim_node_config_t node_config = { .channel = TX_CHANNEL };
+    int node = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, node);
+
+    uint32_t delivered = 0;
+    ieee802154_transceiver_frag_rx_config_t rx_config = {
+        .slots = 1,
+        .max_size = 512,
+        .timeout_ms = 50,
+        .callback = frag_rx,
+        .ctx = &delivered,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_frag_rx_start(&rx_config));
+    rx_waiter = xTaskGetCurrentTaskHandle();
+
+    // The only slot is busy until the stalled datagram times out
+    peer_send_fragment(node, 1, 200, 0, 0);
+    peer_send_fragment(node, 2, 100, 0, 1);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    peer_send_fragment(node, 2, 100, 0, 2);
+    peer_send_fragment(node, 2, 100, 1, 3);
+    TEST_ASSERT_EQUAL(1, ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAIT_TIMEOUT_MS)));
+    TEST_ASSERT_EQUAL(2, rx_source.tag);
+
+    ieee802154_transceiver_frag_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rx_no_slot);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rx_timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rx_datagrams);
+
+    // Stopped, fragments are left to the other receive callbacks
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_frag_rx_stop());
+    peer_send_fragment(node, 3, 50, 0, 4);
+    vTaskDelay(pdMS_TO_TICKS(50));
+    ieee802154_transceiver_frag_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rx_fragments);
+    TEST_ASSERT_EQUAL_UINT32(1, delivered);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+void run_frag_tests(void) {
+    RUN_TEST(test_reassembly_out_of_order);
+    RUN_TEST(test_reassembly_rejects);
+    RUN_TEST(test_reassembly_slots_and_expiry);
+    RUN_TEST(test_frag_send);
+    RUN_TEST(test_frag_send_failure);
+    RUN_TEST(test_frag_reassembly);
+    RUN_TEST(test_frag_reassembly_timeout);
+}
@@ -0,0 +1,248 @@
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+
+#include "frame_ring.h"
+#include "host_test.h"
+
+#define MAX_FRAME_LEN 128
+#define RX_QUEUE_DEPTH 16 // Kconfig default
+
+// Same shape as the transceiver's frame_data_t
+typedef struct {
+    uint8_t frame[MAX_FRAME_LEN];
+    uint32_t seq;
+    int64_t arrival_us;
+} test_slot_t;
+
+static test_slot_t storage[RX_QUEUE_DEPTH];
+
+static void test_frame_ring_fifo_order(void) {
+    frame_ring_t ring;
+    frame_ring_init(&ring, storage, sizeof(test_slot_t), 3);
+
+    TEST_ASSERT_NULL(frame_ring_peek(&ring, 0));
+
+    // Wrap the positions several times with an odd depth
+    uint32_t next_in = 0, next_out = 0;
+    for (int round = 0; round < 10; round++) {
+        test_slot_t *slot;
+        while ((slot = frame_ring_acquire(&ring)) != NULL) {
+            slot->seq = next_in++;
+            frame_ring_commit(&ring);
+        }
+        TEST_ASSERT_EQUAL_UINT32(3, frame_ring_count(&ring));
+
+        for (uint32_t i = 0; i < 3; i++) {
+            slot = frame_ring_peek(&ring, i);
+            TEST_ASSERT_NOT_NULL(slot);
+            TEST_ASSERT_EQUAL_UINT32(next_out + i, slot->seq);
+        }
+        TEST_ASSERT_NULL(frame_ring_peek(&ring, 3));
+
+        frame_ring_release(&ring, 2);
+        next_out += 2;
+        slot = frame_ring_peek(&ring, 0);
+        TEST_ASSERT_EQUAL_UINT32(next_out, slot->seq);
+        frame_ring_release(&ring, 1);
+        next_out += 1;
+        TEST_ASSERT_EQUAL_UINT32(0, frame_ring_count(&ring));
+    }
+}
+
+static void test_frame_ring_commit_reports_empty(void) {
+    frame_ring_t ring;
+    frame_ring_init(&ring, storage, sizeof(test_slot_t), RX_QUEUE_DEPTH);
+
+    frame_ring_acquire(&ring);
+    TEST_ASSERT_TRUE(frame_ring_commit(&ring));
+    frame_ring_acquire(&ring);
+    TEST_ASSERT_FALSE(frame_ring_commit(&ring));
+
+    frame_ring_release(&ring, 2);
+    frame_ring_acquire(&ring);
+    TEST_ASSERT_TRUE(frame_ring_commit(&ring));
+}
+
+//=========================================================================================
+// Burst model: back-to-back frames against a receive task with a fixed service time.
+// Runs on virtual time so the result does not depend on the host scheduler.
+
+#define BURST_FRAMES     12
+#define BURST_SPACING_US 600   // Short data frames back-to-back on the air
+#define BURST_PERIOD_US  50000
+#define BURST_COUNT      1000
+#define SERVICE_US       1500  // Parse + callback per frame
+
+typedef struct {
+    bool busy;
+    int64_t now_us;
+    int64_t done_us;
+    uint32_t next_seq;
+    uint32_t served;
+} consumer_model_t;
+
+static void consumer_advance(frame_ring_t *ring, consumer_model_t *c, int64_t until_us) {
+    while (1) {
+        if (c->busy) {
+            if (c->done_us > until_us) {
+                return;
+            }
+            frame_ring_release(ring, 1);
+            c->busy = false;
+            c->now_us = c->done_us;
+            c->served++;
+        }
+
+        test_slot_t *slot = frame_ring_peek(ring, 0);
+        if (!slot) {
+            return;
+        }
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(c->next_seq, slot->seq);
+        c->next_seq = slot->seq + 1;
+
+        int64_t start_us = (slot->arrival_us > c->now_us) ? slot->arrival_us : c->now_us;
+        c->busy = true;
+        c->done_us = start_us + SERVICE_US;
+    }
+}
+
+static uint32_t run_burst_model(uint32_t depth) {
+    frame_ring_t ring;
+    consumer_model_t consumer = {0};
+    uint32_t seq = 0, drops = 0;
+
+    frame_ring_init(&ring, storage, sizeof(test_slot_t), depth);
+
+    for (int burst = 0; burst < BURST_COUNT; burst++) {
+        for (int i = 0; i < BURST_FRAMES; i++) {
+            int64_t arrival_us = (int64_t)burst * BURST_PERIOD_US + (int64_t)i * BURST_SPACING_US;
+            consumer_advance(&ring, &consumer, arrival_us);
+
+            test_slot_t *slot = frame_ring_acquire(&ring);
+            if (!slot) {
+                drops++;
+                seq++;
+                continue;
+            }
+            slot->seq = seq++;
+            slot->arrival_us = arrival_us;
+            frame_ring_commit(&ring);
+        }
+    }
+    consumer_advance(&ring, &consumer, INT64_MAX);
+
+    TEST_ASSERT_EQUAL_UINT32(seq, consumer.served + drops);
+    return drops;
+}
+
+static void test_frame_ring_burst_no_drops(void) {
+    // One slot is what the old single-frame message buffer could hold
+    uint32_t drops_single = run_burst_model(1);
+    uint32_t drops_ring = run_burst_model(RX_QUEUE_DEPTH);
+
+    printf("burst %d x %d us, service %d us: drops depth 1 = %u, depth %d = %u (of %d)\n",
+           BURST_FRAMES, BURST_SPACING_US, SERVICE_US,
+           drops_single, RX_QUEUE_DEPTH, drops_ring, BURST_FRAMES * BURST_COUNT);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, drops_single);
+    TEST_ASSERT_EQUAL_UINT32(0, drops_ring);
+}
+
+//=========================================================================================
+// Threaded stress: a real producer and consumer hammering the ring concurrently.
+// The consumer sleeps on a semaphore that the producer posts only when
+// frame_ring_commit() reports an empty ring, so a lost wakeup shows up as a timeout.
+
+#define STRESS_FRAMES 1000000
+
+typedef struct {
+    frame_ring_t ring;
+    sem_t wake;
+    uint32_t full_events;
+    uint32_t corrupt;
+    uint32_t timeouts;
+    uint32_t received;
+} stress_ctx_t;
+
+static void *stress_producer(void *arg) {
+    stress_ctx_t *ctx = arg;
+
+    for (uint32_t seq = 0; seq < STRESS_FRAMES; seq++) {
+        test_slot_t *slot;
+        while ((slot = frame_ring_acquire(&ctx->ring)) == NULL) {
+            ctx->full_events++;
+            sched_yield();
+        }
+        uint8_t len = 5 + (seq % (MAX_FRAME_LEN - 5));
+        slot->frame[0] = len;
+        memset(&slot->frame[1], (uint8_t)seq, len - 1);
+        slot->seq = seq;
+
+        if (frame_ring_commit(&ctx->ring)) {
+            sem_post(&ctx->wake);
+        }
+    }
+    return NULL;
+}
+
+static void *stress_consumer(void *arg) {
+    stress_ctx_t *ctx = arg;
+    uint32_t expected = 0;
+
+    while (expected < STRESS_FRAMES) {
+        test_slot_t *slot = frame_ring_peek(&ctx->ring, 0);
+        if (!slot) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += 1;
+            if (sem_timedwait(&ctx->wake, &deadline) != 0 && errno == ETIMEDOUT) {
+                ctx->timeouts++;
+            }
+            continue;
+        }
+
+        if (slot->seq != expected || slot->frame[0] != 5 + (expected % (MAX_FRAME_LEN - 5)) ||
+            slot->frame[slot->frame[0] - 1] != (uint8_t)expected) {
+            ctx->corrupt++;
+        }
+        expected++;
+        ctx->received++;
+        frame_ring_release(&ctx->ring, 1);
+    }
+    return NULL;
+}
+
+static void test_frame_ring_threaded_stress(void) {
+    static stress_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    frame_ring_init(&ctx.ring, storage, sizeof(test_slot_t), RX_QUEUE_DEPTH);
+    sem_init(&ctx.wake, 0, 0);
+
+    pthread_t producer, consumer;
+    TEST_ASSERT_EQUAL(0, pthread_create(&consumer, NULL, stress_consumer, &ctx));
+    TEST_ASSERT_EQUAL(0, pthread_create(&producer, NULL, stress_producer, &ctx));
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    sem_destroy(&ctx.wake);
+
+    printf("stress: %u frames, %u full events, %u wakeup timeouts\n",
+           ctx.received, ctx.full_events, ctx.timeouts);
+
+    TEST_ASSERT_EQUAL_UINT32(STRESS_FRAMES, ctx.received);
+    TEST_ASSERT_EQUAL_UINT32(0, ctx.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(0, ctx.timeouts);
+}
+
+void run_frame_ring_tests(void) {
+    RUN_TEST(test_frame_ring_fifo_order);
+    RUN_TEST(test_frame_ring_commit_reports_empty);
+    RUN_TEST(test_frame_ring_burst_no_drops);
+    RUN_TEST(test_frame_ring_threaded_stress);
+}
@@ -0,0 +1,214 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "neighbor_table.h"
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_neighbor.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 11
+
+static neighbor_entry_t entries[64];
+static uint16_t slots[128];
+static neighbor_table_t table;
+
+static neighbor_key_t short_key(uint16_t addr, uint16_t pan_id) {
+    uint8_t bytes[2] = { addr & 0xff, addr >> 8 };
+    return neighbor_table_key(bytes, 2, pan_id);
+}
+
+// Walk the recency list and check it against the hash slots
+static void check_table_consistent(void) {
+    uint32_t listed = 0;
+    uint16_t prev = NEIGHBOR_TABLE_NONE;
+    for (uint16_t index = table.head; index != NEIGHBOR_TABLE_NONE; index = entries[index].next) {
+        TEST_ASSERT_EQUAL(prev, entries[index].prev);
+        TEST_ASSERT_TRUE(neighbor_table_get(&table, &entries[index].key) == &entries[index]);
+        prev = index;
+        listed++;
+    }
+    TEST_ASSERT_EQUAL(prev, table.tail);
+    TEST_ASSERT_EQUAL(table.count, listed);
+
+    uint32_t used = 0;
+    for (uint32_t i = 0; i <= table.slot_mask; i++) {
+        used += slots[i] != 0;
+    }
+    TEST_ASSERT_EQUAL(table.count, used);
+}
+
+//=========================================================================================
+// Table
+
+static void test_neighbor_table_metrics(void) {
+    neighbor_table_init(&table, entries, 8, slots, 2); // Weight 1/4
+    neighbor_key_t key = short_key(0x0001, 0x1234);
+
+    // The first frame sets the averages, later ones move them a quarter of the way
+    TEST_ASSERT_FALSE(neighbor_table_update(&table, &key, -60, 200, true, 10, 1000));
+    const neighbor_entry_t *entry = neighbor_table_get(&table, &key);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(-60, entry->info.rssi_avg);
+    TEST_ASSERT_EQUAL(200, entry->info.lqi_avg);
+    neighbor_table_update(&table, &key, -80, 100, true, 11, 2000);
+    TEST_ASSERT_EQUAL(-65, entry->info.rssi_avg);
+    TEST_ASSERT_EQUAL(-80, entry->info.rssi_last);
+    TEST_ASSERT_EQUAL(175, entry->info.lqi_avg);
+    TEST_ASSERT_EQUAL(2000, entry->info.last_seen_us);
+
+    // Sequence gaps count as lost frames, repeats as retransmissions, big jumps as restarts
+    neighbor_table_update(&table, &key, -65, 175, true, 14, 3000); // 12 and 13 missed
+    neighbor_table_update(&table, &key, -65, 175, true, 14, 4000);
+    neighbor_table_update(&table, &key, -65, 175, true, 200, 5000);
+    neighbor_table_update(&table, &key, -65, 175, false, 0, 6000); // Beacon
+    neighbor_table_update(&table, &key, -65, 175, true, 202, 7000);
+    TEST_ASSERT_EQUAL_UINT32(7, entry->info.frames);
+    TEST_ASSERT_EQUAL_UINT32(3, entry->info.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, entry->info.repeated);
+
+    // Sequence numbers wrap
+    neighbor_table_update(&table, &key, -65, 175, true, 255, 8000);
+    neighbor_table_update(&table, &key, -65, 175, true, 1, 9000);
+    TEST_ASSERT_EQUAL_UINT32(4, entry->info.lost);
+
+    // Short addresses are scoped by PAN, extended ones are not
+    neighbor_key_t other_pan = short_key(0x0001, 0x4321);
+    TEST_ASSERT_NULL(neighbor_table_get(&table, &other_pan));
+    const uint8_t ext[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    neighbor_key_t ext_a = neighbor_table_key(ext, 8, 0x1234);
+    neighbor_key_t ext_b = neighbor_table_key(ext, 8, 0x4321);
+    TEST_ASSERT_TRUE(neighbor_key_equal(&ext_a, &ext_b));
+    neighbor_table_update(&table, &ext_a, -40, 250, true, 0, 10000);
+    entry = neighbor_table_get(&table, &ext_b);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_MEMORY(ext, entry->info.addr, 8);
+    TEST_ASSERT_EQUAL_HEX16(0xffff, entry->info.pan_id);
+}
+
+static void test_neighbor_table_lru_eviction(void) {
+    neighbor_table_init(&table, entries, 64, slots, 3);
+
+    // Fill the table, then keep the even neighbors fresh
+    for (int i = 0; i < 64; i++) {
+        neighbor_key_t key = short_key(i, 0x1234);
+        TEST_ASSERT_FALSE(neighbor_table_update(&table, &key, -50, 200, true, 0, i));
+    }
+    for (int i = 0; i < 64; i += 2) {
+        neighbor_key_t key = short_key(i, 0x1234);
+        neighbor_table_update(&table, &key, -50, 200, true, 1, 100 + i);
+    }
+    check_table_consistent();
+
+    // Newcomers evict the odd neighbors, least recently heard first
+    for (int i = 0; i < 32; i++) {
+        neighbor_key_t key = short_key(1000 + i, 0x1234);
+        TEST_ASSERT_TRUE(neighbor_table_update(&table, &key, -50, 200, true, 0, 1000 + i));
+        neighbor_key_t evicted = short_key(2 * i + 1, 0x1234);
+        TEST_ASSERT_NULL(neighbor_table_get(&table, &evicted));
+        check_table_consistent();
+    }
+    for (int i = 0; i < 64; i += 2) {
+        neighbor_key_t key = short_key(i, 0x1234);
+        TEST_ASSERT_NOT_NULL(neighbor_table_get(&table, &key));
+    }
+    TEST_ASSERT_EQUAL(64, table.count);
+}
+
+static void test_neighbor_table_churn(void) {
+    neighbor_table_init(&table, entries, 64, slots, 3);
+    uint32_t rand_state = 7;
+
+    // Random senders out of 200: the table always holds exactly the 64 heard most recently
+    static int64_t last_heard[200];
+    memset(last_heard, 0, sizeof(last_heard));
+    for (int64_t t = 1; t <= 5000; t++) {
+        rand_state = rand_state * 1103515245 + 12345;
+        int sender = (rand_state >> 8) % 200;
+        neighbor_key_t key = short_key(sender, 0xabcd);
+        neighbor_table_update(&table, &key, -70, 150, true, (uint8_t)t, t);
+        last_heard[sender] = t;
+    }
+    check_table_consistent();
+
+    int64_t cutoff = table.entries[table.tail].info.last_seen_us;
+    int recent = 0;
+    for (int sender = 0; sender < 200; sender++) {
+        neighbor_key_t key = short_key(sender, 0xabcd);
+        bool kept = neighbor_table_get(&table, &key) != NULL;
+        TEST_ASSERT_EQUAL(last_heard[sender] >= cutoff, kept);
+        recent += kept;
+    }
+    TEST_ASSERT_EQUAL(64, recent);
+}
+
+//=========================================================================================
+// Tracking over the simulated radio
+
+static void test_neighbor_tracking(void) {
+    ieee802154_sim_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_transceiver_neighbor_config_t config = { .capacity = 4 };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_neighbor_start(&config));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_neighbor_start(&config));
+
+    // Two nodes at different signal levels; the far one loses every fourth frame
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rssi = -45, .lqi = 240 };
+    int near = ieee802154_sim_node_create(&node_config);
+    node_config.rssi = -85;
+    node_config.lqi = 60;
+    int far = ieee802154_sim_node_create(&node_config);
+    uint8_t frame[128];
+    for (int i = 0; i < 40; i++) {
+        make_data_frame(frame, (uint8_t)i, 0xffff, 0x0001, 4);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(near, frame));
+        if (i % 4 != 3) {
+            make_data_frame(frame, (uint8_t)i, 0xffff, 0x0002, 4);
+            TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(far, frame));
+        }
+        vTaskDelay(1);
+    }
+    vTaskDelay(pdMS_TO_TICKS(20));
+
+    ieee802154_transceiver_neighbor_t neighbor;
+    const uint8_t near_addr[2] = { 0x01, 0x00 }, far_addr[2] = { 0x02, 0x00 };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_neighbor_get(near_addr, 2, 0x1234, &neighbor));
+    TEST_ASSERT_EQUAL(-45, neighbor.rssi_avg);
+    TEST_ASSERT_EQUAL(240, neighbor.lqi_avg);
+    TEST_ASSERT_EQUAL_UINT32(40, neighbor.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, neighbor.lost);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_neighbor_get(far_addr, 2, 0x1234, &neighbor));
+    TEST_ASSERT_EQUAL(-85, neighbor.rssi_avg);
+    TEST_ASSERT_EQUAL_UINT32(30, neighbor.frames);
+    TEST_ASSERT_EQUAL_UINT32(9, neighbor.lost); // The last loss is not followed by a frame
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, ieee802154_transceiver_neighbor_get(far_addr, 2, 0x4321, &neighbor));
+
+    // The list is ordered by recency
+    ieee802154_transceiver_neighbor_t list[4];
+    size_t count;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_neighbor_list(list, 4, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL_HEX8(0x01, list[0].addr[0]);
+
+    ieee802154_transceiver_neighbor_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_neighbor_get_stats(&stats, false));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.neighbors);
+    TEST_ASSERT_EQUAL_UINT32(70, stats.updates);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_neighbor_clear());
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, ieee802154_transceiver_neighbor_get(near_addr, 2, 0x1234, &neighbor));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_neighbor_stop());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_neighbor_get(near_addr, 2, 0x1234, &neighbor));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+void run_neighbor_table_tests(void) {
+    RUN_TEST(test_neighbor_table_metrics);
+    RUN_TEST(test_neighbor_table_lru_eviction);
+    RUN_TEST(test_neighbor_table_churn);
+    RUN_TEST(test_neighbor_tracking);
+}
@@ -0,0 +1,250 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "pcapng.h"
+#include "ieee802154_transceiver_pcap.h"
+#include "host_test.h"
+
+//=========================================================================================
+// Minimal pcapng reader, the way a host tool sees the stream
+
+typedef struct {
+    uint32_t type;
+    const uint8_t *body; // Between the length fields
+    uint32_t body_len;
+} test_block_t;
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Next block at *pos; false at the end of the data or on a truncated or inconsistent block
+static bool read_block(const uint8_t *data, size_t len, size_t *pos, test_block_t *block) {
+    if (*pos + 12 > len) {
+        return false;
+    }
+    uint32_t total = get_u32(data + *pos + 4);
+    if (total < 12 || total % 4 != 0 || *pos + total > len || get_u32(data + *pos + total - 4) != total) {
+        return false;
+    }
+
+    block->type = get_u32(data + *pos);
+    block->body = data + *pos + 8;
+    block->body_len = total - 12;
+    *pos += total;
+    return true;
+}
+
+typedef struct {
+    uint64_t timestamp_us;
+    uint8_t fcs_type;
+    float rss;
+    uint16_t channel;
+    uint8_t lqi;
+    uint64_t sof_ns;
+    const uint8_t *mac;
+    uint32_t mac_len;
+} test_packet_t;
+
+// Decode an enhanced packet block and its TAP header
+static void read_packet(const test_block_t *block, test_packet_t *packet) {
+    TEST_ASSERT_EQUAL_HEX32(PCAPNG_BLOCK_EPB, block->type);
+    const uint8_t *p = block->body;
+    memset(packet, 0, sizeof(*packet));
+    TEST_ASSERT_EQUAL_UINT32(0, get_u32(p)); // Interface
+    packet->timestamp_us = ((uint64_t)get_u32(p + 4) << 32) | get_u32(p + 8);
+    uint32_t captured = get_u32(p + 12);
+    TEST_ASSERT_EQUAL_UINT32(captured, get_u32(p + 16));
+    TEST_ASSERT_TRUE(20 + captured <= block->body_len);
+    p += 20;
+
+    TEST_ASSERT_EQUAL_UINT16(0, get_u16(p));
+    uint16_t tap_len = get_u16(p + 2);
+    TEST_ASSERT_TRUE(tap_len <= captured);
+    for (uint16_t off = 4; off < tap_len;) {
+        uint16_t type = get_u16(p + off);
+        uint16_t len = get_u16(p + off + 2);
+        const uint8_t *value = p + off + 4;
+        switch (type) {
+        case PCAPNG_TAP_FCS_TYPE: packet->fcs_type = value[0]; break;
+        case PCAPNG_TAP_RSS: memcpy(&packet->rss, value, sizeof(float)); break;
+        case PCAPNG_TAP_CHANNEL: packet->channel = get_u16(value); break;
+        case PCAPNG_TAP_LQI: packet->lqi = value[0]; break;
+        case PCAPNG_TAP_SOF_TS: memcpy(&packet->sof_ns, value, sizeof(uint64_t)); break;
+        default: TEST_FAIL_MESSAGE("unexpected TLV");
+        }
+        off += 4 + ((len + 3) & ~3);
+    }
+    packet->mac = p + tap_len;
+    packet->mac_len = captured - tap_len;
+}
+
+//=========================================================================================
+// Encoder
+
+static void test_pcapng_encoder_layout(void) {
+    static uint8_t out[PCAPNG_HEADER_LEN + 3 * PCAPNG_EPB_MAX_LEN];
+    const uint8_t lengths[] = { 5, 20, 127 };
+    uint8_t frames[3][128];
+    esp_ieee802154_frame_info_t info = { .channel = 15, .rssi = -72, .lqi = 201 };
+
+    size_t len = pcapng_write_header(out);
+    TEST_ASSERT_EQUAL(PCAPNG_HEADER_LEN, len);
+    for (int i = 0; i < 3; i++) {
+        fill_frame(frames[i], lengths[i], i);
+        size_t epb_len = pcapng_write_epb(out + len, frames[i], &info, 1700000000000000ULL + i);
+        TEST_ASSERT_EQUAL(pcapng_epb_len(frames[i]), epb_len);
+        len += epb_len;
+    }
+
+    size_t pos = 0;
+    test_block_t block;
+    TEST_ASSERT_TRUE(read_block(out, len, &pos, &block));
+    TEST_ASSERT_EQUAL_HEX32(PCAPNG_BLOCK_SHB, block.type);
+    TEST_ASSERT_EQUAL_HEX32(PCAPNG_BYTE_ORDER_MAGIC, get_u32(block.body));
+    TEST_ASSERT_EQUAL_UINT16(1, get_u16(block.body + 4));
+
+    TEST_ASSERT_TRUE(read_block(out, len, &pos, &block));
+    TEST_ASSERT_EQUAL_HEX32(PCAPNG_BLOCK_IDB, block.type);
+    TEST_ASSERT_EQUAL_UINT16(PCAPNG_LINKTYPE_IEEE802_15_4_TAP, get_u16(block.body));
+
+    for (int i = 0; i < 3; i++) {
+        test_packet_t packet;
+        TEST_ASSERT_TRUE(read_block(out, len, &pos, &block));
+        read_packet(&block, &packet);
+        TEST_ASSERT_TRUE(packet.timestamp_us == 1700000000000000ULL + i);
+        TEST_ASSERT_TRUE(packet.sof_ns == packet.timestamp_us * 1000);
+        TEST_ASSERT_EQUAL_UINT8(0, packet.fcs_type);
+        TEST_ASSERT_EQUAL_FLOAT(-72.0f, packet.rss);
+        TEST_ASSERT_EQUAL_UINT16(15, packet.channel);
+        TEST_ASSERT_EQUAL_UINT8(201, packet.lqi);
+        // The MAC frame without its FCS
+        TEST_ASSERT_EQUAL_UINT32(lengths[i] - 2, packet.mac_len);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(&frames[i][1], packet.mac, packet.mac_len);
+    }
+    TEST_ASSERT_EQUAL(len, pos);
+}
+
+//=========================================================================================
+// Streaming sink
+
+#define STREAM_CAPACITY (256 * 1024)
+#define STREAM_BLOCK_SIZE 1024
+
+static uint8_t stream[STREAM_CAPACITY];
+static volatile size_t stream_len;
+static volatile uint32_t stream_chunks;
+
+static void collect_output(const uint8_t *data, size_t len, void *ctx) {
+    // Every chunk holds whole pcapng blocks and fits one output block
+    TEST_ASSERT_TRUE(len <= STREAM_BLOCK_SIZE);
+    size_t pos = 0;
+    test_block_t block;
+    while (read_block(data, len, &pos, &block)) {
+    }
+    TEST_ASSERT_EQUAL(len, pos);
+
+    TEST_ASSERT_TRUE(stream_len + len <= STREAM_CAPACITY);
+    memcpy(stream + stream_len, data, len);
+    stream_len += len;
+    stream_chunks++;
+}
+
+static void test_pcap_sink_stream(void) {
+    stream_len = 0;
+    stream_chunks = 0;
+    ieee802154_transceiver_pcap_config_t config = {
+        .output = collect_output,
+        .block_size = STREAM_BLOCK_SIZE,
+        .flush_ms = 10,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_pcap_start(&config));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_pcap_start(&config));
+
+    uint8_t frame[128];
+    esp_ieee802154_frame_info_t info = { .channel = 20, .rssi = -40, .lqi = 255 };
+    uint32_t recorded = 0;
+    for (int i = 0; i < 500; i++) {
+        fill_frame(frame, 5 + i % 123, (uint8_t)i);
+        info.timestamp = 1000 + i;
+        if (ieee802154_transceiver_pcap_record(frame, &info) == ESP_OK) {
+            recorded++;
+        }
+        if (i % 16 == 15) {
+            vTaskDelay(1);
+        }
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_pcap_stop());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_pcap_record(frame, &info));
+
+    ieee802154_transceiver_pcap_stats_t stats;
+    ieee802154_transceiver_pcap_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(recorded, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(500, stats.frames + stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(stream_len, stats.bytes);
+    TEST_ASSERT_EQUAL_UINT32(stream_chunks, stats.blocks);
+
+    // One section, then the recorded frames in order with increasing timestamps
+    size_t pos = 0;
+    test_block_t block;
+    TEST_ASSERT_TRUE(read_block(stream, stream_len, &pos, &block));
+    TEST_ASSERT_EQUAL_HEX32(PCAPNG_BLOCK_SHB, block.type);
+    TEST_ASSERT_TRUE(read_block(stream, stream_len, &pos, &block));
+    TEST_ASSERT_EQUAL_HEX32(PCAPNG_BLOCK_IDB, block.type);
+
+    uint32_t packets = 0;
+    uint64_t last_timestamp_us = 0;
+    while (read_block(stream, stream_len, &pos, &block)) {
+        test_packet_t packet;
+        read_packet(&block, &packet);
+        TEST_ASSERT_TRUE(packet.timestamp_us > last_timestamp_us);
+        TEST_ASSERT_EQUAL_UINT16(20, packet.channel);
+        last_timestamp_us = packet.timestamp_us;
+        packets++;
+    }
+    TEST_ASSERT_EQUAL(stream_len, pos);
+    TEST_ASSERT_EQUAL_UINT32(recorded, packets);
+}
+
+static void test_pcap_sink_flush_partial_block(void) {
+    stream_len = 0;
+    stream_chunks = 0;
+    ieee802154_transceiver_pcap_config_t config = {
+        .output = collect_output,
+        .block_size = STREAM_BLOCK_SIZE,
+        .flush_ms = 20,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_pcap_start(&config));
+
+    // The headers go out on their own, then a lone frame once it is due
+    vTaskDelay(pdMS_TO_TICKS(100));
+    TEST_ASSERT_EQUAL(PCAPNG_HEADER_LEN, stream_len);
+
+    uint8_t frame[128];
+    esp_ieee802154_frame_info_t info = { .channel = 11, .rssi = -80, .lqi = 100 };
+    fill_frame(frame, 30, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_pcap_record(frame, &info));
+    vTaskDelay(pdMS_TO_TICKS(100));
+    TEST_ASSERT_EQUAL(PCAPNG_HEADER_LEN + pcapng_epb_len(frame), stream_len);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_pcap_stop());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ieee802154_transceiver_pcap_stop());
+}
+
+void run_pcapng_tests(void) {
+    RUN_TEST(test_pcapng_encoder_layout);
+    RUN_TEST(test_pcap_sink_stream);
+    RUN_TEST(test_pcap_sink_flush_partial_block);
+}
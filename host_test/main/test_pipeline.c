@@ -0,0 +1,397 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_bridge.h"
+#include "ieee802154_transceiver_scan.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 11
+#define TX_CHANNEL 13
+#define SENDER_ADDR 0xabcd
+#define PACE_FRAMES 8 // Frames sent per tick, well below the receive queue depth
+
+//=========================================================================================
+// esp_ieee802154 callbacks, raised by the simulated radio
+
+void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info)
+{
+    ieee802154_transceiver_handle_receive_done(frame, frame_info);
+}
+
+void esp_ieee802154_transmit_done(const uint8_t *frame, const uint8_t *ack, esp_ieee802154_frame_info_t *ack_frame_info)
+{
+    ieee802154_transceiver_handle_transmit_done(frame, ack, ack_frame_info);
+}
+
+void esp_ieee802154_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error)
+{
+    ieee802154_transceiver_handle_transmit_failed(frame, error);
+}
+
+void esp_ieee802154_energy_detect_done(int8_t power)
+{
+    ieee802154_transceiver_handle_energy_detect_done(power);
+}
+
+//=========================================================================================
+// Helpers
+
+static volatile uint32_t radio_rx_count;
+static volatile uint32_t radio_rx_out_of_order;
+
+static void count_raw_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    if (frame[3] != (uint8_t)radio_rx_count) {
+        radio_rx_out_of_order++;
+    }
+    radio_rx_count++;
+}
+
+static volatile uint32_t parsed_rx_count;
+static volatile uint32_t parsed_rx_out_of_order;
+
+// Slow consumer: holds the dispatch task for a tick every few frames
+static void slow_parsed_callback(ieee802154_frame_t *frame, const esp_ieee802154_frame_info_t *frame_info,
+                                 void *user_data) {
+    if (frame->sequenceNumber != (uint8_t)parsed_rx_count) {
+        parsed_rx_out_of_order++;
+    }
+    parsed_rx_count++;
+    if (parsed_rx_count % 16 == 0) {
+        vTaskDelay(1);
+    }
+}
+
+static void pipeline_setup(void) {
+    ieee802154_sim_reset();
+    radio_rx_count = 0;
+    radio_rx_out_of_order = 0;
+    reset_traffic_counters();
+    ieee802154_transceiver_get_stats(&(ieee802154_transceiver_stats_t){0}, true);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+}
+
+static void pipeline_teardown(void) {
+    ieee802154_transceiver_set_rx_raw_callback(NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+//=========================================================================================
+// Tests
+
+static void test_pipeline_receive_in_order(void) {
+    pipeline_setup();
+    ieee802154_transceiver_set_rx_raw_callback(count_raw_callback, NULL);
+
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+    config.channel = RX_CHANNEL + 1;
+    int other = ieee802154_sim_node_create(&config);
+    TEST_ASSERT_GREATER_THAN(0, sender);
+    TEST_ASSERT_GREATER_THAN(0, other);
+
+    // Only the frames on the receive channel arrive, in order
+    uint8_t frame[128];
+    for (int i = 0; i < 1000; i++) {
+        make_data_frame(frame, (uint8_t)i, 0xffff, SENDER_ADDR, i % 100);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(other, frame));
+        if (i % PACE_FRAMES == PACE_FRAMES - 1) {
+            vTaskDelay(1);
+        }
+    }
+    TEST_ASSERT_TRUE(wait_for(&radio_rx_count, 1000));
+    vTaskDelay(pdMS_TO_TICKS(10));
+    TEST_ASSERT_EQUAL_UINT32(1000, radio_rx_count);
+    TEST_ASSERT_EQUAL_UINT32(0, radio_rx_out_of_order);
+
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.rx_frames);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.rx_queued);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.rx_callbacks);
+
+    pipeline_teardown();
+}
+
+static void test_pipeline_two_stage_receive(void) {
+    ieee802154_sim_reset();
+    parsed_rx_count = 0;
+    parsed_rx_out_of_order = 0;
+    ieee802154_transceiver_get_stats(&(ieee802154_transceiver_stats_t){0}, true);
+
+    ieee802154_transceiver_config_t transceiver_config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(RX_CHANNEL);
+    transceiver_config.pipelined = true;
+    transceiver_config.dispatch_task.stack_size = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_init_with_config(&transceiver_config));
+    transceiver_config.dispatch_task.stack_size = 4096;
+    transceiver_config.rx_task.priority = 6; // Parse ahead of the callbacks
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init_with_config(&transceiver_config));
+    ieee802154_transceiver_set_rx_callback(slow_parsed_callback, NULL);
+
+    // Matched in the dispatch task against the header decoded by the receive task
+    radio_rx_count = 0;
+    radio_rx_out_of_order = 0;
+    ieee802154_transceiver_filter_t filter = { .match = IEEE802154_TRANSCEIVER_FILTER_DEST_PAN, .dest_pan_id = 0x1234 };
+    int subscriber_id;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_subscribe(&filter, count_raw_callback, NULL, &subscriber_id));
+
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+    TEST_ASSERT_GREATER_THAN(0, sender);
+
+    // The stalls back up in the dispatch ring, parsed frames still arrive in order
+    uint8_t frame[128];
+    for (int i = 0; i < 500; i++) {
+        make_data_frame(frame, (uint8_t)i, 0xffff, SENDER_ADDR, i % 100);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+        if (i % PACE_FRAMES == PACE_FRAMES - 1) {
+            vTaskDelay(1);
+        }
+    }
+    TEST_ASSERT_TRUE(wait_for(&parsed_rx_count, 500));
+    TEST_ASSERT_EQUAL_UINT32(0, parsed_rx_out_of_order);
+    TEST_ASSERT_EQUAL_UINT32(500, radio_rx_count);
+    TEST_ASSERT_EQUAL_UINT32(0, radio_rx_out_of_order);
+
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(500, stats.rx_queued);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.rx_callbacks);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rx_parse_failures);
+    TEST_ASSERT_GREATER_THAN_UINT32(1, stats.rx_pipe_high_water);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_unsubscribe(subscriber_id));
+    ieee802154_transceiver_set_rx_callback(NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_pipeline_static_storage(void) {
+    static uint64_t buffer[8192]; // 64 KiB
+    ieee802154_transceiver_storage_t storage = { .buffer = buffer };
+    ieee802154_sim_reset();
+    radio_rx_count = 0;
+    radio_rx_out_of_order = 0;
+
+    ieee802154_transceiver_config_t transceiver_config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(RX_CHANNEL);
+    transceiver_config.rx_queue_depth = 64;
+    transceiver_config.tx_queue_depth = 4;
+    transceiver_config.pipelined = true;
+    transceiver_config.coordinator = true;
+    transceiver_config.tx_power = 10;
+    transceiver_config.storage = &storage;
+
+    // The size covers both rings, the queue and three stacks
+    size_t size;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_get_storage_size(&transceiver_config, &size));
+    TEST_ASSERT_GREATER_THAN(64 * 2 * 128 + 5 * 1024 + 4 * 1024 + 5 * 1024, size);
+    TEST_ASSERT_TRUE(size <= sizeof(buffer));
+    transceiver_config.rx_queue_depth = 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_get_storage_size(&transceiver_config, &size));
+    transceiver_config.rx_queue_depth = 64;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_get_storage_size(&transceiver_config, &size));
+
+    storage.size = size - 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, ieee802154_transceiver_init_with_config(&transceiver_config));
+    storage.buffer = (uint8_t *)buffer + 1;
+    storage.size = sizeof(buffer) - 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_init_with_config(&transceiver_config));
+    storage.buffer = buffer;
+    storage.size = size;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init_with_config(&transceiver_config));
+    TEST_ASSERT_EQUAL(10, esp_ieee802154_get_txpower());
+    TEST_ASSERT_TRUE(esp_ieee802154_get_promiscuous());
+    ieee802154_transceiver_set_rx_raw_callback(count_raw_callback, NULL);
+
+    // A burst larger than the default ring fits the configured one
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+    uint8_t frame[128];
+    for (int i = 0; i < 48; i++) {
+        make_data_frame(frame, (uint8_t)i, 0xffff, SENDER_ADDR, 20);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+    }
+    TEST_ASSERT_TRUE(wait_for(&radio_rx_count, 48));
+    TEST_ASSERT_EQUAL_UINT32(0, radio_rx_out_of_order);
+
+    pipeline_teardown();
+}
+
+static void test_pipeline_medium_loss(void) {
+    pipeline_setup();
+    ieee802154_transceiver_set_rx_raw_callback(count_raw_callback, NULL);
+
+    ieee802154_sim_medium_t medium = { .loss = 0.25f, .seed = 1234 };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_set_medium(&medium));
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+
+    uint8_t frame[128];
+    for (int i = 0; i < 1000; i++) {
+        make_data_frame(frame, (uint8_t)i, 0xffff, SENDER_ADDR, 10);
+        ieee802154_sim_node_transmit(sender, frame);
+        if (i % PACE_FRAMES == PACE_FRAMES - 1) {
+            vTaskDelay(1);
+        }
+    }
+    ieee802154_sim_reset(); // Flushes the medium
+    vTaskDelay(pdMS_TO_TICKS(10));
+
+    // About a quarter is lost, and everything else is received
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_UINT32_WITHIN(60, 750, radio_rx_count);
+    TEST_ASSERT_EQUAL_UINT32(radio_rx_count, stats.rx_queued);
+
+    pipeline_teardown();
+}
+
+static void test_pipeline_transmit_other_channel(void) {
+    pipeline_setup();
+
+    ieee802154_sim_node_config_t config = { .channel = TX_CHANNEL, .rx_cb = count_peer_callback };
+    TEST_ASSERT_GREATER_THAN(0, ieee802154_sim_node_create(&config));
+
+    // Queued frames reach the peer, then the radio returns to the receive channel
+    uint8_t frame[128];
+    for (int i = 0; i < 5; i++) {
+        make_data_frame(frame, (uint8_t)i, 0xffff, SENDER_ADDR, 20);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_transmit_raw_async(frame, TX_CHANNEL, count_tx_done, NULL));
+    }
+    TEST_ASSERT_TRUE(wait_for(&tx_done_count, 5));
+    TEST_ASSERT_EQUAL_UINT32(5, peer_rx_count);
+    TEST_ASSERT_EQUAL_UINT32(0, tx_done_errors);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    TEST_ASSERT_EQUAL(RX_CHANNEL, esp_ieee802154_get_channel());
+
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.tx_succeeded);
+    TEST_ASSERT_EQUAL_UINT32(stats.tx_submitted, stats.tx_succeeded + stats.tx_failed);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.tx_refused);
+
+    pipeline_teardown();
+}
+
+static void test_pipeline_bridge(void) {
+    pipeline_setup();
+
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+    config.channel = TX_CHANNEL;
+    config.rx_cb = count_peer_callback;
+    TEST_ASSERT_GREATER_THAN(0, ieee802154_sim_node_create(&config));
+
+    ieee802154_transceiver_bridge_config_t bridge_config = {
+        .src_channel = RX_CHANNEL,
+        .dst_channel = TX_CHANNEL,
+        .max_batch = 4,
+        .max_hold_ms = 2,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_start(&bridge_config));
+
+    uint8_t frame[128];
+    for (int i = 0; i < 100; i++) {
+        make_data_frame(frame, (uint8_t)i, 0xffff, SENDER_ADDR, 30);
+        ieee802154_sim_node_transmit(sender, frame);
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    wait_for(&peer_rx_count, 100);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_stop());
+
+    // Frames that arrive while the radio is away on the destination channel are missed
+    ieee802154_transceiver_bridge_stats_t stats;
+    ieee802154_transceiver_bridge_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(peer_rx_count, stats.forwarded);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(90, stats.forwarded);
+    TEST_ASSERT_EQUAL_UINT32(stats.forwarded, stats.latency_samples);
+
+    pipeline_teardown();
+}
+
+// Stopping while frames keep arriving must not leave the receive hook sending to a deleted queue
+static void test_pipeline_bridge_restart(void) {
+    pipeline_setup();
+
+    ieee802154_sim_node_config_t config = { .channel = RX_CHANNEL, .rssi = -60, .lqi = 180 };
+    int sender = ieee802154_sim_node_create(&config);
+    config.channel = TX_CHANNEL;
+    TEST_ASSERT_GREATER_THAN(0, ieee802154_sim_node_create(&config));
+
+    ieee802154_transceiver_bridge_config_t bridge_config = {
+        .src_channel = RX_CHANNEL,
+        .dst_channel = TX_CHANNEL,
+        .max_batch = 4,
+        .max_hold_ms = 2,
+    };
+    uint8_t frame[128];
+    for (int cycle = 0; cycle < 20; cycle++) {
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_start(&bridge_config));
+        for (int i = 0; i < PACE_FRAMES; i++) {
+            make_data_frame(frame, (uint8_t)i, 0xffff, SENDER_ADDR, 30);
+            ieee802154_sim_node_transmit(sender, frame);
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_stop());
+    }
+
+    pipeline_teardown();
+}
+
+static void ignore_batch_callback(ieee802154_frame_t *frames, esp_ieee802154_frame_info_t *frame_infos,
+                                  size_t count, void *user_data) {
+}
+
+// Batch sizes are bounded by the queue depths given at init, not only by Kconfig
+static void test_pipeline_batch_limits(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_config_t transceiver_config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(RX_CHANNEL);
+    transceiver_config.rx_queue_depth = 2;
+    transceiver_config.tx_queue_depth = 4;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init_with_config(&transceiver_config));
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_set_rx_batch_callback(ignore_batch_callback, 3, 10, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_rx_batch_callback(ignore_batch_callback, 2, 10, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_rx_batch_callback(NULL, 0, 0, NULL));
+
+    // Shallower than CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH, as configured
+    ieee802154_transceiver_bridge_config_t bridge_config = {
+        .src_channel = RX_CHANNEL,
+        .dst_channel = TX_CHANNEL,
+        .max_batch = 5,
+        .max_hold_ms = 2,
+    };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_bridge_start(&bridge_config));
+    bridge_config.max_batch = 4;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_start(&bridge_config));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_stop());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+
+    // Deeper than CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH, which still bounds the batch buffer
+    transceiver_config.tx_queue_depth = CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH * 2;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init_with_config(&transceiver_config));
+    bridge_config.max_batch = CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH + 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_bridge_start(&bridge_config));
+    bridge_config.max_batch = CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_start(&bridge_config));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_bridge_stop());
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+
+    // A batch callback set earlier rules out a shallower receive queue
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_rx_batch_callback(ignore_batch_callback, 4, 10, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_init_with_config(&transceiver_config));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_rx_batch_callback(NULL, 0, 0, NULL));
+}
+
+void run_pipeline_tests(void) {
+    RUN_TEST(test_pipeline_receive_in_order);
+    RUN_TEST(test_pipeline_two_stage_receive);
+    RUN_TEST(test_pipeline_static_storage);
+    RUN_TEST(test_pipeline_medium_loss);
+    RUN_TEST(test_pipeline_transmit_other_channel);
+    RUN_TEST(test_pipeline_bridge);
+    RUN_TEST(test_pipeline_bridge_restart);
+    RUN_TEST(test_pipeline_batch_limits);
+}
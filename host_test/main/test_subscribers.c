@@ -0,0 +1,280 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "subscriber_index.h"
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_priv.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define RX_CHANNEL 11
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    rand_state = rand_state * 1103515245 + 12345;
+    return rand_state >> 8;
+}
+
+//=========================================================================================
+// Index
+
+static const uint16_t pans[] = { 0x1234, 0xabcd, 0xffff };
+static const uint8_t addrs[][8] = {
+    { 0x01, 0x00 },
+    { 0xff, 0xff },
+    { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 },
+    { 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 },
+};
+static const uint8_t addr_lens[] = { 2, 2, 8, 8 };
+static const uint8_t sender_addr[2] = { 0x01, 0x00 };
+
+// Data frame to addrs[0] on TEST_PAN_ID; the first payload byte doubles as a command ID
+static const test_frame_t data_frame = {
+    .type = 1,
+    .seq = 0x5a,
+    .pan_id = TEST_PAN_ID,
+    .dest = addrs[0],
+    .dest_len = 2,
+    .src = sender_addr,
+    .src_len = 2,
+    .payload = (const uint8_t[]){ 0x00, 0xee },
+    .payload_len = 2,
+};
+static const uint8_t data_request[] = { 0x04, 0xee };
+static const uint8_t beacon_request[] = { 0x07, 0xee };
+
+static void random_filter(ieee802154_transceiver_filter_t *filter) {
+    memset(filter, 0, sizeof(*filter));
+    if (next_rand() % 2) {
+        filter->match |= IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE;
+        filter->frame_types = next_rand() & 0x0f;
+    }
+    if (next_rand() % 2) {
+        filter->match |= IEEE802154_TRANSCEIVER_FILTER_DEST_PAN;
+        filter->dest_pan_id = pans[next_rand() % 3];
+    }
+    if (next_rand() % 2) {
+        int a = next_rand() % 4;
+        filter->match |= IEEE802154_TRANSCEIVER_FILTER_DEST_ADDR;
+        memcpy(filter->dest_addr, addrs[a], addr_lens[a]);
+        filter->dest_addr_len = addr_lens[a];
+    }
+    if (next_rand() % 3 == 0) {
+        filter->match |= IEEE802154_TRANSCEIVER_FILTER_COMMAND_ID;
+        filter->command_id = 1 + next_rand() % 3;
+    }
+}
+
+static void test_subscriber_index_matches_filters(void) {
+    static ieee802154_transceiver_filter_t filters[32];
+    static subscriber_index_t index;
+    esp_ieee802154_frame_info_t info = { .channel = RX_CHANNEL };
+    uint8_t frame[128];
+    rand_state = 42;
+
+    // The index holds only the filter fields it covers, so it must agree exactly
+    for (int round = 0; round < 50; round++) {
+        uint32_t active = next_rand();
+        for (int i = 0; i < 32; i++) {
+            random_filter(&filters[i]);
+        }
+        subscriber_index_build(&index, filters, active);
+
+        for (int f = 0; f < 40; f++) {
+            int a = next_rand() % 4;
+            test_frame_t fields = data_frame;
+            fields.type = next_rand() % 4;
+            fields.pan_id = pans[next_rand() % 3];
+            fields.dest = addrs[a];
+            fields.dest_len = addr_lens[a];
+            fields.payload = (const uint8_t[]){ 1 + next_rand() % 3, 0xee };
+            build_frame(frame, &fields);
+            ieee802154_transceiver_header_t header;
+            TEST_ASSERT_TRUE(ieee802154_transceiver_header_decode(frame, &header));
+
+            uint32_t expected = 0;
+            for (int i = 0; i < 32; i++) {
+                if ((active & (1u << i)) && transceiver_filter_match(&filters[i], &header, &info)) {
+                    expected |= 1u << i;
+                }
+            }
+            TEST_ASSERT_EQUAL_HEX32(expected, subscriber_index_lookup(&index, &header));
+        }
+    }
+}
+
+static void test_subscriber_index_command_id(void) {
+    ieee802154_transceiver_filter_t filters[2] = {
+        { .match = IEEE802154_TRANSCEIVER_FILTER_COMMAND_ID, .command_id = 0x04 }, // Data request
+        { 0 },
+    };
+    subscriber_index_t index;
+    subscriber_index_build(&index, filters, 0x3);
+
+    // Only unsecured MAC command frames carry a readable command ID
+    uint8_t frame[128];
+    ieee802154_transceiver_header_t header;
+    test_frame_t fields = data_frame;
+    fields.type = 3;
+    fields.payload = data_request;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_decode(frame, &header));
+    TEST_ASSERT_EQUAL_HEX32(0x3, subscriber_index_lookup(&index, &header));
+    fields.type = 1;
+    build_frame(frame, &fields);
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_decode(frame, &header));
+    TEST_ASSERT_EQUAL_HEX32(0x2, subscriber_index_lookup(&index, &header));
+    fields.type = 3;
+    build_frame(frame, &fields);
+    frame[1] |= 1 << 3; // Security enabled
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_decode(frame, &header));
+    TEST_ASSERT_EQUAL_HEX32(0x2, subscriber_index_lookup(&index, &header));
+}
+
+//=========================================================================================
+// Delivery over the simulated radio
+
+typedef struct {
+    volatile uint32_t frames;
+    volatile uint32_t wrong;
+    uint8_t type;
+} test_module_t;
+
+static void module_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    test_module_t *module = user_data;
+    if ((frame[1] & 0x07) != module->type) {
+        module->wrong++;
+    }
+    module->frames++;
+}
+
+static volatile uint32_t all_frames;
+
+static void all_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info, void *user_data) {
+    all_frames++;
+}
+
+static void test_subscribers_delivery(void) {
+    ieee802154_sim_reset();
+    all_frames = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rssi = -50, .lqi = 220 };
+    int sender = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_THAN(0, sender);
+
+    // Routing wants data frames to its PAN, the commissioner data requests, logging everything
+    test_module_t routing = { .type = 1 }, commissioner = { .type = 3 };
+    ieee802154_transceiver_filter_t routing_filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE | IEEE802154_TRANSCEIVER_FILTER_DEST_PAN,
+        .frame_types = 1 << 1,
+        .dest_pan_id = 0x1234,
+    };
+    ieee802154_transceiver_filter_t commissioner_filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_COMMAND_ID,
+        .command_id = 0x04,
+    };
+    int routing_id, commissioner_id, all_id;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_subscribe(&routing_filter, module_callback, &routing, &routing_id));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_subscribe(&commissioner_filter, module_callback, &commissioner,
+                                                               &commissioner_id));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_subscribe(NULL, all_callback, NULL, &all_id));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_subscribe(NULL, NULL, NULL, NULL));
+
+    // 40 frames: data to 0x1234, data to 0xabcd, data requests, beacon requests
+    uint8_t frame[128];
+    for (int i = 0; i < 40; i++) {
+        test_frame_t fields = data_frame;
+        switch (i % 4) {
+        case 0: break;
+        case 1: fields.pan_id = 0xabcd; break;
+        case 2:
+            fields.type = 3;
+            fields.dest = addrs[2];
+            fields.dest_len = 8;
+            fields.payload = data_request;
+            break;
+        case 3:
+            fields.type = 3;
+            fields.pan_id = 0xffff;
+            fields.dest = addrs[1];
+            fields.payload = beacon_request;
+            break;
+        }
+        build_frame(frame, &fields);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+        vTaskDelay(1);
+    }
+    wait_for(&all_frames, 40);
+    TEST_ASSERT_EQUAL_UINT32(40, all_frames);
+    TEST_ASSERT_EQUAL_UINT32(10, routing.frames);
+    TEST_ASSERT_EQUAL_UINT32(10, commissioner.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, routing.wrong + commissioner.wrong);
+
+    // Unsubscribed modules get nothing more
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_unsubscribe(routing_id));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, ieee802154_transceiver_unsubscribe(routing_id));
+    build_frame(frame, &data_frame);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+    wait_for(&all_frames, 41);
+    TEST_ASSERT_EQUAL_UINT32(41, all_frames);
+    TEST_ASSERT_EQUAL_UINT32(10, routing.frames);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_unsubscribe(commissioner_id));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_unsubscribe(all_id));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+// Subscribers come and go while frames are delivered; the ones staying subscribed miss nothing
+static void test_subscribers_change_while_receiving(void) {
+    ieee802154_sim_reset();
+    all_frames = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_init(RX_CHANNEL));
+    ieee802154_sim_node_config_t node_config = { .channel = RX_CHANNEL, .rssi = -50, .lqi = 220 };
+    int sender = ieee802154_sim_node_create(&node_config);
+    TEST_ASSERT_GREATER_THAN(0, sender);
+
+    test_module_t routing = { .type = 1 }, churn = { 0 };
+    ieee802154_transceiver_filter_t routing_filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE | IEEE802154_TRANSCEIVER_FILTER_DEST_PAN,
+        .frame_types = 1 << 1,
+        .dest_pan_id = 0x1234,
+    };
+    int routing_id, all_id;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_subscribe(&routing_filter, module_callback, &routing, &routing_id));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_subscribe(NULL, all_callback, NULL, &all_id));
+
+    uint8_t frame[128];
+    rand_state = 7;
+    for (int i = 0; i < 100; i++) {
+        ieee802154_transceiver_filter_t filter;
+        random_filter(&filter);
+        int id;
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_subscribe(&filter, module_callback, &churn, &id));
+        build_frame(frame, &data_frame);
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_node_transmit(sender, frame));
+        TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_unsubscribe(id));
+        if (i % 8 == 7) {
+            vTaskDelay(1);
+        }
+    }
+    wait_for(&all_frames, 100);
+    TEST_ASSERT_EQUAL_UINT32(100, all_frames);
+    TEST_ASSERT_EQUAL_UINT32(100, routing.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, routing.wrong);
+
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_unsubscribe(routing_id));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_unsubscribe(all_id));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+void run_subscriber_tests(void) {
+    RUN_TEST(test_subscriber_index_matches_filters);
+    RUN_TEST(test_subscriber_index_command_id);
+    RUN_TEST(test_subscribers_delivery);
+    RUN_TEST(test_subscribers_change_while_receiving);
+}
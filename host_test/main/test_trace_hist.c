@@ -0,0 +1,57 @@
+#include <string.h>
+
+#include "unity.h"
+
+#include "trace_hist.h"
+#include "host_test.h"
+
+static void test_trace_hist_buckets(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, trace_hist_bucket(0));
+    TEST_ASSERT_EQUAL_UINT32(1, trace_hist_bucket(1));
+    TEST_ASSERT_EQUAL_UINT32(2, trace_hist_bucket(2));
+    TEST_ASSERT_EQUAL_UINT32(2, trace_hist_bucket(3));
+    TEST_ASSERT_EQUAL_UINT32(7, trace_hist_bucket(100));
+    TEST_ASSERT_EQUAL_UINT32(11, trace_hist_bucket(1024));
+
+    // Everything past the last boundary lands in the open-ended bucket
+    TEST_ASSERT_EQUAL_UINT32(IEEE802154_TRANSCEIVER_TRACE_BUCKETS - 1, trace_hist_bucket(UINT32_MAX));
+}
+
+static void test_trace_hist_percentiles(void) {
+    ieee802154_transceiver_trace_hist_t hist;
+    memset(&hist, 0, sizeof(hist));
+    TEST_ASSERT_EQUAL_UINT32(0, trace_hist_percentile(&hist, 99));
+
+    // 99 fast samples and one outlier
+    for (int i = 0; i < 99; i++) {
+        trace_hist_add(&hist, 100);
+    }
+    trace_hist_add(&hist, 5000);
+
+    TEST_ASSERT_EQUAL_UINT32(100, hist.count);
+    TEST_ASSERT_EQUAL_UINT32(5000, hist.max_us);
+    TEST_ASSERT_TRUE(hist.sum_us == 99 * 100 + 5000);
+
+    // Bucket upper bound for 100 us is 127 us; the outlier is capped at the max
+    TEST_ASSERT_EQUAL_UINT32(127, trace_hist_percentile(&hist, 50));
+    TEST_ASSERT_EQUAL_UINT32(127, trace_hist_percentile(&hist, 99));
+    TEST_ASSERT_EQUAL_UINT32(5000, trace_hist_percentile(&hist, 99.5f));
+    TEST_ASSERT_EQUAL_UINT32(5000, trace_hist_percentile(&hist, 100));
+    TEST_ASSERT_EQUAL_UINT32(127, trace_hist_percentile(&hist, 0));
+}
+
+static void test_trace_hist_single_sample(void) {
+    ieee802154_transceiver_trace_hist_t hist;
+    memset(&hist, 0, sizeof(hist));
+
+    // Never report more than was observed
+    trace_hist_add(&hist, 70);
+    TEST_ASSERT_EQUAL_UINT32(70, trace_hist_percentile(&hist, 50));
+    TEST_ASSERT_EQUAL_UINT32(70, trace_hist_percentile(&hist, 99.9f));
+}
+
+void run_trace_hist_tests(void) {
+    RUN_TEST(test_trace_hist_buckets);
+    RUN_TEST(test_trace_hist_percentiles);
+    RUN_TEST(test_trace_hist_single_sample);
+}
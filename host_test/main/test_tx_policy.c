@@ -0,0 +1,235 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_priv.h"
+#include "ieee802154_sim.h"
+#include "host_test.h"
+
+#define TX_CHANNEL 20
+#define LOSS_FRAMES 40
+
+// Outcome of the last frame, handed over by the transmit task
+static ieee802154_transceiver_tx_result_t last_result;
+static TaskHandle_t result_waiter;
+
+static void result_tx_done(const ieee802154_transceiver_tx_result_t *result, void *ctx) {
+    last_result = *result;
+    xTaskNotifyGive(result_waiter);
+}
+
+// Send one frame and wait for its outcome
+static const ieee802154_transceiver_tx_result_t *send_frame(uint8_t seq, bool ack_request) {
+    uint8_t frame[16];
+    make_data_frame(frame, seq, 0x00aa, 0x0001, 0); // Unicast, so it can request an acknowledgment
+    if (ack_request) {
+        frame[1] |= 0x20;
+    }
+    result_waiter = xTaskGetCurrentTaskHandle();
+    memset(&last_result, 0, sizeof(last_result));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_transmit_raw_async(frame, 0, result_tx_done, NULL));
+    TEST_ASSERT_EQUAL(1, ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAIT_TIMEOUT_MS)));
+    return &last_result;
+}
+
+static esp_err_t init_with_policy(const ieee802154_transceiver_tx_policy_t *policy) {
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(TX_CHANNEL);
+    config.tx_policy = *policy;
+    return ieee802154_transceiver_init_with_config(&config);
+}
+
+//=========================================================================================
+// Tests
+
+static void test_tx_policy_settings(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_tx_policy_t bad = { .min_be = 4, .max_be = 3 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, init_with_policy(&bad));
+
+    ieee802154_transceiver_tx_policy_t policy = { 0 };
+    TEST_ASSERT_EQUAL(ESP_OK, init_with_policy(&policy));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_get_tx_policy(&policy));
+    TEST_ASSERT_FALSE(policy.cca);
+    TEST_ASSERT_EQUAL(0, policy.max_retries);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_set_tx_policy(NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_set_tx_policy(&bad));
+    bad = (ieee802154_transceiver_tx_policy_t){ .max_retries = 8 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_set_tx_policy(&bad));
+    bad = (ieee802154_transceiver_tx_policy_t){ .max_csma_backoffs = 6 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ieee802154_transceiver_set_tx_policy(&bad));
+
+    ieee802154_transceiver_tx_policy_t csma = IEEE802154_TRANSCEIVER_TX_POLICY_CSMA;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_tx_policy(&csma));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_get_tx_policy(&policy));
+    TEST_ASSERT_EQUAL_MEMORY(&csma, &policy, sizeof(policy));
+
+    // The default policy sends once, at once
+    ieee802154_sim_node_config_t node_config = { .channel = TX_CHANNEL, .ack = true };
+    TEST_ASSERT_GREATER_OR_EQUAL(1, ieee802154_sim_node_create(&node_config));
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_tx_policy(&(ieee802154_transceiver_tx_policy_t){ 0 }));
+    const ieee802154_transceiver_tx_result_t *result = send_frame(1, true);
+    TEST_ASSERT_EQUAL(ESP_OK, result->status);
+    TEST_ASSERT_EQUAL(IEEE802154_TRANSCEIVER_TX_OUTCOME_OK, result->outcome);
+    TEST_ASSERT_EQUAL(1, result->attempts);
+    TEST_ASSERT_EQUAL(0, result->backoff_us);
+    TEST_ASSERT_TRUE(result->ack_received);
+    TEST_ASSERT_TRUE(result->done_time_us >= result->queued_time_us);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_tx_policy_no_ack_retries(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_tx_policy_t policy = { .max_retries = 3 };
+    TEST_ASSERT_EQUAL(ESP_OK, init_with_policy(&policy));
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, true);
+
+    // Nobody acknowledges: every retry is used, and the reason is kept
+    const ieee802154_transceiver_tx_result_t *result = send_frame(1, true);
+    TEST_ASSERT_EQUAL(ESP_FAIL, result->status);
+    TEST_ASSERT_EQUAL(IEEE802154_TRANSCEIVER_TX_OUTCOME_NO_ACK, result->outcome);
+    TEST_ASSERT_EQUAL(ESP_IEEE802154_TX_ERR_NO_ACK, result->error);
+    TEST_ASSERT_EQUAL(4, result->attempts);
+    TEST_ASSERT_EQUAL(3, result->retries);
+    TEST_ASSERT_FALSE(result->ack_received);
+
+    // Frames without an acknowledgment request are not retried
+    result = send_frame(2, false);
+    TEST_ASSERT_EQUAL(ESP_OK, result->status);
+    TEST_ASSERT_EQUAL(1, result->attempts);
+
+    // An acknowledging peer ends it at the first attempt
+    ieee802154_sim_node_config_t node_config = { .channel = TX_CHANNEL, .rssi = -42, .lqi = 230, .ack = true };
+    TEST_ASSERT_GREATER_OR_EQUAL(1, ieee802154_sim_node_create(&node_config));
+    result = send_frame(3, true);
+    TEST_ASSERT_EQUAL(IEEE802154_TRANSCEIVER_TX_OUTCOME_OK, result->outcome);
+    TEST_ASSERT_EQUAL(1, result->attempts);
+    TEST_ASSERT_EQUAL(0, result->retries);
+    TEST_ASSERT_TRUE(result->ack_received);
+    TEST_ASSERT_EQUAL(-42, result->ack_info.rssi);
+
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.tx_queued);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.tx_submitted);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.tx_no_ack);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.tx_retries);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.tx_frames_failed);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_tx_policy_busy_channel(void) {
+    ieee802154_sim_reset();
+    ieee802154_transceiver_tx_policy_t policy = {
+        .cca = true,
+        .max_csma_backoffs = 2,
+        .min_be = 1,
+        .max_be = 3,
+        .max_retries = 1,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, init_with_policy(&policy));
+    ieee802154_sim_node_config_t node_config = { .channel = TX_CHANNEL, .ack = true };
+    TEST_ASSERT_GREATER_OR_EQUAL(1, ieee802154_sim_node_create(&node_config));
+    ieee802154_transceiver_stats_t stats;
+    ieee802154_transceiver_get_stats(&stats, true);
+
+    // A quiet channel passes CCA
+    const ieee802154_transceiver_tx_result_t *result = send_frame(1, true);
+    TEST_ASSERT_EQUAL(IEEE802154_TRANSCEIVER_TX_OUTCOME_OK, result->outcome);
+    TEST_ASSERT_EQUAL(0, result->cca_busy);
+
+    // A jammed one fails CCA after every backoff of every attempt, and nothing goes on the air
+    ieee802154_sim_stats_t sim_stats;
+    ieee802154_sim_get_stats(&sim_stats);
+    uint32_t transmitted = sim_stats.transmitted;
+    ieee802154_sim_set_noise(TX_CHANNEL, -50);
+    result = send_frame(2, true);
+    TEST_ASSERT_EQUAL(ESP_FAIL, result->status);
+    TEST_ASSERT_EQUAL(IEEE802154_TRANSCEIVER_TX_OUTCOME_CHANNEL_BUSY, result->outcome);
+    TEST_ASSERT_EQUAL(ESP_IEEE802154_TX_ERR_CCA_BUSY, result->error);
+    TEST_ASSERT_EQUAL(6, result->attempts);
+    TEST_ASSERT_EQUAL(6, result->cca_busy);
+    TEST_ASSERT_EQUAL(1, result->retries);
+    TEST_ASSERT_TRUE(result->backoff_us % 320 == 0);
+    TEST_ASSERT_TRUE(result->backoff_us <= 2 * (1 + 3 + 7) * 320);
+    ieee802154_sim_get_stats(&sim_stats);
+    TEST_ASSERT_EQUAL_UINT32(transmitted, sim_stats.transmitted);
+    TEST_ASSERT_EQUAL_UINT32(6, sim_stats.cca_busy);
+
+    // Without CCA the frame goes out regardless, and at once
+    policy.cca = false;
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_set_tx_policy(&policy));
+    result = send_frame(3, true);
+    TEST_ASSERT_EQUAL(IEEE802154_TRANSCEIVER_TX_OUTCOME_OK, result->outcome);
+    TEST_ASSERT_EQUAL(0, result->backoff_us);
+
+    ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.tx_cca_busy);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.tx_frames_failed);
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+}
+
+static void test_tx_policy_backoff_wait(void) {
+    // Up to two backoff periods are busy-waited
+    TEST_ASSERT_EQUAL_UINT32(0, transceiver_wait_ticks(0, 10000, 640));
+    TEST_ASSERT_EQUAL_UINT32(0, transceiver_wait_ticks(2 * 320, 10000, 640));
+
+    // Longer ones sleep whole ticks, rounded up with one to spare
+    TEST_ASSERT_EQUAL_UINT32(2, transceiver_wait_ticks(3 * 320, 10000, 640));
+    TEST_ASSERT_EQUAL_UINT32(10, transceiver_wait_ticks(255 * 320, 10000, 640));
+    TEST_ASSERT_EQUAL_UINT32(83, transceiver_wait_ticks(255 * 320, 1000, 640));
+    TEST_ASSERT_EQUAL_UINT32(3, transceiver_wait_ticks(20 * 320, 3200, 640));
+    for (uint32_t periods = 3; periods < 256; periods++) {
+        uint32_t ticks = transceiver_wait_ticks(periods * 320, 1000, 640);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(periods * 320, (ticks - 1) * 1000);
+        TEST_ASSERT_LESS_THAN_UINT32(periods * 320 + 1000, (ticks - 1) * 1000);
+    }
+}
+
+// Send LOSS_FRAMES frames over a lossy medium; return how many were delivered
+static uint32_t send_lossy(const ieee802154_transceiver_tx_policy_t *policy, uint32_t *attempts) {
+    ieee802154_sim_reset();
+    ieee802154_sim_medium_t medium = { .loss = 0.5f, .seed = 7 };
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_sim_set_medium(&medium));
+    TEST_ASSERT_EQUAL(ESP_OK, init_with_policy(policy));
+    ieee802154_sim_node_config_t node_config = { .channel = TX_CHANNEL, .ack = true };
+    TEST_ASSERT_GREATER_OR_EQUAL(1, ieee802154_sim_node_create(&node_config));
+
+    uint32_t delivered = 0;
+    *attempts = 0;
+    for (uint8_t seq = 0; seq < LOSS_FRAMES; seq++) {
+        const ieee802154_transceiver_tx_result_t *result = send_frame(seq, true);
+        TEST_ASSERT_TRUE(result->attempts <= policy->max_retries + 1);
+        delivered += result->status == ESP_OK;
+        *attempts += result->attempts;
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, ieee802154_transceiver_deinit());
+    return delivered;
+}
+
+static void test_tx_policy_delivery_under_loss(void) {
+    // Retries trade airtime for delivery
+    uint32_t attempts_once, attempts_retried;
+    ieee802154_transceiver_tx_policy_t once = { 0 };
+    uint32_t delivered_once = send_lossy(&once, &attempts_once);
+    ieee802154_transceiver_tx_policy_t retried = { .max_retries = 3 };
+    uint32_t delivered_retried = send_lossy(&retried, &attempts_retried);
+
+    TEST_ASSERT_EQUAL_UINT32(LOSS_FRAMES, attempts_once);
+    TEST_ASSERT_LESS_THAN(LOSS_FRAMES * 3 / 4, delivered_once);
+    TEST_ASSERT_GREATER_THAN_UINT32(LOSS_FRAMES * 3 / 4, delivered_retried);
+    TEST_ASSERT_GREATER_THAN_UINT32(LOSS_FRAMES, attempts_retried);
+    ieee802154_sim_reset();
+}
+
+void run_tx_policy_tests(void) {
+    RUN_TEST(test_tx_policy_settings);
+    RUN_TEST(test_tx_policy_no_ack_retries);
+    RUN_TEST(test_tx_policy_busy_channel);
+    RUN_TEST(test_tx_policy_backoff_wait);
+    RUN_TEST(test_tx_policy_delivery_under_loss);
+}
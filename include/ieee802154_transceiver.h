@@ -1,74 +1,868 @@
-#ifndef IEEE802154_TRANSCEIVER_H
-#define IEEE802154_TRANSCEIVER_H
-
-#include <stdint.h>
-#include "esp_err.h"
-#include "ieee802154_frame.h" // From shoderico/ieee802154_frame
-#include "esp_ieee802154.h"
-
-/**
- * @brief Callback function type for received IEEE 802.15.4 frames.
- *
- * @param frame Parsed IEEE 802.15.4 frame.
- * @param frame_info Frame information (e.g., RSSI, LQI, channel).
- * @param user_data User-defined data passed to the callback.
- */
-typedef void (*ieee802154_transceiver_rx_callback_t)(ieee802154_frame_t *frame,
-                                                    esp_ieee802154_frame_info_t *frame_info,
-                                                    void *user_data);
-
-/**
- * @brief Initialize the IEEE 802.15.4 transceiver with a specified channel.
- *
- * @param channel Channel number (11-26) to set for the transceiver.
- * @note NVS must be initialized by the user before calling this function.
- * @return ESP_OK on success, or an error code on failure.
- */
-esp_err_t ieee802154_transceiver_init(uint8_t channel);
-
-/**
- * @brief Deinitialize the IEEE 802.15.4 transceiver.
- *
- * @return ESP_OK on success, or an error code on failure.
- */
-esp_err_t ieee802154_transceiver_deinit(void);
-
-/**
- * @brief Set the callback function for received frames.
- *
- * @param callback Callback function to invoke on frame reception.
- * @param user_data User-defined data to pass to the callback.
- * @return ESP_OK on success, or an error code on failure.
- */
-esp_err_t ieee802154_transceiver_set_rx_callback(ieee802154_transceiver_rx_callback_t callback, void *user_data);
-
-
-void ieee802154_transceiver_handle_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info);
-
-/**
- * @brief Transmit an IEEE 802.15.4 frame on the current channel.
- *
- * @param frame Frame to transmit.
- * @return ESP_OK on success, or an error code on failure.
- */
-esp_err_t ieee802154_transceiver_transmit(const ieee802154_frame_t *frame);
-
-/**
- * @brief Transmit an IEEE 802.15.4 frame on a specified channel.
- *
- * @param frame Frame to transmit.
- * @param channel Channel number (11-26) to use for transmission.
- * @note The channel is not restored after transmission; use ieee802154_transceiver_set_channel to restore it.
- * @return ESP_OK on success, or an error code on failure.
- */
-esp_err_t ieee802154_transceiver_transmit_channel(const ieee802154_frame_t *frame, uint8_t channel);
-
-/**
- * @brief Set the IEEE 802.15.4 channel.
- *
- * @param channel Channel number (11-26).
- * @return ESP_OK on success, or an error code on failure.
- */
-esp_err_t ieee802154_transceiver_set_channel(uint8_t channel);
-
+#ifndef IEEE802154_TRANSCEIVER_H
+#define IEEE802154_TRANSCEIVER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "ieee802154_frame.h" // From shoderico/ieee802154_frame
+#include "esp_ieee802154.h"
+
+/**
+ * @brief Callback function type for received IEEE 802.15.4 frames.
+ *
+ * @param frame Parsed IEEE 802.15.4 frame.
+ * @param frame_info Frame information (e.g., RSSI, LQI, channel).
+ * @param user_data User-defined data passed to the callback.
+ */
+typedef void (*ieee802154_transceiver_rx_callback_t)(ieee802154_frame_t *frame,
+                                                    esp_ieee802154_frame_info_t *frame_info,
+                                                    void *user_data);
+
+/**
+ * @brief Callback function type for batches of received IEEE 802.15.4 frames.
+ *
+ * @param frames Array of parsed IEEE 802.15.4 frames.
+ * @param frame_infos Array of frame information, one entry per frame.
+ * @param count Number of frames in the batch (at least 1).
+ * @param user_data User-defined data passed to the callback.
+ * @note The frames and their payloads are only valid until the callback returns.
+ */
+typedef void (*ieee802154_transceiver_rx_batch_callback_t)(ieee802154_frame_t *frames,
+                                                          esp_ieee802154_frame_info_t *frame_infos,
+                                                          size_t count,
+                                                          void *user_data);
+
+/**
+ * @brief Callback function type for received IEEE 802.15.4 frames, delivered without parsing.
+ *
+ * @param frame Raw frame as received by the radio: frame[0] is the PSDU length
+ *              (including the 2-byte FCS), followed by the PSDU.
+ * @param frame_info Frame information (e.g., RSSI, LQI, channel).
+ * @param user_data User-defined data passed to the callback.
+ * @note The buffer is only valid until the callback returns.
+ */
+typedef void (*ieee802154_transceiver_rx_raw_callback_t)(const uint8_t *frame,
+                                                        const esp_ieee802154_frame_info_t *frame_info,
+                                                        void *user_data);
+
+/**
+ * @brief MAC header view over a raw frame.
+ *
+ * Filled by ieee802154_transceiver_header_decode(), which only walks the frame
+ * control field to locate the addressing fields. Field values are read from the
+ * raw buffer on demand with the accessors below. Offsets index the raw frame
+ * (frame[0] is the length byte), so an offset of 0 means the field is absent.
+ */
+typedef struct {
+    const uint8_t *frame;     // Raw frame the view refers to
+    uint16_t fcf;             // Frame control field
+    uint8_t seq_offset;       // Sequence number, 0 if suppressed
+    uint8_t dest_pan_offset;  // Destination PAN ID, 0 if absent
+    uint8_t dest_addr_offset; // Destination address, 0 if absent
+    uint8_t dest_addr_len;    // 0, 2 (short) or 8 (extended)
+    uint8_t src_pan_offset;   // Source PAN ID, 0 if absent
+    uint8_t src_addr_offset;  // Source address, 0 if absent
+    uint8_t src_addr_len;     // 0, 2 (short) or 8 (extended)
+    uint8_t payload_offset;   // First byte after the addressing fields
+} ieee802154_transceiver_header_t;
+
+// Fields compared by an ieee802154_transceiver_filter_t
+#define IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE (1 << 0)
+#define IEEE802154_TRANSCEIVER_FILTER_DEST_PAN   (1 << 1)
+#define IEEE802154_TRANSCEIVER_FILTER_SRC_PAN    (1 << 2)
+#define IEEE802154_TRANSCEIVER_FILTER_DEST_ADDR  (1 << 3)
+#define IEEE802154_TRANSCEIVER_FILTER_SRC_ADDR   (1 << 4)
+#define IEEE802154_TRANSCEIVER_FILTER_MIN_RSSI   (1 << 5)
+#define IEEE802154_TRANSCEIVER_FILTER_MIN_LQI    (1 << 6)
+#define IEEE802154_TRANSCEIVER_FILTER_COMMAND_ID (1 << 7)
+
+/**
+ * @brief Receive filter entry.
+ *
+ * A frame matches an entry when every field selected in match compares equal
+ * (or, for RSSI/LQI, at least the minimum). Addresses are given in
+ * over-the-air (little-endian) byte order, as returned by the header view.
+ * A frame without a source PAN ID but with PAN ID compression set is compared
+ * using its destination PAN ID. A command ID only matches unsecured MAC command
+ * frames without information elements, where it is the first payload byte.
+ */
+typedef struct {
+    uint32_t match;         // IEEE802154_TRANSCEIVER_FILTER_* fields to compare
+    uint8_t frame_types;    // Accepted types as a bitmask of (1 << IEEE802154_FRAME_TYPE_*)
+    uint16_t dest_pan_id;
+    uint16_t src_pan_id;
+    uint8_t dest_addr[8];
+    uint8_t dest_addr_len;  // 2 (short) or 8 (extended)
+    uint8_t src_addr[8];
+    uint8_t src_addr_len;   // 2 (short) or 8 (extended)
+    int8_t min_rssi;        // dBm
+    uint8_t min_lqi;
+    uint8_t command_id;     // MAC command frame identifier
+} ieee802154_transceiver_filter_t;
+
+// Fields written by ieee802154_transceiver_rewrite()
+#define IEEE802154_TRANSCEIVER_REWRITE_SEQ      (1 << 0)
+#define IEEE802154_TRANSCEIVER_REWRITE_DEST_PAN (1 << 1)
+#define IEEE802154_TRANSCEIVER_REWRITE_SRC_PAN  (1 << 2)
+
+/**
+ * @brief In-place header rewrite applied to a raw frame.
+ */
+typedef struct {
+    uint32_t fields;      // IEEE802154_TRANSCEIVER_REWRITE_* fields to write
+    uint8_t seq;
+    uint16_t dest_pan_id;
+    uint16_t src_pan_id;
+} ieee802154_transceiver_rewrite_t;
+
+/**
+ * @brief Why an asynchronous transmission ended.
+ */
+typedef enum {
+    IEEE802154_TRANSCEIVER_TX_OUTCOME_OK,           // Sent, and ACKed when requested
+    IEEE802154_TRANSCEIVER_TX_OUTCOME_NO_ACK,       // No ACK after the last retry
+    IEEE802154_TRANSCEIVER_TX_OUTCOME_CHANNEL_BUSY, // Channel access failure: CCA busy after the last backoff and retry
+    IEEE802154_TRANSCEIVER_TX_OUTCOME_RADIO_ERROR,  // Other error reported by the radio, see error
+    IEEE802154_TRANSCEIVER_TX_OUTCOME_REFUSED,      // The radio refused the frame or the channel change
+    IEEE802154_TRANSCEIVER_TX_OUTCOME_TIMEOUT,      // The radio never reported completion
+} ieee802154_transceiver_tx_outcome_t;
+
+/**
+ * @brief Outcome of an asynchronous transmission.
+ */
+typedef struct {
+    esp_err_t status;                     // ESP_OK if the frame was sent (and ACKed, when requested)
+    ieee802154_transceiver_tx_outcome_t outcome; // Why the transmission ended
+    esp_ieee802154_tx_error_t error;      // Radio error of the last attempt, reported by esp_ieee802154_transmit_failed
+    const uint8_t *frame;                 // Transmitted frame (frame[0] is the length), valid during the callback
+    uint8_t channel;                      // Channel the frame was sent on
+    uint8_t attempts;                     // Times the frame was handed to the radio, CCA failures included
+    uint8_t retries;                      // Attempts repeated after no ACK or a channel access failure
+    uint8_t cca_busy;                     // Clear channel assessments that found the channel busy
+    uint32_t backoff_us;                  // Random backoffs drawn; sleeping them can take up to two ticks longer
+    bool ack_received;                    // An ACK frame was received
+    bool ack_frame_pending;               // Frame pending bit of the ACK
+    esp_ieee802154_frame_info_t ack_info; // RSSI/LQI of the ACK, valid if ack_received
+    int64_t queued_time_us;               // Time the frame was queued (esp_timer_get_time() clock)
+    int64_t done_time_us;                 // Time the radio reported completion (esp_timer_get_time() clock)
+} ieee802154_transceiver_tx_result_t;
+
+/**
+ * @brief Channel access and retry policy of the asynchronous transmit path.
+ *
+ * With cca set, before each attempt the transmit task waits a random backoff of
+ * 0 to 2^BE - 1 periods of 320 us (20 symbols), with BE starting at min_be, then
+ * hands the frame to the radio, which assesses the channel first. A busy channel
+ * raises BE (up to max_be) and backs off again, at most max_csma_backoffs times,
+ * after which the attempt is a channel access failure. Without cca frames are
+ * handed over at once. An attempt ending without an ACK or in a channel access
+ * failure is repeated up to max_retries times. The default, all zero, sends
+ * every frame once, at once and without CCA.
+ *
+ * Backoffs of up to two periods are busy-waited. Longer ones are slept in whole
+ * FreeRTOS ticks, rounded up with one tick to spare, so with a 100 Hz tick a
+ * 2.56 ms backoff takes 10 to 20 ms.
+ */
+typedef struct {
+    bool cca;                  // Clear channel assessment before each transmission
+    uint8_t max_csma_backoffs; // Further backoffs after the channel was found busy (0-5)
+    uint8_t min_be;            // Initial backoff exponent (0-8)
+    uint8_t max_be;            // Largest backoff exponent (min_be-8)
+    uint8_t max_retries;       // Attempts repeated after no ACK or a channel access failure (0-7)
+} ieee802154_transceiver_tx_policy_t;
+
+/**
+ * @brief Unslotted CSMA-CA with the IEEE 802.15.4 default MAC attributes.
+ */
+#define IEEE802154_TRANSCEIVER_TX_POLICY_CSMA { \
+    .cca = true,                                \
+    .max_csma_backoffs = 4,                     \
+    .min_be = 3,                                \
+    .max_be = 5,                                \
+    .max_retries = 3,                           \
+}
+
+/**
+ * @brief Callback function type for completed asynchronous transmissions.
+ *
+ * Invoked from the transceiver's transmit task, once per submitted frame.
+ *
+ * @param result Outcome of the transmission.
+ * @param ctx User-defined context passed to ieee802154_transceiver_transmit_async().
+ */
+typedef void (*ieee802154_transceiver_tx_done_callback_t)(const ieee802154_transceiver_tx_result_t *result, void *ctx);
+
+/**
+ * @brief Pre-built frame that can be sent repeatedly with in-place patches.
+ *
+ * Build once with ieee802154_transceiver_template_build(), then update the
+ * sequence number and payload bytes in place before each transmission. No
+ * rebuild and no buffer clear happens on the transmit path.
+ */
+typedef struct {
+    uint8_t frame[128];     // Built frame, frame[0] is the length
+    uint8_t seq_offset;     // Sequence number, 0 if suppressed
+    uint8_t payload_offset; // First payload byte
+    uint8_t payload_len;
+} ieee802154_transceiver_template_t;
+
+/**
+ * @brief Receive counters of one channel since initialization.
+ *
+ * Counters are free-running and wrap around; compare snapshots by subtraction.
+ */
+typedef struct {
+    uint32_t frames; // Frames heard, before filtering
+    uint32_t bytes;  // PSDU bytes heard, before filtering
+    uint32_t drops;  // Frames lost because the receive queue was full
+} ieee802154_transceiver_channel_stats_t;
+
+/**
+ * @brief Receive and transmit pipeline counters.
+ *
+ * Counted since boot or the last reset, across every channel. Frames that
+ * reached the radio but have not been reported yet are
+ * tx_submitted - tx_succeeded - tx_failed; frames the radio refused are only
+ * counted in tx_refused. Every member is a uint32_t.
+ */
+typedef struct {
+    uint32_t rx_frames;             // Frames delivered by the radio
+    uint32_t rx_bytes;              // PSDU bytes delivered by the radio
+    uint32_t rx_queued;             // Frames placed in the receive queue
+    uint32_t rx_dropped_queue_full; // Frames lost because the receive queue was full
+    uint32_t rx_dropped_filtered;   // Frames rejected by the receive filter table
+    uint32_t rx_dropped_invalid;    // Frames with an invalid length
+    uint32_t rx_dropped_duplicate;  // Retransmissions and echoes dropped by the dedupe stage
+    uint32_t rx_parse_failures;     // Queued frames ieee802154_frame_parse() rejected
+    uint32_t rx_callbacks;          // Receive callback invocations (raw, parsed, batch and subscribers)
+    uint32_t rx_queue_high_water;   // Most frames pending in the receive queue at once
+    uint32_t rx_pipe_high_water;    // Most parsed frames waiting for the dispatch task at once (pipelined)
+    uint32_t tx_queued;             // Frames accepted by the asynchronous transmit queue
+    uint32_t tx_dropped_queue_full; // Frames rejected because the transmit queue was full
+    uint32_t tx_queue_high_water;   // Most frames pending in the transmit queue at once
+    uint32_t tx_submitted;          // Frames handed to the radio
+    uint32_t tx_succeeded;          // Transmissions the radio reported as done
+    uint32_t tx_failed;             // Transmissions the radio reported as failed
+    uint32_t tx_refused;            // Frames the radio would not take, never submitted
+    uint32_t tx_bytes;              // PSDU bytes successfully transmitted
+    uint32_t tx_retries;            // Attempts repeated by the transmit policy
+    uint32_t tx_cca_busy;           // Clear channel assessments that found the channel busy
+    uint32_t tx_no_ack;             // Attempts that got no ACK
+    uint32_t tx_frames_failed;      // Queued frames given up on, whatever the reason
+} ieee802154_transceiver_stats_t;
+
+// Task not pinned to a core
+#define IEEE802154_TRANSCEIVER_NO_AFFINITY (-1)
+
+/**
+ * @brief Creation parameters of one of the transceiver's tasks.
+ */
+typedef struct {
+    uint32_t stack_size; // Bytes
+    uint8_t priority;    // FreeRTOS priority
+    int core_id;         // Core to pin the task to, or IEEE802154_TRANSCEIVER_NO_AFFINITY
+} ieee802154_transceiver_task_config_t;
+
+// Leave the radio's transmit power at its default
+#define IEEE802154_TRANSCEIVER_TX_POWER_KEEP INT8_MIN
+
+/**
+ * @brief Caller-provided memory for a heap-free transceiver.
+ *
+ * The receive rings, the transmit queue and the task stacks and control blocks
+ * are laid out in this buffer instead of being allocated, so initialization
+ * takes nothing from the heap. ieee802154_transceiver_get_storage_size() gives
+ * the size a configuration needs. The buffer must stay untouched until
+ * ieee802154_transceiver_deinit() returns.
+ */
+typedef struct {
+    void *buffer; // Aligned to 8 bytes
+    size_t size;  // Bytes
+} ieee802154_transceiver_storage_t;
+
+/**
+ * @brief Radio identity, used by its address filter and automatic acknowledgments.
+ *
+ * Out of promiscuous mode the radio only passes frames addressed to its PAN
+ * (or the broadcast PAN) and to its short or extended address (or broadcast),
+ * and acknowledges those requesting it in hardware; foreign traffic is dropped
+ * before it reaches ieee802154_transceiver_handle_receive_done(). Acknowledgments
+ * set the frame pending bit according to pending_mode and the addresses given
+ * to ieee802154_transceiver_set_pending().
+ */
+typedef struct {
+    uint16_t pan_id;                            // PAN ID, 0xffff when not associated
+    uint16_t short_addr;                        // Short address, 0xfffe for none
+    uint8_t ext_addr[8];                        // Extended address, over-the-air (little-endian) byte order
+    esp_ieee802154_pending_mode_t pending_mode; // How acknowledgments set the frame pending bit
+} ieee802154_transceiver_address_t;
+
+/**
+ * @brief Transceiver configuration.
+ *
+ * Received frames are handed from the receive ISR to the receive task, which
+ * parses them and calls the receive callbacks. With pipelined set, that work is
+ * split: the receive task only copies and parses frames and passes them through
+ * a lock-free queue to a dispatch task, which calls the callbacks. Pinning the
+ * two tasks to different cores lets parsing keep up while a slow callback runs.
+ */
+typedef struct {
+    uint8_t channel;                                    // Receive channel (11-26)
+    ieee802154_transceiver_task_config_t rx_task;       // Receive task (parse stage when pipelined)
+    ieee802154_transceiver_task_config_t tx_task;       // Asynchronous transmit task
+    bool pipelined;                                     // Run the receive callbacks in a separate dispatch task
+    ieee802154_transceiver_task_config_t dispatch_task; // Dispatch task, when pipelined
+    uint32_t rx_queue_depth;     // Receive ring slots (2-256), 0 for CONFIG_IEEE802154_TRANSCEIVER_RX_QUEUE_DEPTH
+    uint32_t tx_queue_depth;     // Transmit queue entries (1-64), 0 for CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH
+    bool promiscuous;            // Receive every frame, regardless of its destination
+    bool coordinator;            // Act as PAN coordinator
+    bool rx_when_idle;           // Keep receiving between transmissions
+    int8_t tx_power;             // Transmit power in dBm, or IEEE802154_TRANSCEIVER_TX_POWER_KEEP
+    ieee802154_transceiver_tx_policy_t tx_policy;    // Channel access and retries of queued frames
+    bool tx_sync_wait;           // Synchronous transmissions wait for their outcome (see ieee802154_transceiver_transmit())
+    const ieee802154_transceiver_address_t *address; // Radio identity, or NULL to keep the radio's
+    const ieee802154_transceiver_storage_t *storage; // Static storage, or NULL to allocate from the heap
+} ieee802154_transceiver_config_t;
+
+/**
+ * @brief Default configuration: the settings ieee802154_transceiver_init() uses.
+ */
+#define IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(ch) {                                                 \
+    .channel = (ch),                                                                                \
+    .rx_task = { .stack_size = 1024 * 5, .priority = 5, .core_id = IEEE802154_TRANSCEIVER_NO_AFFINITY }, \
+    .tx_task = { .stack_size = 1024 * 4, .priority = 5, .core_id = IEEE802154_TRANSCEIVER_NO_AFFINITY }, \
+    .pipelined = false,                                                                             \
+    .dispatch_task = { .stack_size = 1024 * 5, .priority = 5, .core_id = IEEE802154_TRANSCEIVER_NO_AFFINITY }, \
+    .rx_queue_depth = 0,                                                                            \
+    .tx_queue_depth = 0,                                                                            \
+    .promiscuous = true,                                                                            \
+    .coordinator = false,                                                                           \
+    .rx_when_idle = true,                                                                           \
+    .tx_power = IEEE802154_TRANSCEIVER_TX_POWER_KEEP,                                               \
+    .tx_policy = { 0 },                                                                             \
+    .tx_sync_wait = false,                                                                          \
+    .address = NULL,                                                                                \
+    .storage = NULL,                                                                                \
+}
+
+/**
+ * @brief Initialize the IEEE 802.15.4 transceiver with a specified channel.
+ *
+ * @param channel Channel number (11-26) to set for the transceiver.
+ * @note NVS must be initialized by the user before calling this function.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_init(uint8_t channel);
+
+/**
+ * @brief Initialize the IEEE 802.15.4 transceiver from a configuration.
+ *
+ * Start from IEEE802154_TRANSCEIVER_CONFIG_DEFAULT() and change what is needed.
+ * Core affinity is ignored on the Linux target.
+ *
+ * @param config Transceiver configuration.
+ * @note NVS must be initialized by the user before calling this function.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an invalid channel, queue depth,
+ *         task parameter or misaligned storage, ESP_ERR_INVALID_SIZE if the storage
+ *         is too small, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_init_with_config(const ieee802154_transceiver_config_t *config);
+
+/**
+ * @brief Get the static storage size a configuration needs.
+ *
+ * The size only depends on the queue depths, the task stack sizes and pipelined,
+ * so it can be measured once and reserved as a static buffer.
+ *
+ * @param config Transceiver configuration; its storage field is ignored.
+ * @param size Bytes needed out.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG for NULL arguments or an invalid configuration.
+ */
+esp_err_t ieee802154_transceiver_get_storage_size(const ieee802154_transceiver_config_t *config, size_t *size);
+
+/**
+ * @brief Deinitialize the IEEE 802.15.4 transceiver.
+ *
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_deinit(void);
+
+/**
+ * @brief Set the callback function for received frames.
+ *
+ * @param callback Callback function to invoke on frame reception.
+ * @param user_data User-defined data to pass to the callback.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_set_rx_callback(ieee802154_transceiver_rx_callback_t callback, void *user_data);
+
+/**
+ * @brief Set the callback function for batches of received frames.
+ *
+ * A batch is delivered as soon as max_batch frames are pending, or when the oldest
+ * pending frame has waited max_delay_ms, whichever comes first. The per-frame
+ * callback, if set, is still invoked for every frame of the batch.
+ *
+ * The delay is counted in FreeRTOS ticks, with max_delay_ms rounded up to whole
+ * ticks: with a 100 Hz tick, any delay from 1 to 10 ms is one tick. Since the
+ * first frame can arrive anywhere within a tick, a partial batch is held back
+ * for up to one tick period less than the rounded delay.
+ *
+ * @param callback Callback function to invoke with each batch, or NULL to disable batching.
+ * @param max_batch Maximum number of frames per batch (1 to CONFIG_IEEE802154_TRANSCEIVER_RX_BATCH_MAX, and no
+ *                  more than the rx_queue_depth given at init).
+ * @param max_delay_ms Maximum time a frame is held back waiting for the batch to fill, 0 to deliver
+ *                     pending frames at once.
+ * @param user_data User-defined data to pass to the callback.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_set_rx_batch_callback(ieee802154_transceiver_rx_batch_callback_t callback,
+                                                       size_t max_batch, uint32_t max_delay_ms,
+                                                       void *user_data);
+
+/**
+ * @brief Set the callback function for received frames, delivered without parsing.
+ *
+ * The raw callback is invoked before the parsed callbacks. When no parsed or batch
+ * callback is set, frames are not parsed at all.
+ *
+ * @param callback Callback function to invoke on frame reception, or NULL to disable.
+ * @param user_data User-defined data to pass to the callback.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_set_rx_raw_callback(ieee802154_transceiver_rx_raw_callback_t callback, void *user_data);
+
+/**
+ * @brief Get the receive counters of a channel.
+ *
+ * @param channel Channel number (11-26).
+ * @param stats Counters to fill.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG for an invalid channel.
+ */
+esp_err_t ieee802154_transceiver_get_channel_stats(uint8_t channel, ieee802154_transceiver_channel_stats_t *stats);
+
+/**
+ * @brief Get the pipeline counters.
+ *
+ * The counters are updated lock-free, from the ISRs included, so reading them
+ * never blocks the radio. With reset, each counter is read and cleared in one
+ * atomic step and no event is lost between two snapshots; the high-water marks
+ * restart from zero.
+ *
+ * @param stats Counters to fill.
+ * @param reset Clear the counters after reading them.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t ieee802154_transceiver_get_stats(ieee802154_transceiver_stats_t *stats, bool reset);
+
+/**
+ * @brief Locate the MAC header fields of a raw frame without parsing the payload.
+ *
+ * Handles the PAN ID compression rules of both IEEE 802.15.4-2006 and -2015 frames.
+ * The auxiliary security header and information elements are not skipped.
+ *
+ * @param frame Raw frame (frame[0] is the PSDU length).
+ * @param header Header view to fill.
+ * @return true if the header fits in the frame, false if it is truncated or malformed.
+ */
+bool ieee802154_transceiver_header_decode(const uint8_t *frame, ieee802154_transceiver_header_t *header);
+
+/**
+ * @brief Frame type (IEEE802154_FRAME_TYPE_*) of a decoded header.
+ */
+static inline uint8_t ieee802154_transceiver_header_frame_type(const ieee802154_transceiver_header_t *header) {
+    return header->fcf & 0x07;
+}
+
+/**
+ * @brief Sequence number of a decoded header.
+ *
+ * @return true if the frame carries a sequence number.
+ */
+static inline bool ieee802154_transceiver_header_seq(const ieee802154_transceiver_header_t *header, uint8_t *seq) {
+    if (!header->seq_offset) {
+        return false;
+    }
+    *seq = header->frame[header->seq_offset];
+    return true;
+}
+
+/**
+ * @brief Destination PAN ID of a decoded header.
+ *
+ * @return true if the frame carries a destination PAN ID.
+ */
+static inline bool ieee802154_transceiver_header_dest_pan(const ieee802154_transceiver_header_t *header, uint16_t *pan_id) {
+    if (!header->dest_pan_offset) {
+        return false;
+    }
+    *pan_id = header->frame[header->dest_pan_offset] | (header->frame[header->dest_pan_offset + 1] << 8);
+    return true;
+}
+
+/**
+ * @brief Source PAN ID of a decoded header.
+ *
+ * @return true if the frame carries a source PAN ID.
+ */
+static inline bool ieee802154_transceiver_header_src_pan(const ieee802154_transceiver_header_t *header, uint16_t *pan_id) {
+    if (!header->src_pan_offset) {
+        return false;
+    }
+    *pan_id = header->frame[header->src_pan_offset] | (header->frame[header->src_pan_offset + 1] << 8);
+    return true;
+}
+
+/**
+ * @brief Destination address of a decoded header, in over-the-air (little-endian) byte order.
+ *
+ * @return Pointer into the raw frame, or NULL if absent. The length is header->dest_addr_len.
+ */
+static inline const uint8_t *ieee802154_transceiver_header_dest_addr(const ieee802154_transceiver_header_t *header) {
+    return header->dest_addr_offset ? &header->frame[header->dest_addr_offset] : NULL;
+}
+
+/**
+ * @brief Source address of a decoded header, in over-the-air (little-endian) byte order.
+ *
+ * @return Pointer into the raw frame, or NULL if absent. The length is header->src_addr_len.
+ */
+static inline const uint8_t *ieee802154_transceiver_header_src_addr(const ieee802154_transceiver_header_t *header) {
+    return header->src_addr_offset ? &header->frame[header->src_addr_offset] : NULL;
+}
+
+/**
+ * @brief Command identifier of a decoded MAC command frame.
+ *
+ * @return true if the frame is an unsecured MAC command frame without information
+ *         elements, so that its first payload byte is the command identifier.
+ */
+static inline bool ieee802154_transceiver_header_command_id(const ieee802154_transceiver_header_t *header, uint8_t *command_id) {
+    if (ieee802154_transceiver_header_frame_type(header) != 3 || // MAC command
+        (header->fcf & (1 << 3)) ||                              // Security enabled
+        (header->fcf & (1 << 9)) ||                              // IE present
+        header->payload_offset + 2 > header->frame[0]) {         // No payload before the FCS
+        return false;
+    }
+    *command_id = header->frame[header->payload_offset];
+    return true;
+}
+
+/**
+ * @brief Overwrite selected MAC header fields of a raw frame in place.
+ *
+ * Only the selected bytes are written; the frame is neither parsed nor rebuilt.
+ * Fields the frame does not carry (suppressed sequence number, absent or
+ * compressed PAN ID) are left alone. The FCS is not updated: the radio
+ * computes it on transmission.
+ *
+ * @param frame Raw frame (frame[0] is the PSDU length).
+ * @param rewrite Fields to write.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if the header cannot be decoded.
+ */
+esp_err_t ieee802154_transceiver_rewrite(uint8_t *frame, const ieee802154_transceiver_rewrite_t *rewrite);
+
+/**
+ * @brief Add an entry to the receive filter table.
+ *
+ * The table is evaluated in the receive ISR before a frame is queued. With an
+ * empty table every frame is accepted; otherwise a frame is accepted if it matches
+ * at least one entry, and all others are released immediately.
+ *
+ * @param filter Filter entry to add (copied).
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the table
+ *         (CONFIG_IEEE802154_TRANSCEIVER_FILTER_MAX entries) is full,
+ *         or ESP_ERR_INVALID_ARG for a malformed entry.
+ */
+esp_err_t ieee802154_transceiver_add_filter(const ieee802154_transceiver_filter_t *filter);
+
+/**
+ * @brief Remove every entry from the receive filter table, accepting all frames again.
+ *
+ * @return ESP_OK on success.
+ */
+esp_err_t ieee802154_transceiver_clear_filters(void);
+
+/**
+ * @brief Enable or disable duplicate frame suppression.
+ *
+ * When enabled, the receive task drops a frame if one with the same frame type,
+ * source PAN, source address and sequence number was received less than
+ * expiry_ms earlier, before any hook, subscriber or callback sees it. Frames
+ * without a source address or sequence number (acknowledgments) always pass.
+ * The cache holds CONFIG_IEEE802154_TRANSCEIVER_DEDUPE_SIZE frames.
+ *
+ * @param expiry_ms How long a frame is remembered, 0 to disable. Keep it below
+ *        the time a sender takes to reuse a sequence number.
+ * @return ESP_OK.
+ */
+esp_err_t ieee802154_transceiver_set_dedupe(uint32_t expiry_ms);
+
+/**
+ * @brief Register a receive callback for the frames matching a filter.
+ *
+ * Subscribers are called from the receive task with the raw frame, after the
+ * receive filter table has accepted it and before the other receive callbacks.
+ * Each subscriber only runs on frames matching its filter: the receive task
+ * looks the frame's type, destination PAN, destination address and command ID
+ * up in an index of the subscribed filters instead of trying every subscriber.
+ *
+ * @param filter Frames to deliver (copied), or NULL for every frame.
+ * @param callback Callback function to invoke on matching frames.
+ * @param user_data User-defined data to pass to the callback.
+ * @param subscriber_id Identifier for ieee802154_transceiver_unsubscribe(), or NULL.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a missing callback or a malformed
+ *         filter, or ESP_ERR_NO_MEM if CONFIG_IEEE802154_TRANSCEIVER_SUBSCRIBER_MAX
+ *         subscribers are registered.
+ */
+esp_err_t ieee802154_transceiver_subscribe(const ieee802154_transceiver_filter_t *filter,
+                                           ieee802154_transceiver_rx_raw_callback_t callback, void *user_data,
+                                           int *subscriber_id);
+
+/**
+ * @brief Remove a subscriber.
+ *
+ * A delivery already in progress on the receive task completes. Calling this from
+ * a receive callback is allowed.
+ *
+ * @param subscriber_id Identifier returned by ieee802154_transceiver_subscribe().
+ * @return ESP_OK on success, or ESP_ERR_NOT_FOUND if there is no such subscriber.
+ */
+esp_err_t ieee802154_transceiver_unsubscribe(int subscriber_id);
+
+
+void ieee802154_transceiver_handle_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info);
+
+/**
+ * @brief Transmit an IEEE 802.15.4 frame on the current channel.
+ *
+ * Waits for a frame the transmit task has in flight or a survey to finish
+ * first. By default the frame is only handed to the radio and this returns at
+ * once. With tx_sync_wait set in the configuration, the radio is kept until the
+ * transmit interrupt reports the outcome, which is returned; the application
+ * must then forward esp_ieee802154_transmit_done() and
+ * esp_ieee802154_transmit_failed() to the transceiver. The same applies to the
+ * other synchronous transmit functions.
+ *
+ * @param frame Frame to transmit.
+ * @return ESP_OK on success, ESP_FAIL if the radio reported a failed transmission,
+ *         ESP_ERR_TIMEOUT if it reported nothing in time, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_transmit(const ieee802154_frame_t *frame);
+
+/**
+ * @brief Transmit an IEEE 802.15.4 frame on a specified channel.
+ *
+ * @param frame Frame to transmit.
+ * @param channel Channel number (11-26) to use for transmission.
+ * @note The channel is not restored after transmission; use ieee802154_transceiver_set_channel to restore it.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_transmit_channel(const ieee802154_frame_t *frame, uint8_t channel);
+
+/**
+ * @brief Transmit a raw frame as is, without building it.
+ *
+ * The frame is copied into the transmit buffer, so it may be reused as soon as
+ * this returns. Frames handed to a receive callback can be relayed byte for byte.
+ *
+ * @param psdu Raw frame: psdu[0] is the PSDU length (including the 2-byte FCS),
+ *             followed by the PSDU. The FCS bytes are filled in by the radio.
+ * @param channel Channel number (11-26) to use for transmission, or 0 for the current channel.
+ * @note The channel is not restored after transmission; use ieee802154_transceiver_set_channel to restore it.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_transmit_raw(const uint8_t *psdu, uint8_t channel);
+
+/**
+ * @brief Build a frame template.
+ *
+ * @param tmpl Template to fill.
+ * @param frame Frame providing the header and the initial payload.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_template_build(ieee802154_transceiver_template_t *tmpl, const ieee802154_frame_t *frame);
+
+/**
+ * @brief Set the sequence number of a frame template in place.
+ */
+static inline void ieee802154_transceiver_template_set_seq(ieee802154_transceiver_template_t *tmpl, uint8_t seq) {
+    if (tmpl->seq_offset) {
+        tmpl->frame[tmpl->seq_offset] = seq;
+    }
+}
+
+/**
+ * @brief Overwrite part of a frame template's payload in place.
+ *
+ * @param tmpl Template to patch.
+ * @param offset Offset within the payload.
+ * @param data Bytes to write.
+ * @param len Number of bytes; offset + len must not exceed the template's payload length.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if the region is out of bounds.
+ */
+esp_err_t ieee802154_transceiver_template_patch(ieee802154_transceiver_template_t *tmpl, size_t offset,
+                                                const void *data, size_t len);
+
+/**
+ * @brief Transmit a frame template on the current channel.
+ *
+ * The radio reads the template while sending; do not patch it until the
+ * transmission has completed.
+ *
+ * @param tmpl Template to transmit.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_template_transmit(const ieee802154_transceiver_template_t *tmpl);
+
+/**
+ * @brief Transmit a frame template on a specified channel.
+ *
+ * @param tmpl Template to transmit.
+ * @param channel Channel number (11-26) to use for transmission.
+ * @note The channel is not restored after transmission; use ieee802154_transceiver_set_channel to restore it.
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_template_transmit_channel(const ieee802154_transceiver_template_t *tmpl, uint8_t channel);
+
+/**
+ * @brief Queue a copy of a frame template for transmission on the current receive channel.
+ *
+ * The template may be patched again as soon as this returns.
+ *
+ * @param tmpl Template to transmit.
+ * @param done_cb Callback to invoke when the transmission completes, or NULL.
+ * @param ctx User-defined context to pass to done_cb.
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if the queue is full, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_template_transmit_async(const ieee802154_transceiver_template_t *tmpl,
+                                                         ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx);
+
+/**
+ * @brief Queue an IEEE 802.15.4 frame for transmission on the current receive channel.
+ *
+ * The frame is built into a transmit queue slot
+ * (CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH slots) and the call returns at once.
+ * Queued frames are sent back-to-back, each as soon as the previous one completes
+ * under the transmit policy (ieee802154_transceiver_set_tx_policy()), and done_cb
+ * reports the outcome of every frame. Completion is only seen when
+ * the application forwards esp_ieee802154_transmit_done and esp_ieee802154_transmit_failed
+ * to ieee802154_transceiver_handle_transmit_done() / _handle_transmit_failed().
+ *
+ * @param frame Frame to transmit.
+ * @param done_cb Callback to invoke when the transmission completes, or NULL.
+ * @param ctx User-defined context to pass to done_cb.
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if the queue is full, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_transmit_async(const ieee802154_frame_t *frame,
+                                                ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx);
+
+/**
+ * @brief Queue an IEEE 802.15.4 frame for transmission on a specified channel.
+ *
+ * Like ieee802154_transceiver_transmit_async(), but the frame is sent on channel.
+ * Consecutive frames for the same channel share a single channel switch, and the
+ * radio returns to the receive channel once the queue is empty.
+ *
+ * @param frame Frame to transmit.
+ * @param channel Channel number (11-26) to use for transmission.
+ * @param done_cb Callback to invoke when the transmission completes, or NULL.
+ * @param ctx User-defined context to pass to done_cb.
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if the queue is full, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_transmit_channel_async(const ieee802154_frame_t *frame, uint8_t channel,
+                                                        ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx);
+
+/**
+ * @brief Queue a raw frame for transmission, without building it.
+ *
+ * Like ieee802154_transceiver_transmit_channel_async(), but the bytes are copied
+ * into the transmit queue slot as they are.
+ *
+ * @param psdu Raw frame: psdu[0] is the PSDU length (including the 2-byte FCS),
+ *             followed by the PSDU.
+ * @param channel Channel number (11-26) to use for transmission, or 0 for the receive channel.
+ * @param done_cb Callback to invoke when the transmission completes, or NULL.
+ * @param ctx User-defined context to pass to done_cb.
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if the queue is full, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_transmit_raw_async(const uint8_t *psdu, uint8_t channel,
+                                                    ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx);
+
+/**
+ * @brief Change the channel access and retry policy of queued frames.
+ *
+ * Takes effect from the next frame the transmit task picks up. Synchronous
+ * transmissions only follow its cca setting: they are handed to the radio once,
+ * without backoffs or retries. Initialization sets the policy from the
+ * configuration.
+ *
+ * @param policy New policy (copied).
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG for NULL or out-of-range settings.
+ */
+esp_err_t ieee802154_transceiver_set_tx_policy(const ieee802154_transceiver_tx_policy_t *policy);
+
+/**
+ * @brief Get the channel access and retry policy of queued frames.
+ *
+ * @param policy Policy out.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if policy is NULL.
+ */
+esp_err_t ieee802154_transceiver_get_tx_policy(ieee802154_transceiver_tx_policy_t *policy);
+
+/**
+ * @brief Handle the callback for successfully transmitted IEEE 802.15.4 frames.
+ *
+ * Call from esp_ieee802154_transmit_done. The ACK frame, if any, is released.
+ */
+void ieee802154_transceiver_handle_transmit_done(const uint8_t *frame, const uint8_t *ack,
+                                                 esp_ieee802154_frame_info_t *ack_frame_info);
+
+/**
+ * @brief Handle the callback for failed IEEE 802.15.4 transmissions.
+ *
+ * Call from esp_ieee802154_transmit_failed.
+ */
+void ieee802154_transceiver_handle_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error);
+
+/**
+ * @brief Set the IEEE 802.15.4 channel.
+ *
+ * @param channel Channel number (11-26).
+ * @return ESP_OK on success, or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_set_channel(uint8_t channel);
+
+/**
+ * @brief Change the radio identity, e.g. once associated.
+ *
+ * @param address New identity (copied).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if address is NULL,
+ *         ESP_ERR_INVALID_STATE if not initialized, or an error code from the radio.
+ */
+esp_err_t ieee802154_transceiver_set_address(const ieee802154_transceiver_address_t *address);
+
+/**
+ * @brief Mark a neighbor as having frames pending, or clear it.
+ *
+ * Acknowledgments to the neighbor's frames then set the frame pending bit, as
+ * the pending mode of ieee802154_transceiver_address_t prescribes, so a
+ * sleepy end device stays awake to poll for them.
+ *
+ * @param addr Address, over-the-air (little-endian) byte order.
+ * @param addr_len 2 (short) or 8 (extended).
+ * @param pending Whether frames are pending for the neighbor.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for bad arguments,
+ *         ESP_ERR_INVALID_STATE if not initialized, or ESP_ERR_NO_MEM if the radio's table is full.
+ */
+esp_err_t ieee802154_transceiver_set_pending(const uint8_t *addr, uint8_t addr_len, bool pending);
+
+/**
+ * @brief Clear the pending marks of every neighbor.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not initialized.
+ */
+esp_err_t ieee802154_transceiver_clear_pending(void);
+
 #endif // IEEE802154_TRANSCEIVER_H
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef IEEE802154_TRANSCEIVER_BRIDGE_H
+#define IEEE802154_TRANSCEIVER_BRIDGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#include "ieee802154_transceiver.h"
+
+/**
+ * @brief Bridge configuration.
+ *
+ * Frames received on src_channel are queued and re-sent on dst_channel by the
+ * transmit task. Up to max_batch frames are sent per channel switch; the first
+ * frame of a batch waits at most max_hold_ms for the others. The transceiver
+ * returns to src_channel once the batch is out.
+ *
+ * Frames are relayed byte for byte: they are never parsed or rebuilt, and only
+ * the header fields selected in rewrite are patched in place. With max_batch
+ * set to 1 the receive task hands each frame straight to the transmit queue.
+ */
+typedef struct {
+    uint8_t src_channel;                             // Channel to listen on (11-26)
+    uint8_t dst_channel;                             // Channel to forward to (11-26)
+    const ieee802154_transceiver_filter_t *filter;   // Frames to forward (copied), NULL for all
+    uint8_t max_batch;                               // Frames per channel switch, 1 to the smaller of the Kconfig and init transmit queue depths
+    uint32_t max_hold_ms;                            // Longest time a frame waits for a batch to fill
+    const ieee802154_transceiver_rewrite_t *rewrite; // Header fields to patch (copied), NULL to relay as is
+} ieee802154_transceiver_bridge_config_t;
+
+/**
+ * @brief Bridge statistics.
+ *
+ * Latency runs from the receive ISR on src_channel to the transmit-done
+ * interrupt on dst_channel, and is only sampled for forwarded frames.
+ */
+typedef struct {
+    uint32_t forwarded;         // Frames sent on dst_channel
+    uint32_t dropped;           // Frames lost because the bridge or transmit queue was full
+    uint32_t tx_failed;         // Frames the radio failed to send
+    uint32_t batches;           // Channel switches to dst_channel
+    uint32_t latency_avg_us;    // Average relay latency
+    uint32_t latency_max_us;    // Worst relay latency
+    uint32_t latency_samples;   // Frames contributing to the latency figures
+} ieee802154_transceiver_bridge_stats_t;
+
+/**
+ * @brief Start forwarding frames from one channel to another.
+ *
+ * The transceiver must be initialized. The receive channel is set to src_channel;
+ * the usual receive callbacks still see every frame.
+ *
+ * @param config Bridge configuration (copied).
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already bridging,
+ *         or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_bridge_start(const ieee802154_transceiver_bridge_config_t *config);
+
+/**
+ * @brief Stop forwarding. Frames already handed to the transmit queue are still sent.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not bridging.
+ */
+esp_err_t ieee802154_transceiver_bridge_stop(void);
+
+/**
+ * @brief Get the bridge statistics.
+ *
+ * @param stats Statistics to fill.
+ * @param reset Clear the counters after reading them.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t ieee802154_transceiver_bridge_get_stats(ieee802154_transceiver_bridge_stats_t *stats, bool reset);
+
+#endif // IEEE802154_TRANSCEIVER_BRIDGE_H
@@ -0,0 +1,109 @@
+#ifndef IEEE802154_TRANSCEIVER_CAPTURE_H
+#define IEEE802154_TRANSCEIVER_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * @brief Capture ring configuration.
+ *
+ * Every received frame is appended to a fixed-size ring as a compact record
+ * (raw PSDU, channel, RSSI, LQI and a delta timestamp), evicting the oldest
+ * records, so the ring always holds the most recent traffic. On a trigger,
+ * recording goes on for post_trigger_ms and then the ring freezes; a frozen
+ * ring can be read out with ieee802154_transceiver_capture_get_image() or
+ * written to a flash partition, and decoded with tools/capture_to_pcap.py.
+ */
+typedef struct {
+    size_t size;                // Image bytes, header included, 0 for 64 KiB (at least 1024)
+    bool use_psram;             // Allocate the ring from PSRAM
+    uint32_t post_trigger_ms;   // Recording time after a trigger before freezing, 0 to freeze at once
+    const char *partition_label; // Data partition for ieee802154_transceiver_capture_save(), or NULL
+} ieee802154_transceiver_capture_config_t;
+
+/**
+ * @brief Capture ring statistics.
+ */
+typedef struct {
+    uint32_t frames;   // Frames appended
+    uint32_t evicted;  // Oldest records dropped to make room
+    uint32_t ignored;  // Frames received while frozen
+    uint32_t records;  // Records in the ring
+    uint32_t used;     // Data bytes in use
+    bool triggered;    // A trigger is pending or has frozen the ring
+    bool frozen;       // Recording has stopped
+} ieee802154_transceiver_capture_stats_t;
+
+/**
+ * @brief Start recording received frames into an empty capture ring.
+ *
+ * @param config Ring configuration (copied).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad configuration,
+ *         ESP_ERR_INVALID_STATE if already started, or ESP_ERR_NO_MEM.
+ */
+esp_err_t ieee802154_transceiver_capture_start(const ieee802154_transceiver_capture_config_t *config);
+
+/**
+ * @brief Stop recording and release the ring.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_capture_stop(void);
+
+/**
+ * @brief Mark an incident: keep recording for post_trigger_ms, then freeze.
+ *
+ * Further triggers are ignored until ieee802154_transceiver_capture_resume().
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_capture_trigger(void);
+
+/**
+ * @brief Freeze the ring now.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_capture_freeze(void);
+
+/**
+ * @brief Clear any trigger and go on recording; the ring keeps its records.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_capture_resume(void);
+
+/**
+ * @brief Get the ring image of a frozen ring.
+ *
+ * The image stays valid and unchanged until the ring is resumed or stopped.
+ *
+ * @param image Image start out.
+ * @param len Image length out.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for NULL arguments,
+ *         or ESP_ERR_INVALID_STATE if not started or not frozen.
+ */
+esp_err_t ieee802154_transceiver_capture_get_image(const uint8_t **image, size_t *len);
+
+/**
+ * @brief Write the image of a frozen ring to the configured flash partition.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not started or not frozen,
+ *         ESP_ERR_NOT_FOUND if there is no such data partition, ESP_ERR_INVALID_SIZE
+ *         if the image does not fit, ESP_ERR_NOT_SUPPORTED on the host build,
+ *         or the flash error.
+ */
+esp_err_t ieee802154_transceiver_capture_save(void);
+
+/**
+ * @brief Get the capture ring statistics.
+ *
+ * @param stats Statistics to fill.
+ * @param reset Clear the frame counters after reading them.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t ieee802154_transceiver_capture_get_stats(ieee802154_transceiver_capture_stats_t *stats, bool reset);
+
+#endif // IEEE802154_TRANSCEIVER_CAPTURE_H
@@ -0,0 +1,160 @@
+#ifndef IEEE802154_TRANSCEIVER_FRAG_H
+#define IEEE802154_TRANSCEIVER_FRAG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "ieee802154_frame.h"
+
+/*
+ * Fragment layout.
+ *
+ * A datagram is cut into data frames whose payload starts with an 8-byte
+ * fragment header, followed by the fragment's bytes:
+ *
+ *   dispatch (1) | chunk (1) | tag (2) | datagram size (2) | fragment index (2)
+ *
+ * Multi-byte fields are little-endian. The dispatch byte is in the 6LoWPAN
+ * "not a LoWPAN frame" range, so 6LoWPAN stacks ignore fragments. Every
+ * fragment but the last carries chunk bytes, the fragment at index i starting
+ * at byte i * chunk of the datagram. The tag tells apart the datagrams of one
+ * sender.
+ */
+#define IEEE802154_TRANSCEIVER_FRAG_DISPATCH 0x3c
+#define IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN 8
+
+/**
+ * @brief One piece of a datagram to send; the pieces are sent in order as one datagram.
+ */
+typedef struct {
+    const void *data;
+    size_t len;
+} ieee802154_transceiver_frag_iov_t;
+
+/**
+ * @brief Outcome of a fragmented transmission.
+ */
+typedef struct {
+    uint16_t tag;         // Tag of the datagram
+    uint16_t fragments;   // Fragments in the datagram
+    uint16_t sent;        // Fragments the radio reported as sent
+    uint16_t retries;     // Retries of the transmit policy over all fragments
+    uint32_t duration_us; // From the first fragment queued to the last one reported
+} ieee802154_transceiver_frag_send_result_t;
+
+/**
+ * @brief Sender of a reassembled datagram.
+ */
+typedef struct {
+    uint8_t addr[8];      // Source address, over-the-air (little-endian) byte order
+    uint8_t addr_len;     // 2 (short) or 8 (extended)
+    uint16_t pan_id;      // Source PAN of a short address, 0xffff for an extended one
+    uint16_t tag;         // Tag of the datagram
+    uint16_t fragments;   // Fragments it was received in
+    uint32_t duration_us; // From the first fragment received to the last
+} ieee802154_transceiver_frag_source_t;
+
+/**
+ * @brief Callback for reassembled datagrams, called from the receive task.
+ *
+ * @param data Datagram, valid during the call.
+ * @param len Datagram bytes.
+ * @param source Sender and tag of the datagram.
+ * @param ctx Context given to ieee802154_transceiver_frag_rx_start().
+ */
+typedef void (*ieee802154_transceiver_frag_rx_callback_t)(const uint8_t *data, size_t len,
+                                                          const ieee802154_transceiver_frag_source_t *source,
+                                                          void *ctx);
+
+/**
+ * @brief Reassembly configuration.
+ *
+ * The receive task reassembles up to slots datagrams at once, each in a buffer
+ * of max_size bytes allocated at start. Fragments may arrive in any order and
+ * more than once. A datagram that has received no fragment for timeout_ms is
+ * dropped when the next fragment arrives; so is a new datagram while every
+ * slot is busy.
+ */
+typedef struct {
+    uint8_t slots;       // Datagrams reassembled at once (1-16), 0 for 4
+    uint16_t max_size;   // Largest datagram accepted (bytes), 0 for 4096
+    uint32_t timeout_ms; // Time allowed between two fragments of a datagram, 0 for 1000
+    ieee802154_transceiver_frag_rx_callback_t callback;
+    void *ctx;
+} ieee802154_transceiver_frag_rx_config_t;
+
+/**
+ * @brief Fragmentation statistics.
+ */
+typedef struct {
+    uint32_t tx_datagrams;     // Datagrams sent whole
+    uint32_t tx_fragments;     // Fragments the radio reported as sent
+    uint32_t tx_failed;        // Datagrams that lost a fragment
+    uint32_t rx_fragments;     // Fragments stored
+    uint32_t rx_datagrams;     // Datagrams reassembled and delivered
+    uint32_t rx_duplicates;    // Fragments received again
+    uint32_t rx_invalid;       // Fragments with an inconsistent header or length
+    uint32_t rx_too_large;     // Fragments of datagrams larger than max_size
+    uint32_t rx_no_slot;       // Fragments of new datagrams dropped because every slot was busy
+    uint32_t rx_timeouts;      // Incomplete datagrams dropped after the timeout
+} ieee802154_transceiver_frag_stats_t;
+
+/**
+ * @brief Send a datagram gathered from several pieces, cut into fragments.
+ *
+ * Fragments are built one at a time from the pieces straight into transmit
+ * queue slots, without a contiguous copy of the datagram, and queued
+ * back-to-back as fast as the transmit task frees slots, so the radio sends
+ * them without gaps. Each fragment goes out under the transmit policy
+ * (ieee802154_transceiver_set_tx_policy()). Blocks until every fragment has
+ * been reported; the pieces only need to stay valid during the call. Sending
+ * stops at the first fragment that fails.
+ *
+ * @param frame MAC header of the fragments: frame type, addressing and ackRequest.
+ *              The sequence number of the first fragment, incremented for each
+ *              next one; the payload is ignored.
+ * @param iov Pieces of the datagram.
+ * @param iov_count Number of pieces.
+ * @param channel Channel number (11-26) to send on, or 0 for the receive channel.
+ * @param result Outcome out, or NULL.
+ * @return ESP_OK if every fragment was sent, ESP_ERR_INVALID_ARG for bad arguments,
+ *         ESP_ERR_INVALID_SIZE if the datagram is empty or over 65535 bytes, or the
+ *         header leaves too little room for a fragment, ESP_ERR_INVALID_STATE if the
+ *         transceiver is not initialized, ESP_FAIL if a fragment failed, or
+ *         ESP_ERR_TIMEOUT if the transmit task stopped reporting.
+ */
+esp_err_t ieee802154_transceiver_frag_send(const ieee802154_frame_t *frame, const ieee802154_transceiver_frag_iov_t *iov,
+                                           size_t iov_count, uint8_t channel,
+                                           ieee802154_transceiver_frag_send_result_t *result);
+
+/**
+ * @brief Start reassembling the fragments heard by the receive task.
+ *
+ * Fragments still reach the other receive callbacks.
+ *
+ * @param config Reassembly configuration; callback is required.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad configuration,
+ *         ESP_ERR_INVALID_STATE if already started, or ESP_ERR_NO_MEM.
+ */
+esp_err_t ieee802154_transceiver_frag_rx_start(const ieee802154_transceiver_frag_rx_config_t *config);
+
+/**
+ * @brief Stop reassembling and release the buffers; incomplete datagrams are dropped.
+ *
+ * Waits for a running datagram callback to return, so it must not be called from one.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_frag_rx_stop(void);
+
+/**
+ * @brief Get the fragmentation statistics.
+ *
+ * @param stats Statistics to fill.
+ * @param reset Clear the counters after reading them.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t ieee802154_transceiver_frag_get_stats(ieee802154_transceiver_frag_stats_t *stats, bool reset);
+
+#endif // IEEE802154_TRANSCEIVER_FRAG_H
@@ -0,0 +1,65 @@
+#ifndef IEEE802154_TRANSCEIVER_HOP_H
+#define IEEE802154_TRANSCEIVER_HOP_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Channel mask with every 2.4 GHz channel (11-26); bit n selects channel n
+#define IEEE802154_TRANSCEIVER_HOP_ALL_CHANNELS 0x07FFF800
+
+/**
+ * @brief Channel hopping configuration.
+ *
+ * Each channel of the mask is visited in turn for dwell_ms. With adaptive
+ * dwell (max_dwell_ms > dwell_ms), the scheduler stays extend_ms longer
+ * whenever traffic was heard during the last window, up to max_dwell_ms.
+ * A channel is therefore revisited at least every sum of max_dwell_ms over
+ * the other channels of the mask.
+ */
+typedef struct {
+    uint32_t channel_mask; // Channels to visit, e.g. IEEE802154_TRANSCEIVER_HOP_ALL_CHANNELS
+    uint32_t dwell_ms;     // Base time spent on each channel
+    uint32_t max_dwell_ms; // Upper bound with adaptive dwell, 0 to disable adaptation
+    uint32_t extend_ms;    // Extension granted per window with traffic
+} ieee802154_transceiver_hop_config_t;
+
+/**
+ * @brief Per-channel hopping statistics since ieee802154_transceiver_hop_start().
+ */
+typedef struct {
+    uint32_t frames;   // Frames heard on the channel
+    uint32_t bytes;    // PSDU bytes heard on the channel
+    uint32_t drops;    // Frames lost because the receive queue was full
+    uint32_t visits;   // Number of times the scheduler switched to the channel
+    uint32_t dwell_ms; // Total time spent on the channel
+} ieee802154_transceiver_hop_stats_t;
+
+/**
+ * @brief Start cycling through a set of channels.
+ *
+ * The transceiver must be initialized. Received frames are delivered through the
+ * usual receive callbacks; frame_info->channel tells which channel they came from.
+ *
+ * @param config Hopping configuration (copied).
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already hopping,
+ *         or an error code on failure.
+ */
+esp_err_t ieee802154_transceiver_hop_start(const ieee802154_transceiver_hop_config_t *config);
+
+/**
+ * @brief Stop hopping and stay on the current channel.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not hopping.
+ */
+esp_err_t ieee802154_transceiver_hop_stop(void);
+
+/**
+ * @brief Get the hopping statistics of a channel.
+ *
+ * @param channel Channel number (11-26).
+ * @param stats Statistics to fill.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG for an invalid channel.
+ */
+esp_err_t ieee802154_transceiver_hop_get_stats(uint8_t channel, ieee802154_transceiver_hop_stats_t *stats);
+
+#endif // IEEE802154_TRANSCEIVER_HOP_H
@@ -0,0 +1,110 @@
+#ifndef IEEE802154_TRANSCEIVER_NEIGHBOR_H
+#define IEEE802154_TRANSCEIVER_NEIGHBOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * @brief Neighbor table configuration.
+ *
+ * The receive task keeps one entry per source address heard, with moving
+ * averages of RSSI and LQI, the time it was last heard and an estimate of the
+ * frames missed from gaps in its sequence numbers. When the table is full, the
+ * neighbor heard least recently is evicted.
+ */
+typedef struct {
+    uint16_t capacity;  // Neighbors kept, 0 for 32
+    uint8_t ewma_shift; // Averaging weight of a new sample is 1 / 2^ewma_shift (1-7), 0 for 3 (1/8)
+} ieee802154_transceiver_neighbor_config_t;
+
+/**
+ * @brief Link metrics of one neighbor.
+ *
+ * A short address is only unique within its PAN, so short-addressed neighbors
+ * are told apart by pan_id as well; it is 0xffff for extended addresses.
+ */
+typedef struct {
+    uint8_t addr[8];       // Source address, over-the-air (little-endian) byte order
+    uint8_t addr_len;      // 2 (short) or 8 (extended)
+    uint16_t pan_id;       // Source PAN of a short address, 0xffff for an extended one
+    int8_t rssi_avg;       // Moving average, dBm
+    int8_t rssi_last;      // Last frame, dBm
+    uint8_t lqi_avg;       // Moving average
+    uint8_t lqi_last;      // Last frame
+    int64_t last_seen_us;  // Receive time of the last frame (esp_timer_get_time() clock)
+    uint32_t frames;       // Frames heard
+    uint32_t lost;         // Frames estimated missed from sequence number gaps
+    uint32_t repeated;     // Frames repeating the previous sequence number (retransmissions)
+} ieee802154_transceiver_neighbor_t;
+
+/**
+ * @brief Neighbor table statistics.
+ */
+typedef struct {
+    uint32_t neighbors; // Entries in use
+    uint32_t updates;   // Frames accounted to a neighbor
+    uint32_t evicted;   // Least recently heard neighbors dropped to make room
+    uint32_t ignored;   // Frames without a source address
+} ieee802154_transceiver_neighbor_stats_t;
+
+/**
+ * @brief Start tracking the neighbors heard by the receive task, with an empty table.
+ *
+ * @param config Table configuration, or NULL for the defaults.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad configuration,
+ *         ESP_ERR_INVALID_STATE if already started, or ESP_ERR_NO_MEM.
+ */
+esp_err_t ieee802154_transceiver_neighbor_start(const ieee802154_transceiver_neighbor_config_t *config);
+
+/**
+ * @brief Stop tracking neighbors and release the table.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_neighbor_stop(void);
+
+/**
+ * @brief Look a neighbor up by address, in constant time.
+ *
+ * @param addr Address, over-the-air (little-endian) byte order.
+ * @param addr_len 2 (short) or 8 (extended).
+ * @param pan_id PAN of a short address; ignored for an extended one.
+ * @param neighbor Metrics out.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for bad arguments,
+ *         ESP_ERR_NOT_FOUND if the neighbor is not in the table,
+ *         or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_neighbor_get(const uint8_t *addr, uint8_t addr_len, uint16_t pan_id,
+                                              ieee802154_transceiver_neighbor_t *neighbor);
+
+/**
+ * @brief Copy the neighbors out, most recently heard first.
+ *
+ * @param neighbors Array to fill.
+ * @param max Entries in the array.
+ * @param count Entries filled out.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for NULL arguments,
+ *         or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_neighbor_list(ieee802154_transceiver_neighbor_t *neighbors, size_t max,
+                                               size_t *count);
+
+/**
+ * @brief Empty the table; statistics are kept.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not started.
+ */
+esp_err_t ieee802154_transceiver_neighbor_clear(void);
+
+/**
+ * @brief Get the neighbor table statistics.
+ *
+ * @param stats Statistics to fill.
+ * @param reset Clear the counters after reading them.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t ieee802154_transceiver_neighbor_get_stats(ieee802154_transceiver_neighbor_stats_t *stats, bool reset);
+
+#endif // IEEE802154_TRANSCEIVER_NEIGHBOR_H
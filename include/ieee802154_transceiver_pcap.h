@@ -0,0 +1,88 @@
+#ifndef IEEE802154_TRANSCEIVER_PCAP_H
+#define IEEE802154_TRANSCEIVER_PCAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_ieee802154.h"
+
+/**
+ * @brief Output function for capture blocks, e.g. a UART or USB-CDC write.
+ *
+ * Called from the capture task with consecutive pieces of one pcapng stream.
+ * It may block: frames keep being recorded into the other block meanwhile.
+ *
+ * @param data Bytes to send, valid until the function returns.
+ * @param len Number of bytes.
+ * @param ctx Context given in the configuration.
+ */
+typedef void (*ieee802154_transceiver_pcap_output_t)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * @brief Capture sink configuration.
+ *
+ * Recorded frames are encoded as pcapng (LINKTYPE_IEEE802_15_4_TAP, with RSS,
+ * LQI, channel and timestamp TLVs) into one of two DMA-capable blocks. When a
+ * block fills up, or its first frame has waited flush_ms, it is handed to the
+ * output function while recording continues into the other block.
+ */
+typedef struct {
+    ieee802154_transceiver_pcap_output_t output; // Stream output
+    void *ctx;                                   // Passed to output
+    size_t block_size;                           // Bytes per block, 0 for 4096 (at least 256)
+    uint32_t flush_ms;                           // Longest time a frame waits in a block, 0 for 100 ms
+} ieee802154_transceiver_pcap_config_t;
+
+/**
+ * @brief Capture sink statistics.
+ */
+typedef struct {
+    uint32_t frames;  // Frames recorded
+    uint32_t bytes;   // Bytes handed to the output, headers included
+    uint32_t blocks;  // Calls to the output
+    uint32_t dropped; // Frames lost because both blocks were full
+} ieee802154_transceiver_pcap_stats_t;
+
+/**
+ * @brief Start a capture stream.
+ *
+ * The pcapng section and interface headers are sent first. Frames are added with
+ * ieee802154_transceiver_pcap_record(), typically from a raw receive callback.
+ *
+ * @param config Sink configuration (copied).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad configuration,
+ *         ESP_ERR_INVALID_STATE if already capturing, or ESP_ERR_NO_MEM.
+ */
+esp_err_t ieee802154_transceiver_pcap_start(const ieee802154_transceiver_pcap_config_t *config);
+
+/**
+ * @brief Stop the capture stream after sending everything recorded so far.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_STATE if not capturing.
+ */
+esp_err_t ieee802154_transceiver_pcap_stop(void);
+
+/**
+ * @brief Add a received frame to the capture stream.
+ *
+ * Encoding is a copy into the current block; the output function is never called
+ * from here, so this is safe from receive callbacks.
+ *
+ * @param frame Raw frame (frame[0] is the PSDU length, including the 2-byte FCS).
+ * @param frame_info Channel, RSSI, LQI and timestamp of the frame.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not capturing,
+ *         ESP_ERR_INVALID_ARG for a bad frame, or ESP_ERR_NO_MEM if both blocks are full.
+ */
+esp_err_t ieee802154_transceiver_pcap_record(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info);
+
+/**
+ * @brief Get the capture statistics.
+ *
+ * @param stats Statistics to fill.
+ * @param reset Clear the counters after reading them.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t ieee802154_transceiver_pcap_get_stats(ieee802154_transceiver_pcap_stats_t *stats, bool reset);
+
+#endif // IEEE802154_TRANSCEIVER_PCAP_H
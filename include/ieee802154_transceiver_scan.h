@@ -0,0 +1,87 @@
+#ifndef IEEE802154_TRANSCEIVER_SCAN_H
+#define IEEE802154_TRANSCEIVER_SCAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/**
+ * @brief Energy survey configuration.
+ *
+ * Each channel of the mask is measured samples times with the radio's energy
+ * detection, back to back, then optionally listened to for listen_ms to count
+ * the frames on it. With the defaults a measurement takes 128 us, so all 16
+ * channels are surveyed in about 10 ms.
+ */
+typedef struct {
+    uint32_t channel_mask;   // Channels to survey, bit n for channel n, 0 for all (11-26)
+    uint8_t samples;         // Measurements per channel (1-32), 0 for 4
+    uint16_t sample_symbols; // Length of a measurement in 16 us symbols, 0 for 8 (128 us)
+    uint16_t listen_ms;      // Time spent receiving on each channel after measuring, 0 for none
+} ieee802154_transceiver_scan_config_t;
+
+/**
+ * @brief Survey result of one channel.
+ */
+typedef struct {
+    int8_t energy_max;  // Strongest measurement, dBm
+    int8_t energy_mean; // Mean of the measurements, dBm
+    uint8_t samples;    // Measurements taken, 0 if the channel was not surveyed
+    uint32_t frames;    // Frames received on the channel while surveying it
+} ieee802154_transceiver_scan_channel_t;
+
+/**
+ * @brief Survey result.
+ */
+typedef struct {
+    uint32_t channel_mask;                              // Channels surveyed
+    uint32_t duration_us;                               // Time away from the previous channel
+    ieee802154_transceiver_scan_channel_t channels[16]; // Indexed by channel - 11
+} ieee802154_transceiver_scan_result_t;
+
+/**
+ * @brief Survey the energy on a set of channels.
+ *
+ * Runs on the calling task. The transmit task is held off for the duration of
+ * the survey (frames queue up), channel changes wait for it, and the previous
+ * channel and receive state are restored at the end. Frames heard on surveyed
+ * channels go through the usual receive path, with their channel in frame_info.
+ * The application must forward esp_ieee802154_energy_detect_done() to
+ * ieee802154_transceiver_handle_energy_detect_done().
+ *
+ * @param config Survey configuration, or NULL for the defaults.
+ * @param result Survey result out.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad configuration,
+ *         ESP_ERR_INVALID_STATE if the transceiver is not initialized or a survey
+ *         is already running, ESP_ERR_TIMEOUT if a measurement did not complete,
+ *         or an error code from the radio. The result covers the channels
+ *         surveyed before an error.
+ */
+esp_err_t ieee802154_transceiver_scan_energy(const ieee802154_transceiver_scan_config_t *config,
+                                             ieee802154_transceiver_scan_result_t *result);
+
+/**
+ * @brief Rank the surveyed channels, quietest first.
+ *
+ * Channels are ordered by mean energy, then peak energy, then frames heard,
+ * then channel number.
+ *
+ * @param result Survey result.
+ * @param channels Channel numbers out, best first.
+ * @param max Entries in channels.
+ * @param count Entries filled out.
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG for NULL arguments.
+ */
+esp_err_t ieee802154_transceiver_scan_rank(const ieee802154_transceiver_scan_result_t *result, uint8_t *channels,
+                                           size_t max, size_t *count);
+
+/**
+ * @brief Handle the callback for completed energy detections.
+ *
+ * This function should be called from esp_ieee802154_energy_detect_done.
+ *
+ * @param power Measured energy, dBm.
+ */
+void ieee802154_transceiver_handle_energy_detect_done(int8_t power);
+
+#endif // IEEE802154_TRANSCEIVER_SCAN_H
@@ -0,0 +1,74 @@
+#ifndef IEEE802154_TRANSCEIVER_TRACE_H
+#define IEEE802154_TRANSCEIVER_TRACE_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * @brief Pipeline stages timed by the trace layer (CONFIG_IEEE802154_TRANSCEIVER_TRACE).
+ *
+ * Consecutive receive stages add up to the time from the receive ISR to the
+ * return of the last callback; the transmit stages to the time from queueing a
+ * frame to its completion interrupt.
+ */
+typedef enum {
+    IEEE802154_TRANSCEIVER_TRACE_ISR = 0,   // Receive ISR entry -> frame queued
+    IEEE802154_TRANSCEIVER_TRACE_QUEUE,     // Frame queued -> taken by the receive task
+    IEEE802154_TRANSCEIVER_TRACE_PARSE,     // ieee802154_frame_parse() of one frame
+    IEEE802154_TRANSCEIVER_TRACE_CALLBACK,  // Receive callbacks of one frame (or one batch), parse excluded
+    IEEE802154_TRANSCEIVER_TRACE_TX_QUEUE,  // Asynchronous transmit queued -> handed to the radio
+    IEEE802154_TRANSCEIVER_TRACE_TX_RADIO,  // Handed to the radio -> transmit done or failed
+    IEEE802154_TRANSCEIVER_TRACE_RELAY,     // Receive ISR entry -> transmit done of the bridged copy
+    IEEE802154_TRANSCEIVER_TRACE_STAGE_MAX,
+} ieee802154_transceiver_trace_stage_t;
+
+// Histogram buckets: bucket 0 counts 0 us, bucket i counts [2^(i-1), 2^i) us,
+// and the last bucket everything from 2^(BUCKETS-2) us up
+#define IEEE802154_TRANSCEIVER_TRACE_BUCKETS 24
+
+/**
+ * @brief Latency histogram of one stage.
+ */
+typedef struct {
+    uint32_t count;   // Samples
+    uint32_t max_us;  // Largest sample
+    uint64_t sum_us;  // Sum of all samples
+    uint32_t buckets[IEEE802154_TRANSCEIVER_TRACE_BUCKETS];
+} ieee802154_transceiver_trace_hist_t;
+
+/**
+ * @brief Copy the histogram of a stage.
+ *
+ * @param stage Stage to read.
+ * @param hist Histogram to fill.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an invalid stage or NULL hist,
+ *         or ESP_ERR_NOT_SUPPORTED if CONFIG_IEEE802154_TRANSCEIVER_TRACE is disabled.
+ */
+esp_err_t ieee802154_transceiver_trace_get(ieee802154_transceiver_trace_stage_t stage,
+                                           ieee802154_transceiver_trace_hist_t *hist);
+
+/**
+ * @brief Clear every stage histogram.
+ *
+ * @return ESP_OK on success, or ESP_ERR_NOT_SUPPORTED if tracing is disabled.
+ */
+esp_err_t ieee802154_transceiver_trace_reset(void);
+
+/**
+ * @brief Estimate a percentile from a histogram.
+ *
+ * The result is the upper bound of the bucket holding the percentile, capped
+ * at the largest sample, so it over-estimates by less than a factor of two.
+ *
+ * @param hist Histogram from ieee802154_transceiver_trace_get().
+ * @param percent Percentile, e.g. 50, 99 or 99.9.
+ * @return Latency in microseconds, or 0 if the histogram is empty.
+ */
+uint32_t ieee802154_transceiver_trace_percentile(const ieee802154_transceiver_trace_hist_t *hist, float percent);
+
+/**
+ * @brief Name of a stage, for logs.
+ */
+const char *ieee802154_transceiver_trace_stage_name(ieee802154_transceiver_trace_stage_t stage);
+
+#endif // IEEE802154_TRANSCEIVER_TRACE_H
@@ -0,0 +1,881 @@
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "esp_log.h"
+
+#include "esp_ieee802154.h"
+#include "ieee802154_sim.h"
+
+#define TAG "IEEE802154_SIM"
+
+#define MAX_FRAME_LEN 128
+#define SIM_RX_BUFFERS 20        // Receive buffers of the radio, as the driver's default
+#define SIM_EVENT_QUEUE_DEPTH 64 // Frames on the air at once
+#define SIM_RADIO_RSSI -50       // Link quality peers see for the radio's frames
+#define SIM_RADIO_LQI 200
+#define SIM_NOISE_FLOOR -100     // Default channel noise, dBm
+#define SIM_CCA_THRESHOLD -60    // Energy at which CCA reports a busy channel, dBm, as the driver's default
+#define SIM_SYMBOL_US 16
+#define SIM_PENDING_MAX 20       // Pending address table entries per address length, as the driver's default
+#define SIM_FRAME_TYPE_BEACON 0
+#define SIM_FRAME_TYPE_DATA 1
+#define SIM_FRAME_TYPE_ACK 2
+#define SIM_FRAME_TYPE_COMMAND 3
+#define SIM_COMMAND_DATA_REQUEST 0x04
+
+typedef enum {
+    SIM_EVENT_FRAME, // A frame goes on the air
+    SIM_EVENT_FLUSH, // Every earlier frame has been delivered
+    SIM_EVENT_ENERGY, // An energy detection of the radio completes
+} sim_event_type_t;
+
+// Event handled by the simulated ISR task, in order
+typedef struct {
+    sim_event_type_t type;
+    int sender;              // Node number
+    uint8_t channel;
+    int8_t rssi;
+    uint8_t lqi;
+    int64_t due_us;          // Delivery time
+    int64_t start_us;        // Start of the measurement, for SIM_EVENT_ENERGY
+    const uint8_t *tx_frame; // Radio buffer reported in transmit_done, for frames from the radio
+    bool cca;                // Assess the channel before sending, for frames from the radio
+    TaskHandle_t waiter;     // Task to notify, for SIM_EVENT_FLUSH
+    uint8_t frame[MAX_FRAME_LEN];
+} sim_event_t;
+
+typedef struct {
+    bool used;
+    ieee802154_sim_node_config_t config;
+} sim_node_t;
+
+// MAC header fields the radio's address filter looks at
+typedef struct {
+    uint8_t type;
+    uint8_t seq;
+    bool ack_request;
+    uint8_t dest_len;       // 0, 2 or 8
+    uint8_t src_len;
+    uint16_t dest_pan;      // 0xffff when absent
+    uint16_t src_pan;       // The destination PAN when compressed
+    const uint8_t *dest_addr;
+    const uint8_t *src_addr;
+    const uint8_t *payload; // First byte after the header, NULL if none
+} sim_header_t;
+
+// Radio (node 0) state
+static bool radio_enabled = false;
+static bool radio_receiving = false;
+static bool radio_promiscuous = false;
+static bool radio_rx_when_idle = false;
+static bool radio_coordinator = false;
+static volatile bool radio_transmitting = false;
+static volatile bool radio_detecting = false;
+static uint8_t radio_channel = 11;
+static int8_t radio_txpower = 20;
+static esp_ieee802154_pending_mode_t radio_pending_mode = ESP_IEEE802154_AUTO_PENDING_DISABLE;
+static uint16_t radio_panid = 0xffff;
+static uint16_t radio_short_address = 0xfffe;
+static uint8_t radio_ext_address[8];
+
+// Addresses with frames pending, for the frame pending bit of acknowledgments
+static uint8_t pending_short[SIM_PENDING_MAX][2];
+static uint8_t pending_ext[SIM_PENDING_MAX][8];
+static int pending_short_count = 0;
+static int pending_ext_count = 0;
+
+// Receive buffers handed to esp_ieee802154_receive_done, returned by esp_ieee802154_receive_handle_done
+static uint8_t rx_buffers[SIM_RX_BUFFERS][MAX_FRAME_LEN];
+static volatile bool rx_buffer_used[SIM_RX_BUFFERS];
+
+// Medium
+static sim_node_t nodes[IEEE802154_SIM_MAX_NODES + 1]; // Index 0 is the radio
+static ieee802154_sim_medium_t medium;
+static ieee802154_sim_stats_t stats;
+static uint32_t rng_state = 1;
+static int8_t channel_noise[16];
+static int64_t channel_air_us[16];   // When the last frame went on the air, per channel
+static int8_t channel_air_rssi[16];  // And its RSSI
+static portMUX_TYPE sim_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static QueueHandle_t event_queue = NULL;
+static TaskHandle_t isr_task_handle = NULL;
+
+// Forward declarations
+static void sim_isr_task(void *pvParameters);
+
+// Internal: Host monotonic time
+static int64_t sim_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Internal: xorshift32, reproducible from medium.seed
+static uint32_t sim_random(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state = x;
+    return x;
+}
+
+// Internal: Draw a loss for one receiver
+static bool sim_lost(void) {
+    if (medium.loss <= 0.0f) {
+        return false;
+    }
+    portENTER_CRITICAL(&sim_lock);
+    float draw = (sim_random() >> 8) * (1.0f / 16777216.0f);
+    portEXIT_CRITICAL(&sim_lock);
+    return draw < medium.loss;
+}
+
+// Internal: Create the event queue and the ISR task on first use
+static esp_err_t sim_start(void) {
+    if (isr_task_handle) {
+        return ESP_OK;
+    }
+    memset(channel_noise, SIM_NOISE_FLOOR, sizeof(channel_noise));
+
+    event_queue = xQueueCreate(SIM_EVENT_QUEUE_DEPTH, sizeof(sim_event_t));
+    if (!event_queue) {
+        ESP_LOGE(TAG, "Failed to create event queue");
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(sim_isr_task, "SIMISR", 1024 * 8, NULL, configMAX_PRIORITIES - 1, &isr_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create ISR task");
+        vQueueDelete(event_queue);
+        event_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+// Internal: Put a frame on the air after the medium latency
+static esp_err_t sim_post(sim_event_t *event, TickType_t wait) {
+    esp_err_t ret = sim_start();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    portENTER_CRITICAL(&sim_lock);
+    uint32_t jitter_us = medium.jitter_us ? sim_random() % (medium.jitter_us + 1) : 0;
+    portEXIT_CRITICAL(&sim_lock);
+    event->due_us = sim_now_us() + medium.latency_us + jitter_us;
+
+    return (xQueueSend(event_queue, event, wait) == pdTRUE) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+// Internal: Locate the addressing fields of a frame (2006 layout)
+static bool sim_parse_header(const uint8_t *frame, sim_header_t *header) {
+    static const uint8_t addr_len[4] = {0, 0, 2, 8}; // By addressing mode
+
+    size_t len = frame[0] >= 2 ? frame[0] - 2 : 0; // Without the FCS
+    const uint8_t *psdu = &frame[1];
+    if (len < 3) {
+        return false;
+    }
+    uint16_t fcf = psdu[0] | (psdu[1] << 8);
+    header->type = fcf & 0x07;
+    header->ack_request = fcf & (1 << 5);
+    header->seq = psdu[2];
+    header->dest_len = addr_len[(fcf >> 10) & 0x03];
+    header->src_len = addr_len[(fcf >> 14) & 0x03];
+    header->dest_pan = 0xffff;
+    header->src_pan = 0xffff;
+    header->dest_addr = NULL;
+    header->src_addr = NULL;
+
+    size_t pos = 3;
+    if (header->dest_len) {
+        if (pos + 2 + header->dest_len > len) {
+            return false;
+        }
+        header->dest_pan = psdu[pos] | (psdu[pos + 1] << 8);
+        header->dest_addr = &psdu[pos + 2];
+        pos += 2 + header->dest_len;
+    }
+    if (header->src_len) {
+        if (!(fcf & (1 << 6)) || !header->dest_len) {
+            if (pos + 2 > len) {
+                return false;
+            }
+            header->src_pan = psdu[pos] | (psdu[pos + 1] << 8);
+            pos += 2;
+        } else {
+            header->src_pan = header->dest_pan;
+        }
+        if (pos + header->src_len > len) {
+            return false;
+        }
+        header->src_addr = &psdu[pos];
+        pos += header->src_len;
+    }
+    header->payload = pos < len ? &psdu[pos] : NULL;
+    return true;
+}
+
+// Internal: Third-level filtering of a frame on its destination, as the radio does out of promiscuous mode
+static bool sim_address_match(const sim_header_t *header) {
+    // Acknowledgments are only taken while waiting for one, after a transmission
+    if (header->type == SIM_FRAME_TYPE_ACK) {
+        return false;
+    }
+    if (header->type == SIM_FRAME_TYPE_BEACON) {
+        return radio_panid == 0xffff || header->src_pan == radio_panid;
+    }
+    if (header->dest_len) {
+        if (header->dest_pan != 0xffff && header->dest_pan != radio_panid) {
+            return false;
+        }
+        if (header->dest_len == 2) {
+            uint16_t dest = header->dest_addr[0] | (header->dest_addr[1] << 8);
+            return dest == 0xffff || dest == radio_short_address;
+        }
+        return memcmp(header->dest_addr, radio_ext_address, 8) == 0;
+    }
+    // Without a destination, only the PAN coordinator takes frames from its PAN
+    return radio_coordinator && header->src_len && header->src_pan == radio_panid;
+}
+
+// Internal: Index of an address in the pending table, or -1
+static int sim_pending_find(const uint8_t *addr, bool is_short) {
+    int count = is_short ? pending_short_count : pending_ext_count;
+    for (int i = 0; i < count; i++) {
+        if (memcmp(addr, is_short ? pending_short[i] : pending_ext[i], is_short ? 2 : 8) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Internal: Frame pending bit of the acknowledgment to a frame, by pending mode
+static bool sim_ack_pending(const sim_header_t *header) {
+    if (radio_pending_mode == ESP_IEEE802154_AUTO_PENDING_DISABLE || !header->src_len) {
+        return false;
+    }
+    bool data_request = header->type == SIM_FRAME_TYPE_COMMAND && header->payload &&
+                        header->payload[0] == SIM_COMMAND_DATA_REQUEST;
+    if (radio_pending_mode != ESP_IEEE802154_AUTO_PENDING_ENHANCED && !data_request) {
+        return false;
+    }
+    // Zigbee mode assumes frames pending for every extended address
+    if (radio_pending_mode == ESP_IEEE802154_AUTO_PENDING_ZIGBEE && header->src_len == 8) {
+        return true;
+    }
+    portENTER_CRITICAL(&sim_lock);
+    bool pending = sim_pending_find(header->src_addr, header->src_len == 2) >= 0;
+    portEXIT_CRITICAL(&sim_lock);
+    return pending;
+}
+
+// Internal: Acknowledge a received frame if it asks for it and was not broadcast
+static void sim_auto_ack(const sim_event_t *event, const sim_header_t *header, bool pending) {
+    bool broadcast = header->dest_len == 2 && header->dest_addr[0] == 0xff && header->dest_addr[1] == 0xff;
+    if (!header->ack_request || broadcast ||
+        (header->type != SIM_FRAME_TYPE_DATA && header->type != SIM_FRAME_TYPE_COMMAND)) {
+        return;
+    }
+
+    sim_event_t ack;
+    ack.type = SIM_EVENT_FRAME;
+    ack.sender = IEEE802154_SIM_RADIO_NODE;
+    ack.channel = event->channel;
+    ack.rssi = SIM_RADIO_RSSI;
+    ack.lqi = SIM_RADIO_LQI;
+    ack.tx_frame = NULL;
+    ack.cca = false;
+    ack.frame[0] = 5;
+    ack.frame[1] = SIM_FRAME_TYPE_ACK | (pending ? 1 << 4 : 0);
+    ack.frame[2] = 0x00;
+    ack.frame[3] = header->seq;
+    ack.frame[4] = 0x00;
+    ack.frame[5] = 0x00;
+    if (sim_post(&ack, 0) == ESP_OK) {
+        stats.acked++;
+    }
+}
+
+// Internal: Hand a frame to the radio, as its receive interrupt would
+static void sim_deliver_to_radio(const sim_event_t *event) {
+    if (!radio_enabled || !radio_receiving || radio_transmitting || event->channel != radio_channel) {
+        return;
+    }
+
+    // Out of promiscuous mode, foreign frames never reach the receive interrupt
+    sim_header_t header;
+    bool filtering = !radio_promiscuous;
+    if (filtering && (!sim_parse_header(event->frame, &header) || !sim_address_match(&header))) {
+        stats.filtered++;
+        return;
+    }
+    if (sim_lost()) {
+        stats.lost++;
+        return;
+    }
+
+    int slot = -1;
+    for (int i = 0; i < SIM_RX_BUFFERS && slot < 0; i++) {
+        if (!rx_buffer_used[i]) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        stats.overflow++;
+        return;
+    }
+
+    rx_buffer_used[slot] = true;
+    memcpy(rx_buffers[slot], event->frame, event->frame[0] + 1);
+    esp_ieee802154_frame_info_t frame_info = {
+        .pending = filtering && sim_ack_pending(&header),
+        .channel = event->channel,
+        .rssi = event->rssi,
+        .lqi = event->lqi,
+        .timestamp = sim_now_us(),
+    };
+    stats.delivered++;
+    esp_ieee802154_receive_sfd_done();
+    esp_ieee802154_receive_done(rx_buffers[slot], &frame_info);
+
+    if (filtering) {
+        sim_auto_ack(event, &header, frame_info.pending);
+    }
+}
+
+// Internal: Whether the channel of a frame from the radio is busy, by energy detection
+static bool sim_cca_busy(uint8_t channel) {
+    portENTER_CRITICAL(&sim_lock);
+    int8_t noise = channel_noise[channel - 11];
+    portEXIT_CRITICAL(&sim_lock);
+    return noise >= SIM_CCA_THRESHOLD;
+}
+
+// Internal: Report the end of the radio's own transmission, with the peer acknowledgment it waited for
+static void sim_transmit_done(const sim_event_t *event, int acker) {
+    static uint8_t ack_frame[6];
+    sim_header_t header;
+    bool ack_request = sim_parse_header(event->frame, &header) && header.ack_request &&
+                       !(header.dest_len == 2 && header.dest_addr[0] == 0xff && header.dest_addr[1] == 0xff);
+
+    radio_transmitting = false;
+    esp_ieee802154_transmit_sfd_done((uint8_t *)event->tx_frame);
+    if (!ack_request) {
+        esp_ieee802154_transmit_done(event->tx_frame, NULL, NULL);
+        return;
+    }
+    if (acker < 0) {
+        esp_ieee802154_transmit_failed(event->tx_frame, ESP_IEEE802154_TX_ERR_NO_ACK);
+        return;
+    }
+
+    portENTER_CRITICAL(&sim_lock);
+    esp_ieee802154_frame_info_t ack_info = {
+        .channel = event->channel,
+        .rssi = nodes[acker].config.rssi,
+        .lqi = nodes[acker].config.lqi,
+        .timestamp = sim_now_us(),
+    };
+    portEXIT_CRITICAL(&sim_lock);
+    ack_frame[0] = 5;
+    ack_frame[1] = SIM_FRAME_TYPE_ACK;
+    ack_frame[2] = 0x00;
+    ack_frame[3] = header.seq;
+    ack_frame[4] = 0x00;
+    ack_frame[5] = 0x00;
+    esp_ieee802154_transmit_done(event->tx_frame, ack_frame, &ack_info);
+}
+
+// Internal: Deliver a frame to every node listening on its channel
+static void sim_air(const sim_event_t *event) {
+    bool from_radio = event->sender == IEEE802154_SIM_RADIO_NODE && event->tx_frame;
+
+    // A busy channel keeps the frame off the air
+    if (from_radio && event->cca && sim_cca_busy(event->channel)) {
+        stats.cca_busy++;
+        radio_transmitting = false;
+        esp_ieee802154_transmit_failed(event->tx_frame, ESP_IEEE802154_TX_ERR_CCA_BUSY);
+        return;
+    }
+
+    stats.transmitted++;
+    channel_air_us[event->channel - 11] = sim_now_us();
+    channel_air_rssi[event->channel - 11] = event->rssi;
+
+    if (event->sender != IEEE802154_SIM_RADIO_NODE) {
+        sim_deliver_to_radio(event);
+    }
+
+    int acker = -1;
+    for (int i = 1; i <= IEEE802154_SIM_MAX_NODES; i++) {
+        portENTER_CRITICAL(&sim_lock);
+        sim_node_t node = nodes[i];
+        portEXIT_CRITICAL(&sim_lock);
+
+        if (!node.used || i == event->sender || node.config.channel != event->channel ||
+            (!node.config.rx_cb && !node.config.ack)) {
+            continue;
+        }
+        if (sim_lost()) {
+            stats.lost++;
+            continue;
+        }
+        if (node.config.ack && acker < 0) {
+            acker = i;
+        }
+        if (!node.config.rx_cb) {
+            continue;
+        }
+
+        esp_ieee802154_frame_info_t frame_info = {
+            .channel = event->channel,
+            .rssi = event->rssi,
+            .lqi = event->lqi,
+            .timestamp = sim_now_us(),
+        };
+        stats.delivered++;
+        node.config.rx_cb(i, event->frame, &frame_info, node.config.ctx);
+    }
+
+    // The radio's own transmission completes once the frame is out; acknowledgments report nothing
+    if (from_radio) {
+        sim_transmit_done(event, acker);
+    }
+}
+
+// Internal: Report an energy measurement, the channel noise or a frame heard meanwhile
+static void sim_energy_done(const sim_event_t *event) {
+    int index = event->channel - 11;
+    portENTER_CRITICAL(&sim_lock);
+    int8_t power = channel_noise[index];
+    portEXIT_CRITICAL(&sim_lock);
+    if (channel_air_us[index] >= event->start_us && channel_air_rssi[index] > power) {
+        power = channel_air_rssi[index];
+    }
+
+    // As the driver, the radio is idle afterwards unless it receives when idle
+    radio_detecting = false;
+    radio_receiving = radio_rx_when_idle;
+    esp_ieee802154_energy_detect_done(power);
+}
+
+/**
+ * @brief Task standing in for the radio ISR: delivers frames in order, at their due time.
+ */
+static void sim_isr_task(void *pvParameters) {
+    static sim_event_t event;
+
+    while (1) {
+        if (xQueueReceive(event_queue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        int64_t wait_us = event.due_us - sim_now_us();
+        if (wait_us > 0 && pdMS_TO_TICKS(wait_us / 1000) > 0) {
+            vTaskDelay(pdMS_TO_TICKS(wait_us / 1000));
+        }
+
+        if (event.type == SIM_EVENT_FLUSH) {
+            xTaskNotifyGive(event.waiter);
+            continue;
+        }
+        if (event.type == SIM_EVENT_ENERGY) {
+            sim_energy_done(&event);
+            continue;
+        }
+        sim_air(&event);
+    }
+}
+
+//=========================================================================================
+// esp_ieee802154 API of the radio
+
+esp_err_t esp_ieee802154_enable(void) {
+    esp_err_t ret = sim_start();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    radio_enabled = true;
+    radio_receiving = radio_rx_when_idle;
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_disable(void) {
+    radio_enabled = false;
+    radio_receiving = false;
+    return ESP_OK;
+}
+
+esp_ieee802154_state_t esp_ieee802154_get_state(void) {
+    if (!radio_enabled) {
+        return ESP_IEEE802154_RADIO_DISABLE;
+    }
+    if (radio_transmitting) {
+        return ESP_IEEE802154_RADIO_TRANSMIT;
+    }
+    return radio_receiving ? ESP_IEEE802154_RADIO_RECEIVE : ESP_IEEE802154_RADIO_IDLE;
+}
+
+esp_err_t esp_ieee802154_sleep(void) {
+    radio_receiving = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_receive(void) {
+    if (!radio_enabled) {
+        return ESP_FAIL;
+    }
+    radio_receiving = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_transmit(const uint8_t *frame, bool cca) {
+    if (!radio_enabled) {
+        return ESP_FAIL;
+    }
+    if (!frame || frame[0] + 1 > MAX_FRAME_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sim_event_t event;
+    event.type = SIM_EVENT_FRAME;
+    event.sender = IEEE802154_SIM_RADIO_NODE;
+    event.channel = radio_channel;
+    event.rssi = SIM_RADIO_RSSI;
+    event.lqi = SIM_RADIO_LQI;
+    event.tx_frame = frame;
+    event.cca = cca;
+    memcpy(event.frame, frame, frame[0] + 1);
+
+    radio_transmitting = true;
+    esp_err_t ret = sim_post(&event, 0);
+    if (ret != ESP_OK) {
+        radio_transmitting = false;
+    }
+    return ret;
+}
+
+esp_err_t esp_ieee802154_energy_detect(uint32_t duration) {
+    if (!radio_enabled || radio_transmitting || radio_detecting) {
+        return ESP_FAIL;
+    }
+    esp_err_t ret = sim_start();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Not subject to the medium latency: the measurement ends duration symbols from now
+    sim_event_t event;
+    event.type = SIM_EVENT_ENERGY;
+    event.channel = radio_channel;
+    event.start_us = sim_now_us();
+    event.due_us = event.start_us + (int64_t)duration * SIM_SYMBOL_US;
+    radio_receiving = false;
+    radio_detecting = true;
+    if (xQueueSend(event_queue, &event, 0) != pdTRUE) {
+        radio_detecting = false;
+        radio_receiving = true;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_receive_handle_done(const uint8_t *frame) {
+    for (int i = 0; i < SIM_RX_BUFFERS; i++) {
+        if (frame == rx_buffers[i]) {
+            rx_buffer_used[i] = false;
+        }
+    }
+    return ESP_OK;
+}
+
+uint8_t esp_ieee802154_get_channel(void) {
+    return radio_channel;
+}
+
+esp_err_t esp_ieee802154_set_channel(uint8_t channel) {
+    if (channel < 11 || channel > 26) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    radio_channel = channel;
+    return ESP_OK;
+}
+
+int8_t esp_ieee802154_get_txpower(void) {
+    return radio_txpower;
+}
+
+esp_err_t esp_ieee802154_set_txpower(int8_t power) {
+    radio_txpower = power;
+    return ESP_OK;
+}
+
+bool esp_ieee802154_get_promiscuous(void) {
+    return radio_promiscuous;
+}
+
+esp_err_t esp_ieee802154_set_promiscuous(bool enable) {
+    radio_promiscuous = enable;
+    return ESP_OK;
+}
+
+bool esp_ieee802154_get_rx_when_idle(void) {
+    return radio_rx_when_idle;
+}
+
+esp_err_t esp_ieee802154_set_rx_when_idle(bool enable) {
+    radio_rx_when_idle = enable;
+    if (enable && radio_enabled) {
+        radio_receiving = true;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_set_coordinator(bool enable) {
+    radio_coordinator = enable;
+    return ESP_OK;
+}
+
+esp_ieee802154_pending_mode_t esp_ieee802154_get_pending_mode(void) {
+    return radio_pending_mode;
+}
+
+esp_err_t esp_ieee802154_set_pending_mode(esp_ieee802154_pending_mode_t pending_mode) {
+    radio_pending_mode = pending_mode;
+    return ESP_OK;
+}
+
+uint16_t esp_ieee802154_get_panid(void) {
+    return radio_panid;
+}
+
+esp_err_t esp_ieee802154_set_panid(uint16_t panid) {
+    radio_panid = panid;
+    return ESP_OK;
+}
+
+uint16_t esp_ieee802154_get_short_address(void) {
+    return radio_short_address;
+}
+
+esp_err_t esp_ieee802154_set_short_address(uint16_t short_address) {
+    radio_short_address = short_address;
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_get_extended_address(uint8_t *ext_addr) {
+    memcpy(ext_addr, radio_ext_address, sizeof(radio_ext_address));
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_set_extended_address(const uint8_t *ext_addr) {
+    memcpy(radio_ext_address, ext_addr, sizeof(radio_ext_address));
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_add_pending_addr(const uint8_t *addr, bool is_short) {
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&sim_lock);
+    if (sim_pending_find(addr, is_short) < 0) {
+        int *count = is_short ? &pending_short_count : &pending_ext_count;
+        if (*count == SIM_PENDING_MAX) {
+            ret = ESP_ERR_NO_MEM;
+        } else {
+            memcpy(is_short ? pending_short[*count] : pending_ext[*count], addr, is_short ? 2 : 8);
+            (*count)++;
+        }
+    }
+    portEXIT_CRITICAL(&sim_lock);
+    return ret;
+}
+
+esp_err_t esp_ieee802154_clear_pending_addr(const uint8_t *addr, bool is_short) {
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&sim_lock);
+    int index = sim_pending_find(addr, is_short);
+    if (index < 0) {
+        ret = ESP_ERR_NOT_FOUND;
+    } else if (is_short) {
+        memcpy(pending_short[index], pending_short[--pending_short_count], 2);
+    } else {
+        memcpy(pending_ext[index], pending_ext[--pending_ext_count], 8);
+    }
+    portEXIT_CRITICAL(&sim_lock);
+    return ret;
+}
+
+void esp_ieee802154_reset_pending_table(bool is_short) {
+    portENTER_CRITICAL(&sim_lock);
+    if (is_short) {
+        pending_short_count = 0;
+    } else {
+        pending_ext_count = 0;
+    }
+    portEXIT_CRITICAL(&sim_lock);
+}
+
+// Default event callbacks. Like the driver's, they are meant to be overridden;
+// the receive default releases the buffer so an application without one does not starve the radio.
+__attribute__((weak)) void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info) {
+    esp_ieee802154_receive_handle_done(frame);
+}
+
+__attribute__((weak)) void esp_ieee802154_receive_sfd_done(void) {
+}
+
+__attribute__((weak)) void esp_ieee802154_transmit_done(const uint8_t *frame, const uint8_t *ack,
+                                                        esp_ieee802154_frame_info_t *ack_frame_info) {
+}
+
+__attribute__((weak)) void esp_ieee802154_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error) {
+}
+
+__attribute__((weak)) void esp_ieee802154_transmit_sfd_done(uint8_t *frame) {
+}
+
+__attribute__((weak)) void esp_ieee802154_energy_detect_done(int8_t power) {
+}
+
+//=========================================================================================
+// Medium control
+
+/**
+ * @brief Set the medium characteristics.
+ */
+esp_err_t ieee802154_sim_set_medium(const ieee802154_sim_medium_t *config) {
+    if (!config || config->loss < 0.0f || config->loss > 1.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&sim_lock);
+    medium = *config;
+    rng_state = config->seed ? config->seed : 1;
+    portEXIT_CRITICAL(&sim_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Set the noise level of a channel, as reported by energy detection.
+ */
+esp_err_t ieee802154_sim_set_noise(uint8_t channel, int8_t dbm) {
+    if (channel < 11 || channel > 26) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&sim_lock);
+    channel_noise[channel - 11] = dbm;
+    portEXIT_CRITICAL(&sim_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Add a peer node.
+ */
+int ieee802154_sim_node_create(const ieee802154_sim_node_config_t *config) {
+    if (!config || config->channel < 11 || config->channel > 26 || sim_start() != ESP_OK) {
+        return -1;
+    }
+
+    int node = -1;
+    portENTER_CRITICAL(&sim_lock);
+    for (int i = 1; i <= IEEE802154_SIM_MAX_NODES && node < 0; i++) {
+        if (!nodes[i].used) {
+            nodes[i].used = true;
+            nodes[i].config = *config;
+            node = i;
+        }
+    }
+    portEXIT_CRITICAL(&sim_lock);
+    return node;
+}
+
+/**
+ * @brief Remove a peer node.
+ */
+esp_err_t ieee802154_sim_node_delete(int node) {
+    if (node < 1 || node > IEEE802154_SIM_MAX_NODES || !nodes[node].used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&sim_lock);
+    nodes[node].used = false;
+    portEXIT_CRITICAL(&sim_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Move a peer node to another channel.
+ */
+esp_err_t ieee802154_sim_node_set_channel(int node, uint8_t channel) {
+    if (node < 1 || node > IEEE802154_SIM_MAX_NODES || !nodes[node].used || channel < 11 || channel > 26) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&sim_lock);
+    nodes[node].config.channel = channel;
+    portEXIT_CRITICAL(&sim_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Put a frame on the air from a peer node.
+ */
+esp_err_t ieee802154_sim_node_transmit(int node, const uint8_t *frame) {
+    if (node < 1 || node > IEEE802154_SIM_MAX_NODES || !nodes[node].used ||
+        !frame || frame[0] < 2 || frame[0] + 1 > MAX_FRAME_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sim_event_t event;
+    portENTER_CRITICAL(&sim_lock);
+    event.type = SIM_EVENT_FRAME;
+    event.sender = node;
+    event.channel = nodes[node].config.channel;
+    event.rssi = nodes[node].config.rssi;
+    event.lqi = nodes[node].config.lqi;
+    portEXIT_CRITICAL(&sim_lock);
+    event.tx_frame = NULL;
+    event.cca = false;
+    memcpy(event.frame, frame, frame[0] + 1);
+
+    return sim_post(&event, portMAX_DELAY);
+}
+
+/**
+ * @brief Get the medium counters.
+ */
+esp_err_t ieee802154_sim_get_stats(ieee802154_sim_stats_t *out) {
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out = stats;
+    return ESP_OK;
+}
+
+/**
+ * @brief Remove every peer node, restore a quiet, lossless, zero-latency medium and clear the counters.
+ */
+void ieee802154_sim_reset(void) {
+    if (sim_start() != ESP_OK) {
+        return;
+    }
+
+    // Drain the frames already on the air
+    sim_event_t flush = {
+        .type = SIM_EVENT_FLUSH,
+        .waiter = xTaskGetCurrentTaskHandle(),
+    };
+    sim_post(&flush, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    portENTER_CRITICAL(&sim_lock);
+    memset(nodes, 0, sizeof(nodes));
+    memset(&medium, 0, sizeof(medium));
+    memset(&stats, 0, sizeof(stats));
+    memset(channel_noise, SIM_NOISE_FLOOR, sizeof(channel_noise));
+    memset(channel_air_us, 0, sizeof(channel_air_us));
+    rng_state = 1;
+    portEXIT_CRITICAL(&sim_lock);
+}
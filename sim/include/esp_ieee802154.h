@@ -0,0 +1,97 @@
+#ifndef ESP_IEEE802154_H
+#define ESP_IEEE802154_H
+
+/*
+ * Host (Linux target) stand-in for ESP-IDF's esp_ieee802154.h.
+ *
+ * Declares the subset of the driver API the transceiver uses, with the same
+ * types and signatures, backed by the simulated radio in esp_ieee802154_sim.c.
+ * The event callbacks are raised from the simulation's ISR task and, as on the
+ * chip, are weak symbols the application overrides.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_IEEE802154_RADIO_DISABLE,
+    ESP_IEEE802154_RADIO_IDLE,
+    ESP_IEEE802154_RADIO_SLEEP,
+    ESP_IEEE802154_RADIO_RECEIVE,
+    ESP_IEEE802154_RADIO_TRANSMIT,
+} esp_ieee802154_state_t;
+
+typedef enum {
+    ESP_IEEE802154_TX_ERR_NONE,
+    ESP_IEEE802154_TX_ERR_CCA_BUSY,
+    ESP_IEEE802154_TX_ERR_ABORT,
+    ESP_IEEE802154_TX_ERR_NO_ACK,
+    ESP_IEEE802154_TX_ERR_INVALID_ACK,
+    ESP_IEEE802154_TX_ERR_COEXIST,
+    ESP_IEEE802154_TX_ERR_SECURITY,
+} esp_ieee802154_tx_error_t;
+
+typedef enum {
+    ESP_IEEE802154_AUTO_PENDING_DISABLE,
+    ESP_IEEE802154_AUTO_PENDING_ENABLE,
+    ESP_IEEE802154_AUTO_PENDING_ENHANCED,
+    ESP_IEEE802154_AUTO_PENDING_ZIGBEE,
+} esp_ieee802154_pending_mode_t;
+
+typedef struct {
+    bool pending;       // The frame was acked with frame pending set
+    bool process;       // The frame needs to be processed by the upper layer
+    uint8_t channel;    // Channel
+    int8_t rssi;        // RSSI
+    uint8_t lqi;        // LQI
+    uint64_t timestamp; // Time the frame was received, in microseconds
+} esp_ieee802154_frame_info_t;
+
+esp_err_t esp_ieee802154_enable(void);
+esp_err_t esp_ieee802154_disable(void);
+esp_ieee802154_state_t esp_ieee802154_get_state(void);
+esp_err_t esp_ieee802154_sleep(void);
+esp_err_t esp_ieee802154_receive(void);
+esp_err_t esp_ieee802154_transmit(const uint8_t *frame, bool cca);
+esp_err_t esp_ieee802154_receive_handle_done(const uint8_t *frame);
+esp_err_t esp_ieee802154_energy_detect(uint32_t duration);
+
+uint8_t esp_ieee802154_get_channel(void);
+esp_err_t esp_ieee802154_set_channel(uint8_t channel);
+int8_t esp_ieee802154_get_txpower(void);
+esp_err_t esp_ieee802154_set_txpower(int8_t power);
+bool esp_ieee802154_get_promiscuous(void);
+esp_err_t esp_ieee802154_set_promiscuous(bool enable);
+bool esp_ieee802154_get_rx_when_idle(void);
+esp_err_t esp_ieee802154_set_rx_when_idle(bool enable);
+esp_err_t esp_ieee802154_set_coordinator(bool enable);
+esp_ieee802154_pending_mode_t esp_ieee802154_get_pending_mode(void);
+esp_err_t esp_ieee802154_set_pending_mode(esp_ieee802154_pending_mode_t pending_mode);
+uint16_t esp_ieee802154_get_panid(void);
+esp_err_t esp_ieee802154_set_panid(uint16_t panid);
+uint16_t esp_ieee802154_get_short_address(void);
+esp_err_t esp_ieee802154_set_short_address(uint16_t short_address);
+esp_err_t esp_ieee802154_get_extended_address(uint8_t *ext_addr);
+esp_err_t esp_ieee802154_set_extended_address(const uint8_t *ext_addr);
+esp_err_t esp_ieee802154_add_pending_addr(const uint8_t *addr, bool is_short);
+esp_err_t esp_ieee802154_clear_pending_addr(const uint8_t *addr, bool is_short);
+void esp_ieee802154_reset_pending_table(bool is_short);
+
+// Event callbacks, weak no-ops unless the application defines them
+void esp_ieee802154_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info);
+void esp_ieee802154_receive_sfd_done(void);
+void esp_ieee802154_transmit_done(const uint8_t *frame, const uint8_t *ack, esp_ieee802154_frame_info_t *ack_frame_info);
+void esp_ieee802154_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error);
+void esp_ieee802154_transmit_sfd_done(uint8_t *frame);
+void esp_ieee802154_energy_detect_done(int8_t power);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESP_IEEE802154_H
@@ -0,0 +1,139 @@
+#ifndef IEEE802154_SIM_H
+#define IEEE802154_SIM_H
+
+/*
+ * Simulated IEEE 802.15.4 medium for the Linux target.
+ *
+ * The esp_ieee802154 radio used by the transceiver is node 0 of an in-process
+ * medium. Tests add peer nodes, each listening on one channel, and let them
+ * transmit to the radio or receive what it sends. Frames are delivered by a
+ * top-priority FreeRTOS task standing in for the radio ISR, after the medium
+ * latency and subject to its loss rate.
+ *
+ * Energy detection on the radio reports the noise level of its channel, or the
+ * RSSI of a frame put on the air during the measurement if stronger.
+ *
+ * Out of promiscuous mode the radio filters frames on their destination PAN
+ * and address as the hardware does, and acknowledges the accepted frames that
+ * request it: the acknowledgment goes on the air to the peers on the channel,
+ * with the frame pending bit set from the pending mode and address table.
+ *
+ * Frames the radio sends with CCA are kept off the air, and reported as
+ * ESP_IEEE802154_TX_ERR_CCA_BUSY, while the noise level of the channel is at or
+ * above -60 dBm. A unicast frame requesting an acknowledgment completes with
+ * one if a peer node set to acknowledge received it, and fails with
+ * ESP_IEEE802154_TX_ERR_NO_ACK otherwise.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_ieee802154.h"
+
+// Node number of the radio driven through the esp_ieee802154 API
+#define IEEE802154_SIM_RADIO_NODE 0
+
+// Number of peer nodes that can exist at once
+#define IEEE802154_SIM_MAX_NODES 8
+
+/**
+ * @brief Medium characteristics, applied to every frame on the air.
+ *
+ * Latency is rounded down to whole FreeRTOS ticks; below one tick frames are
+ * delivered as soon as the ISR task runs. Loss is drawn independently for every
+ * receiver from a seeded generator, so runs are reproducible.
+ */
+typedef struct {
+    uint32_t latency_us; // Delay from transmission to reception
+    uint32_t jitter_us;  // Extra random delay, 0 to jitter_us
+    float loss;          // Probability (0-1) that a receiver misses a frame
+    uint32_t seed;       // Loss and jitter generator seed
+} ieee802154_sim_medium_t;
+
+/**
+ * @brief Receive callback of a peer node, called from the simulated ISR task.
+ *
+ * @param node Receiving node.
+ * @param frame Frame (frame[0] is the PSDU length), valid during the call.
+ * @param frame_info Channel, RSSI, LQI and timestamp.
+ * @param ctx Context given at creation.
+ */
+typedef void (*ieee802154_sim_rx_callback_t)(int node, const uint8_t *frame,
+                                             const esp_ieee802154_frame_info_t *frame_info, void *ctx);
+
+/**
+ * @brief Peer node configuration.
+ */
+typedef struct {
+    uint8_t channel;                    // Channel the node listens and transmits on (11-26)
+    int8_t rssi;                        // RSSI reported to receivers of this node's frames
+    uint8_t lqi;                        // LQI reported to receivers of this node's frames
+    ieee802154_sim_rx_callback_t rx_cb; // Receive callback, or NULL for a transmit-only node
+    void *ctx;
+    bool ack;                           // Acknowledge the radio's unicast frames that request it
+} ieee802154_sim_node_config_t;
+
+/**
+ * @brief Medium counters since the last reset.
+ */
+typedef struct {
+    uint32_t transmitted; // Frames put on the air, by any node
+    uint32_t delivered;   // Frame receptions, by any node
+    uint32_t lost;        // Receptions dropped by the loss model
+    uint32_t overflow;    // Frames the radio missed because all its receive buffers were held
+    uint32_t filtered;    // Frames dropped by the radio's address filter
+    uint32_t acked;       // Acknowledgments sent by the radio
+    uint32_t cca_busy;    // Radio transmissions kept off the air by a busy channel
+} ieee802154_sim_stats_t;
+
+/**
+ * @brief Set the medium characteristics.
+ */
+esp_err_t ieee802154_sim_set_medium(const ieee802154_sim_medium_t *medium);
+
+/**
+ * @brief Set the noise level of a channel, as reported by energy detection and CCA (default -100 dBm).
+ */
+esp_err_t ieee802154_sim_set_noise(uint8_t channel, int8_t dbm);
+
+/**
+ * @brief Add a peer node.
+ *
+ * @return Node number (1 or more), or -1 if the node table is full or the config is invalid.
+ */
+int ieee802154_sim_node_create(const ieee802154_sim_node_config_t *config);
+
+/**
+ * @brief Remove a peer node.
+ */
+esp_err_t ieee802154_sim_node_delete(int node);
+
+/**
+ * @brief Move a peer node to another channel.
+ */
+esp_err_t ieee802154_sim_node_set_channel(int node, uint8_t channel);
+
+/**
+ * @brief Put a frame on the air from a peer node.
+ *
+ * Blocks while the medium's event queue is full, which paces senders to the
+ * rate the simulated ISR can deliver.
+ *
+ * @param node Sending node.
+ * @param frame Frame to send (frame[0] is the PSDU length, including the 2-byte FCS).
+ */
+esp_err_t ieee802154_sim_node_transmit(int node, const uint8_t *frame);
+
+/**
+ * @brief Get the medium counters.
+ */
+esp_err_t ieee802154_sim_get_stats(ieee802154_sim_stats_t *stats);
+
+/**
+ * @brief Remove every peer node, restore a quiet, lossless, zero-latency medium and clear the counters.
+ *
+ * Waits until frames already on the air have been delivered.
+ */
+void ieee802154_sim_reset(void);
+
+#endif // IEEE802154_SIM_H
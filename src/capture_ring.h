@@ -0,0 +1,234 @@
+#ifndef CAPTURE_RING_H
+#define CAPTURE_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_ieee802154.h"
+
+/*
+ * Fixed-size capture ring for unattended logging.
+ *
+ * The ring is one contiguous image: a header followed by a circular data area,
+ * so a RAM copy or a flash dump of it can be decoded as is (see
+ * tools/capture_to_pcap.py). The oldest records are evicted to make room.
+ *
+ * Each record is length-prefixed and delta-timestamped:
+ *
+ *   [PSDU length, 1 byte][time since the previous record in us, LEB128]
+ *   [channel][RSSI][LQI][PSDU, FCS included]
+ *
+ * Only the oldest and newest record times are kept in the header; evicting a
+ * record moves the oldest time on by the delta of the record after it.
+ * Multi-byte header fields are in host byte order (little endian on every
+ * ESP32 and on the usual hosts).
+ */
+
+#define CAPTURE_RING_MAGIC 0x52433449 // "I4CR"
+#define CAPTURE_RING_VERSION 1
+
+#define CAPTURE_RING_FLAG_TRIGGERED 0x01 // trigger_time_us is set
+#define CAPTURE_RING_FLAG_FROZEN 0x02    // Recording has stopped
+
+#define CAPTURE_RING_META_LEN 3 // Channel, RSSI, LQI
+#define CAPTURE_RING_VARINT_MAX 10
+#define CAPTURE_RING_RECORD_MAX (1 + CAPTURE_RING_VARINT_MAX + CAPTURE_RING_META_LEN + 127)
+
+typedef struct {
+    uint32_t magic;          // CAPTURE_RING_MAGIC
+    uint16_t version;        // CAPTURE_RING_VERSION
+    uint16_t header_len;     // Offset of the data area in the image
+    uint32_t capacity;       // Data area bytes
+    uint32_t head;           // Data offset of the next record
+    uint32_t tail;           // Data offset of the oldest record
+    uint32_t used;           // Bytes from tail to head
+    uint32_t records;        // Records in the ring
+    uint32_t flags;          // CAPTURE_RING_FLAG_*
+    int64_t tail_time_us;    // Time of the oldest record
+    int64_t head_time_us;    // Time of the newest record
+    int64_t epoch_offset_us; // Record time + offset = Unix time in microseconds
+    int64_t trigger_time_us; // Time of the trigger, if CAPTURE_RING_FLAG_TRIGGERED
+} capture_ring_t;
+
+typedef struct {
+    uint32_t pos;     // Data offset of the next record
+    uint32_t left;    // Records not read yet
+    int64_t time_us;  // Time of the last record read
+} capture_ring_iter_t;
+
+static inline uint8_t *capture_ring_data(capture_ring_t *ring) {
+    return (uint8_t *)ring + ring->header_len;
+}
+
+// Copy in or out of the data area at pos, wrapping at the end; returns the position after it
+static inline uint32_t capture_ring_put(capture_ring_t *ring, uint32_t pos, const uint8_t *src, uint32_t len) {
+    uint32_t first = ring->capacity - pos < len ? ring->capacity - pos : len;
+    memcpy(capture_ring_data(ring) + pos, src, first);
+    memcpy(capture_ring_data(ring), src + first, len - first);
+    pos += len;
+    return pos >= ring->capacity ? pos - ring->capacity : pos;
+}
+
+static inline uint32_t capture_ring_get(capture_ring_t *ring, uint32_t pos, uint8_t *dst, uint32_t len) {
+    uint32_t first = ring->capacity - pos < len ? ring->capacity - pos : len;
+    memcpy(dst, capture_ring_data(ring) + pos, first);
+    memcpy(dst + first, capture_ring_data(ring), len - first);
+    pos += len;
+    return pos >= ring->capacity ? pos - ring->capacity : pos;
+}
+
+static inline uint32_t capture_ring_varint_encode(uint8_t *out, uint64_t value) {
+    uint32_t len = 0;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[len++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return len;
+}
+
+// Decode the header of the record at pos: PSDU length and delta; returns the position of the channel byte
+static inline uint32_t capture_ring_read_prefix(capture_ring_t *ring, uint32_t pos, uint8_t *psdu_len,
+                                                uint64_t *delta_us) {
+    uint8_t byte;
+    pos = capture_ring_get(ring, pos, psdu_len, 1);
+    *delta_us = 0;
+    for (uint32_t shift = 0; shift < 7 * CAPTURE_RING_VARINT_MAX; shift += 7) {
+        pos = capture_ring_get(ring, pos, &byte, 1);
+        *delta_us |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief Initialize an empty ring over an image of image_len bytes (header included).
+ *
+ * @return false if the image cannot hold the header and one largest record.
+ */
+static inline bool capture_ring_init(capture_ring_t *ring, size_t image_len) {
+    if (image_len < sizeof(capture_ring_t) + CAPTURE_RING_RECORD_MAX || image_len - sizeof(capture_ring_t) > UINT32_MAX) {
+        return false;
+    }
+    memset(ring, 0, sizeof(*ring));
+    ring->magic = CAPTURE_RING_MAGIC;
+    ring->version = CAPTURE_RING_VERSION;
+    ring->header_len = sizeof(capture_ring_t);
+    ring->capacity = (uint32_t)(image_len - sizeof(capture_ring_t));
+    return true;
+}
+
+/**
+ * @brief Image bytes in use: the header and the whole data area.
+ */
+static inline size_t capture_ring_image_len(const capture_ring_t *ring) {
+    return (size_t)ring->header_len + ring->capacity;
+}
+
+/**
+ * @brief Drop the oldest record.
+ */
+static inline void capture_ring_evict(capture_ring_t *ring) {
+    uint8_t psdu_len;
+    uint64_t delta_us;
+    uint32_t pos = capture_ring_read_prefix(ring, ring->tail, &psdu_len, &delta_us);
+    uint32_t len = (pos >= ring->tail ? pos - ring->tail : pos + ring->capacity - ring->tail) +
+                   CAPTURE_RING_META_LEN + psdu_len;
+    ring->tail += len;
+    if (ring->tail >= ring->capacity) {
+        ring->tail -= ring->capacity;
+    }
+    ring->used -= len;
+    ring->records--;
+    if (ring->records > 0) {
+        capture_ring_read_prefix(ring, ring->tail, &psdu_len, &delta_us);
+        ring->tail_time_us += (int64_t)delta_us;
+    }
+}
+
+/**
+ * @brief Append a raw frame, evicting the oldest records as needed.
+ *
+ * @param frame Raw frame (frame[0] is the PSDU length, at most 127).
+ * @param frame_info Channel, RSSI and LQI.
+ * @param time_us Receive time; earlier than the newest record counts as the same time.
+ * @return Number of records evicted.
+ */
+static inline uint32_t capture_ring_append(capture_ring_t *ring, const uint8_t *frame,
+                                           const esp_ieee802154_frame_info_t *frame_info, int64_t time_us) {
+    uint8_t prefix[1 + CAPTURE_RING_VARINT_MAX];
+    uint8_t meta[CAPTURE_RING_META_LEN] = { frame_info->channel, (uint8_t)frame_info->rssi, frame_info->lqi };
+    uint8_t psdu_len = frame[0] & 0x7F;
+
+    uint64_t delta_us = 0;
+    if (ring->records > 0 && time_us > ring->head_time_us) {
+        delta_us = (uint64_t)(time_us - ring->head_time_us);
+    }
+    prefix[0] = psdu_len;
+    uint32_t prefix_len = 1 + capture_ring_varint_encode(&prefix[1], delta_us);
+    uint32_t len = prefix_len + sizeof(meta) + psdu_len;
+
+    uint32_t evicted = 0;
+    while (ring->capacity - ring->used < len) {
+        capture_ring_evict(ring);
+        evicted++;
+    }
+
+    uint32_t pos = capture_ring_put(ring, ring->head, prefix, prefix_len);
+    pos = capture_ring_put(ring, pos, meta, sizeof(meta));
+    ring->head = capture_ring_put(ring, pos, &frame[1], psdu_len);
+    ring->used += len;
+    if (ring->records++ == 0) {
+        ring->tail_time_us = time_us;
+        ring->head_time_us = time_us;
+    } else {
+        ring->head_time_us += (int64_t)delta_us;
+    }
+    return evicted;
+}
+
+/**
+ * @brief Start reading the records, oldest first.
+ */
+static inline void capture_ring_iter_begin(const capture_ring_t *ring, capture_ring_iter_t *iter) {
+    iter->pos = ring->tail;
+    iter->left = ring->records;
+    iter->time_us = ring->tail_time_us;
+}
+
+/**
+ * @brief Read the next record.
+ *
+ * @param frame Raw frame out, at least 128 bytes (frame[0] is the PSDU length).
+ * @param frame_info Channel, RSSI, LQI and timestamp out.
+ * @return false when every record has been read.
+ */
+static inline bool capture_ring_iter_next(capture_ring_t *ring, capture_ring_iter_t *iter, uint8_t *frame,
+                                          esp_ieee802154_frame_info_t *frame_info) {
+    if (iter->left == 0) {
+        return false;
+    }
+    uint8_t meta[CAPTURE_RING_META_LEN];
+    uint64_t delta_us;
+    uint32_t pos = capture_ring_read_prefix(ring, iter->pos, &frame[0], &delta_us);
+    pos = capture_ring_get(ring, pos, meta, sizeof(meta));
+    iter->pos = capture_ring_get(ring, pos, &frame[1], frame[0]);
+    // The first record's delta points at an evicted record; the header time already covers it
+    if (iter->left != ring->records) {
+        iter->time_us += (int64_t)delta_us;
+    }
+    iter->left--;
+
+    memset(frame_info, 0, sizeof(*frame_info));
+    frame_info->channel = meta[0];
+    frame_info->rssi = (int8_t)meta[1];
+    frame_info->lqi = meta[2];
+    frame_info->timestamp = (uint64_t)iter->time_us;
+    return true;
+}
+
+#endif // CAPTURE_RING_H
@@ -0,0 +1,122 @@
+#ifndef DEDUPE_CACHE_H
+#define DEDUPE_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ieee802154_transceiver.h"
+
+/*
+ * Cache of recently received frames, to drop retransmissions and echoes.
+ *
+ * A frame is identified by its type, source PAN, source address and sequence
+ * number. Entries live in a fixed table; a key hashes to a home entry and may
+ * sit in any of the DEDUPE_CACHE_PROBES entries from there. An entry older
+ * than the expiry counts as free, and when the whole probe window is in use
+ * the oldest entry is replaced, so lookups and inserts are bounded and the
+ * table never needs sweeping.
+ *
+ * Frames without a sequence number or a source address (acknowledgments)
+ * have no usable identity and are never treated as duplicates.
+ */
+
+#define DEDUPE_CACHE_PROBES 4
+
+typedef struct {
+    uint64_t addr;   // Source address, over-the-air byte order read as little-endian
+    uint16_t pan_id; // Source PAN ID, the destination PAN ID when compressed
+    uint8_t seq;
+    uint8_t kind;    // Frame type | source address length << 3, never 0 for a key
+} dedupe_key_t;
+
+typedef struct {
+    dedupe_key_t key; // kind 0 for a free entry
+    int64_t time_us;  // When the frame was first seen
+} dedupe_entry_t;
+
+typedef struct {
+    dedupe_entry_t *entries;
+    uint32_t size;
+} dedupe_cache_t;
+
+/**
+ * @brief Initialize a cache over caller-provided storage of size entries.
+ */
+static inline void dedupe_cache_init(dedupe_cache_t *cache, dedupe_entry_t *entries, uint32_t size) {
+    memset(entries, 0, size * sizeof(entries[0]));
+    cache->entries = entries;
+    cache->size = size;
+}
+
+/**
+ * @brief Build the identity of a decoded frame.
+ *
+ * @return false if the frame has no sequence number or no source address.
+ */
+static inline bool dedupe_cache_key(const ieee802154_transceiver_header_t *header, dedupe_key_t *key) {
+    const uint8_t *src_addr = ieee802154_transceiver_header_src_addr(header);
+    if (!src_addr || !ieee802154_transceiver_header_seq(header, &key->seq)) {
+        return false;
+    }
+    if (!ieee802154_transceiver_header_src_pan(header, &key->pan_id) &&
+        !ieee802154_transceiver_header_dest_pan(header, &key->pan_id)) {
+        key->pan_id = 0xffff;
+    }
+    key->addr = 0;
+    for (int i = header->src_addr_len - 1; i >= 0; i--) {
+        key->addr = (key->addr << 8) | src_addr[i];
+    }
+    key->kind = ieee802154_transceiver_header_frame_type(header) | (header->src_addr_len << 3);
+    return true;
+}
+
+static inline bool dedupe_key_equal(const dedupe_key_t *a, const dedupe_key_t *b) {
+    return a->addr == b->addr && a->pan_id == b->pan_id && a->seq == b->seq && a->kind == b->kind;
+}
+
+// Home entry of a key: mix the fields, then scale the hash to the table size without a division
+static inline uint32_t dedupe_cache_home(const dedupe_cache_t *cache, const dedupe_key_t *key) {
+    uint64_t hash = key->addr * 0x9e3779b97f4a7c15ULL;
+    hash ^= ((uint64_t)key->pan_id << 16 | (uint64_t)key->seq << 8 | key->kind) * 0xc2b2ae3d27d4eb4fULL;
+    hash ^= hash >> 29;
+    return (uint32_t)(((hash >> 32) * cache->size) >> 32);
+}
+
+/**
+ * @brief Look a frame up and remember it.
+ *
+ * @param now_us Receive time of the frame.
+ * @param expiry_us How long a frame is remembered.
+ * @return true if the same frame was seen less than expiry_us ago.
+ */
+static inline bool dedupe_cache_check(dedupe_cache_t *cache, const dedupe_key_t *key, int64_t now_us,
+                                      int64_t expiry_us) {
+    uint32_t index = dedupe_cache_home(cache, key);
+    dedupe_entry_t *victim = NULL;
+    bool victim_free = false;
+
+    // The whole window is searched: a live match may sit past an entry that expired since
+    for (uint32_t probe = 0; probe < DEDUPE_CACHE_PROBES && probe < cache->size; probe++) {
+        dedupe_entry_t *entry = &cache->entries[index];
+        bool live = entry->key.kind != 0 && now_us - entry->time_us < expiry_us;
+        if (live && dedupe_key_equal(&entry->key, key)) {
+            return true;
+        }
+        // Reuse the first free or expired entry, otherwise the oldest
+        if (!live && !victim_free) {
+            victim = entry;
+            victim_free = true;
+        } else if (live && !victim_free && (!victim || entry->time_us < victim->time_us)) {
+            victim = entry;
+        }
+        index = index + 1 < cache->size ? index + 1 : 0;
+    }
+
+    victim->key = *key;
+    victim->time_us = now_us;
+    return false;
+}
+
+#endif // DEDUPE_CACHE_H
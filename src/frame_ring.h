@@ -0,0 +1,109 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/*
+ * Single-producer/single-consumer ring of fixed-size slots.
+ *
+ * The producer (receive ISR) fills a slot in place and publishes it, the
+ * consumer (receive task) reads slots in place and releases them. No kernel
+ * lock is taken: each side only writes its own position counter.
+ *
+ * Positions run over [0, 2 * depth) so that a full ring (head - tail == depth)
+ * can be told apart from an empty one (head == tail) for any depth, without
+ * a division on the hot path.
+ */
+typedef struct {
+    uint8_t *slots;             // depth * slot_size bytes
+    size_t slot_size;
+    uint32_t depth;
+    atomic_uint_least32_t head; // Written by the producer only
+    atomic_uint_least32_t tail; // Written by the consumer only
+} frame_ring_t;
+
+static inline uint32_t frame_ring_wrap(const frame_ring_t *ring, uint32_t pos) {
+    return (pos >= 2 * ring->depth) ? pos - 2 * ring->depth : pos;
+}
+
+static inline void *frame_ring_slot(const frame_ring_t *ring, uint32_t pos) {
+    uint32_t index = (pos >= ring->depth) ? pos - ring->depth : pos;
+    return ring->slots + (size_t)index * ring->slot_size;
+}
+
+static inline uint32_t frame_ring_distance(const frame_ring_t *ring, uint32_t head, uint32_t tail) {
+    return (head >= tail) ? head - tail : head + 2 * ring->depth - tail;
+}
+
+/**
+ * @brief Initialize a ring over caller-provided storage of depth * slot_size bytes.
+ */
+static inline void frame_ring_init(frame_ring_t *ring, void *storage, size_t slot_size, uint32_t depth) {
+    ring->slots = (uint8_t *)storage;
+    ring->slot_size = slot_size;
+    ring->depth = depth;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+}
+
+/**
+ * @brief Producer: get the next free slot, or NULL if the ring is full.
+ *
+ * The slot is not visible to the consumer until frame_ring_commit() is called.
+ */
+static inline void *frame_ring_acquire(frame_ring_t *ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (frame_ring_distance(ring, head, tail) >= ring->depth) {
+        return NULL;
+    }
+    return frame_ring_slot(ring, head);
+}
+
+/**
+ * @brief Producer: publish the slot returned by frame_ring_acquire().
+ *
+ * @return true if the consumer had already drained every earlier slot, i.e.
+ *         it may be waiting and should be woken.
+ */
+static inline bool frame_ring_commit(frame_ring_t *ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, frame_ring_wrap(ring, head + 1), memory_order_seq_cst);
+    // Read tail after publishing head; pairs with the consumer storing tail
+    // before re-reading head, so one of the two always sees the other.
+    return atomic_load_explicit(&ring->tail, memory_order_seq_cst) == head;
+}
+
+/**
+ * @brief Consumer: get the index-th pending slot (0 = oldest), or NULL.
+ */
+static inline void *frame_ring_peek(frame_ring_t *ring, uint32_t index) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_seq_cst);
+    if (index >= frame_ring_distance(ring, head, tail)) {
+        return NULL;
+    }
+    return frame_ring_slot(ring, frame_ring_wrap(ring, tail + index));
+}
+
+/**
+ * @brief Consumer: return the oldest count slots to the producer.
+ */
+static inline void frame_ring_release(frame_ring_t *ring, uint32_t count) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, frame_ring_wrap(ring, tail + count), memory_order_seq_cst);
+}
+
+/**
+ * @brief Number of slots currently pending for the consumer.
+ */
+static inline uint32_t frame_ring_count(frame_ring_t *ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return frame_ring_distance(ring, head, tail);
+}
+
+#endif // FRAME_RING_H
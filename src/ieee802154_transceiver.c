@@ -1,322 +1,2105 @@
-#include <stdio.h>
-#include <string.h>
-
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "freertos/message_buffer.h"
-
-#include "esp_log.h"
-#include "esp_ieee802154.h"
-
-#include "ieee802154_transceiver.h"
-
-#define TAG "IEEE802154_TRANSCEIVER"
-#define MAX_FRAME_LEN 128
-
-// Structure to hold frame data and frame info
-typedef struct {
-    uint8_t frame[MAX_FRAME_LEN]; // Raw frame data
-    esp_ieee802154_frame_info_t frame_info; // Frame info (RSSI, LQI, etc.)
-} frame_data_t;
-
-// Global state
-static StreamBufferHandle_t message_buffer = NULL;
-static ieee802154_transceiver_rx_callback_t rx_callback = NULL;
-static void *rx_callback_user_data = NULL;
-static TaskHandle_t rx_task_handle = NULL;
-static bool radio_enabled = false;
-
-// Transmit buffer
-static uint8_t transmit_buffer[ MAX_FRAME_LEN ] = {0};
-
-// Forward declarations
-static void receive_packet_task(void *pvParameters);
-
-/**
- * @brief Initialize the IEEE 802.15.4 radio in promiscuous mode with a specified channel.
- *
- * @param channel Channel number (11-26) to set for the transceiver.
- * @note NVS must be initialized by the user before calling this function.
- */
-esp_err_t ieee802154_transceiver_init(uint8_t channel) {
-    esp_err_t ret;
-
-    // Validate channel
-    if (channel < 11 || channel > 26) {
-        ESP_LOGE(TAG, "Invalid channel: %d", channel);
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    // Create message buffer
-    message_buffer = xMessageBufferCreate(sizeof(frame_data_t) + 4);
-    if (!message_buffer) {
-        ESP_LOGE(TAG, "Failed to create message buffer");
-        ieee802154_transceiver_deinit();
-        return ESP_ERR_NO_MEM;
-    }
-
-    // Initialize IEEE 802.15.4 radio
-    ret = esp_ieee802154_enable();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to enable IEEE 802.15.4 radio: %d", ret);
-        ieee802154_transceiver_deinit();
-        return ret;
-    }
-    radio_enabled = true;
-
-    ret = esp_ieee802154_set_coordinator(false);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set coordinator mode to false: %d", ret);
-        ieee802154_transceiver_deinit();
-        return ret;
-    }
-
-    ret = esp_ieee802154_set_promiscuous(true);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to enable promiscuous mode: %d", ret);
-        ieee802154_transceiver_deinit();
-        return ret;
-    }
-
-    ret = esp_ieee802154_set_rx_when_idle(true);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set rx when idle: %d", ret);
-        ieee802154_transceiver_deinit();
-        return ret;
-    }
-
-    ret = esp_ieee802154_set_channel(channel);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
-        ieee802154_transceiver_deinit();
-        return ret;
-    }
-
-    ret = esp_ieee802154_receive();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start receiving: %d", ret);
-        ieee802154_transceiver_deinit();
-        return ret;
-    }
-
-    // Start receive task
-    if (xTaskCreate(receive_packet_task, "RX", 1024 * 5, NULL, 5, &rx_task_handle) != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create receive task");
-        ieee802154_transceiver_deinit();
-        return ESP_ERR_NO_MEM;
-    }
-
-    ESP_LOGI(TAG, "IEEE 802.15.4 transceiver initialized on channel %d", channel);
-    return ESP_OK;
-}
-
-/**
- * @brief Deinitialize the transceiver and free resources.
- */
-esp_err_t ieee802154_transceiver_deinit(void) {
-    esp_err_t ret;
-
-    // Stop receive task
-    if (rx_task_handle) {
-        vTaskDelete(rx_task_handle);
-        rx_task_handle = NULL;
-    }
-
-    // Free message buffer
-    if (message_buffer) {
-        vMessageBufferDelete(message_buffer);
-        message_buffer = NULL;
-    }
-
-    // Disable radio
-    if (radio_enabled) {
-        ret = esp_ieee802154_disable();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to disable IEEE 802.15.4 radio: %d", ret);
-            return ret;
-        }
-        radio_enabled = false;
-    }
-
-    ESP_LOGI(TAG, "IEEE 802.15.4 transceiver deinitialized");
-    return ESP_OK;
-}
-
-/**
- * @brief Set the receive callback function.
- */
-esp_err_t ieee802154_transceiver_set_rx_callback(ieee802154_transceiver_rx_callback_t callback, void *user_data) {
-    rx_callback = callback;
-    rx_callback_user_data = user_data;
-    ESP_LOGI(TAG, "Receive callback set");
-    return ESP_OK;
-}
-
-
-
-// Internal: Transmit an IEEE 802.15.4 frame
-esp_err_t transmit_channel(const ieee802154_frame_t *frame, uint8_t channel, bool change_channel)
-{
-    bool verbose = false;
-    esp_err_t ret;
-
-    if (!frame) {
-        ESP_LOGE(TAG, "Invalid frame pointer");
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    if (change_channel) {
-        if (channel < 11 || channel > 26) {
-            ESP_LOGE(TAG, "Invalid channel: %d", channel);
-            return ESP_ERR_INVALID_ARG;
-        }
-    }
-
-    // Prepare buffer
-    memset(transmit_buffer, 0, MAX_FRAME_LEN); // Clear
-
-    // Build frame into a byte array
-    size_t len = ieee802154_frame_build(frame, transmit_buffer, false);
-    if (len == 0) {
-        ESP_LOGE(TAG, "Failed to build frame");
-        return ESP_FAIL;
-    }
-    // ESP_LOGI(TAG, "len: %d, buffer[0]: %d", len, buffer[0]);
-    // ESP_LOG_BUFFER_HEX(TAG, buffer, buffer[0]);
-
-    if (change_channel) {
-        // Set channel
-        ret = esp_ieee802154_set_channel(channel);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
-            return ret;
-        }
-    }
-
-    // Transmit frame
-    ret = esp_ieee802154_transmit( transmit_buffer, false );
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to transmit frame: %d", ret);
-        return ret;
-    }
-
-    if (verbose) {
-        if (change_channel)
-            ESP_LOGI(TAG, "Transmitted frame of %zu bytes on channel %d", len, channel);
-        else   
-            ESP_LOGI(TAG, "Transmitted frame of %zu bytes", len);
-    }
-    return ESP_OK;
-
-}
-
-
-/**
- * @brief Transmit an IEEE 802.15.4 frame on the current channel.
- */
-esp_err_t ieee802154_transceiver_transmit(const ieee802154_frame_t *frame) {
-    return transmit_channel(frame, -1, false);
-}
-
-/**
- * @brief Transmit an IEEE 802.15.4 frame on a specified channel.
- */
-esp_err_t ieee802154_transceiver_transmit_channel(const ieee802154_frame_t *frame, uint8_t channel) {
-    return transmit_channel(frame, channel, true);
-}
-
-
-
-/**
- * @brief Set the IEEE 802.15.4 channel.
- */
-esp_err_t ieee802154_transceiver_set_channel(uint8_t channel) {
-    if (channel < 11 || channel > 26) {
-        ESP_LOGE(TAG, "Invalid channel: %d", channel);
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    esp_err_t ret;
-
-    // Set channel
-    ret = esp_ieee802154_set_channel(channel);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
-        return ret;
-    }
-
-    // Start receiving
-    ret = esp_ieee802154_receive();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start receiving: %d", ret);
-        return ret;
-    }
-
-    // ESP_LOGI(TAG, "Channel set to %d", channel);
-    return ESP_OK;
-}
-
-/**
- * @brief Handle the callback for received IEEE 802.15.4 frames.
- */
-void ieee802154_transceiver_handle_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info) {
-    if (!message_buffer) {
-        esp_ieee802154_receive_handle_done(frame);
-        return;
-    }
-
-    BaseType_t higher_priority_task_woken = pdFALSE;
-
-    // Prepare packet
-    frame_data_t packet;
-    memcpy(packet.frame, frame, frame[0]);
-    packet.frame_info = *frame_info;
-
-    // Send to message buffer
-    size_t bytes_sent = xMessageBufferSendFromISR(message_buffer, &packet, sizeof(frame_data_t), &higher_priority_task_woken);
-    if (bytes_sent == 0) {
-        ESP_EARLY_LOGW(TAG, "Message buffer full, packet discarded");
-    }
-
-    esp_ieee802154_receive_handle_done(frame);
-
-    if (higher_priority_task_woken) {
-        portYIELD_FROM_ISR(higher_priority_task_woken);
-    }
-}
-
-/**
- * @brief Task to process received packets and invoke callback.
- */
-static void receive_packet_task(void *pvParameters) {
-    frame_data_t packet;
-    ieee802154_frame_t frame = {0};
-
-    ESP_LOGI(TAG, "Receive packet task started");
-
-    while (1) {
-        // Receive packet from message buffer
-        size_t read_bytes = xMessageBufferReceive(message_buffer, &packet, sizeof(frame_data_t), pdMS_TO_TICKS(10));
-        if (read_bytes != sizeof(frame_data_t)) {
-            if (read_bytes != 0) {
-                ESP_LOGE(TAG, "Invalid packet size received: %d", read_bytes);
-            }
-            continue;
-        }
-
-        // Parse frame
-        if (!ieee802154_frame_parse(packet.frame, &frame, false)) {
-            ESP_LOGE(TAG, "Failed to parse frame");
-            continue;
-        }
-
-        // Invoke callback if set
-        if (rx_callback) {
-            rx_callback(&frame, &packet.frame_info, rx_callback_user_data);
-        }
-
-        // Short delay to yield CPU
-        vTaskDelay(1 / portTICK_PERIOD_MS);
-    }
-}
-
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+#include "esp_ieee802154.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_priv.h"
+#include "frame_ring.h"
+#include "subscriber_index.h"
+#include "dedupe_cache.h"
+
+#define TAG "IEEE802154_TRANSCEIVER"
+#define MAX_FRAME_LEN 128
+#define RX_QUEUE_DEPTH CONFIG_IEEE802154_TRANSCEIVER_RX_QUEUE_DEPTH
+#define RX_BATCH_MAX CONFIG_IEEE802154_TRANSCEIVER_RX_BATCH_MAX
+#define FILTER_MAX CONFIG_IEEE802154_TRANSCEIVER_FILTER_MAX
+#define SUBSCRIBER_MAX CONFIG_IEEE802154_TRANSCEIVER_SUBSCRIBER_MAX
+#define DEDUPE_SIZE CONFIG_IEEE802154_TRANSCEIVER_DEDUPE_SIZE
+#define TX_QUEUE_DEPTH CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH
+#define TX_DONE_TIMEOUT_MS 100
+#define BACKOFF_PERIOD_US 320 // aUnitBackoffPeriod, 20 symbols
+#define BACKOFF_SPIN_MAX_US (2 * BACKOFF_PERIOD_US) // Longer backoffs sleep instead of holding the CPU
+#define STORAGE_ALIGN 8
+
+// Structure to hold frame data and frame info
+typedef struct {
+    uint8_t frame[MAX_FRAME_LEN]; // Raw frame data
+    esp_ieee802154_frame_info_t frame_info; // Frame info (RSSI, LQI, etc.)
+    int64_t rx_time_us; // transceiver_now_us() at ISR entry
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+    int64_t queued_time_us; // transceiver_now_us() when the slot was published
+#endif
+} frame_data_t;
+
+// Parsed packet handed from the receive task to the dispatch task in pipelined mode
+typedef struct {
+    frame_data_t packet;      // Copy of the receive slot, which the parsed payload points into
+    ieee802154_frame_t frame; // Parsed frame, if parse_ok
+    bool parsed;              // The receive task attempted parsing
+    bool parse_ok;
+    ieee802154_transceiver_header_t header; // Decoded over packet, if header_ok
+    bool header_ok;
+} dispatch_item_t;
+
+// Structure to hold a queued asynchronous transmission
+typedef struct {
+    uint8_t frame[MAX_FRAME_LEN]; // Built frame, frame[0] is the length
+    uint8_t channel; // 0 for the receive channel
+    ieee802154_transceiver_tx_done_callback_t done_cb;
+    void *ctx;
+    int64_t queued_time_us; // transceiver_now_us() when the request was queued
+} tx_request_t;
+
+// Structure to hold a receive subscriber
+typedef struct {
+    ieee802154_transceiver_rx_raw_callback_t callback;
+    void *user_data;
+} subscriber_t;
+
+// Receive subscribers, one bit each, with the lookup index built from their filters
+typedef struct {
+    subscriber_t subscribers[SUBSCRIBER_MAX];
+    ieee802154_transceiver_filter_t filters[SUBSCRIBER_MAX];
+    uint32_t active;
+    uint32_t catch_all;       // Subscribers without a filter
+    subscriber_index_t index; // Last: not copied between sets, always rebuilt
+} subscriber_set_t;
+
+// Global state
+static frame_ring_t rx_ring;
+static frame_data_t *rx_ring_storage = NULL;
+static ieee802154_transceiver_rx_callback_t rx_callback = NULL;
+static void *rx_callback_user_data = NULL;
+static ieee802154_transceiver_rx_raw_callback_t rx_raw_callback = NULL;
+static void *rx_raw_user_data = NULL;
+static transceiver_rx_hook_t rx_hooks[TRANSCEIVER_HOOK_MAX];
+static void *rx_hook_args[TRANSCEIVER_HOOK_MAX];
+static ieee802154_transceiver_rx_batch_callback_t rx_batch_callback = NULL;
+static void *rx_batch_user_data = NULL;
+static uint32_t rx_batch_size = 1;
+static TickType_t rx_batch_delay = 0;
+static volatile uint32_t rx_wake_threshold = 1;
+static TaskHandle_t rx_task_handle = NULL;
+static bool radio_enabled = false;
+static uint8_t rx_channel = 0;
+
+// Pipelined receive: the receive task parses into the dispatch ring, the dispatch task runs the callbacks
+static bool rx_pipelined = false;
+static frame_ring_t dispatch_ring;
+static dispatch_item_t *dispatch_ring_storage = NULL;
+static TaskHandle_t dispatch_task_handle = NULL;
+static atomic_bool parse_waiting; // The receive task waits for a free dispatch slot
+
+// Objects laid out in caller-provided storage, see storage_layout()
+typedef struct {
+    frame_data_t *rx_ring;
+    dispatch_item_t *dispatch_ring;
+    uint8_t *tx_queue;
+    StaticQueue_t *tx_queue_struct;
+    StaticTask_t *rx_tcb;
+    StackType_t *rx_stack;
+    StaticTask_t *tx_tcb;
+    StackType_t *tx_stack;
+    StaticTask_t *dispatch_tcb;
+    StackType_t *dispatch_stack;
+} static_objects_t;
+
+// Rings, transmit queue and tasks live in caller-provided storage, nothing to free
+static bool static_storage = false;
+
+// Asynchronous transmit state
+static QueueHandle_t tx_queue = NULL;
+static uint32_t tx_queue_depth = 0; // Entries in tx_queue, as configured at init
+static TaskHandle_t tx_task_handle = NULL;
+static const uint8_t *volatile tx_in_flight = NULL; // Frame the ISR reports completion for
+static ieee802154_transceiver_tx_result_t tx_isr_result; // Filled by the ISR, read by the transmit task
+static ieee802154_transceiver_tx_policy_t tx_policy;      // Read by the transmit task at the start of each frame
+static portMUX_TYPE tx_policy_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t backoff_rng = 1;                          // Backoff generator, only touched by the transmit task
+
+// Held by whoever retunes the radio: the transmit task around each frame, channel changes, surveys
+static SemaphoreHandle_t radio_mutex = NULL;
+static StaticSemaphore_t radio_mutex_buffer;
+
+// Completion of a synchronous transmission, which keeps the radio until then. Only waited for
+// when the configuration asks for it, as it needs the transmit interrupts forwarded.
+static bool tx_sync_wait = false;
+static const uint8_t *volatile sync_in_flight = NULL; // Frame the ISR reports completion for
+static volatile esp_err_t sync_status;                 // Outcome reported by the ISR
+static SemaphoreHandle_t sync_done = NULL;
+static StaticSemaphore_t sync_done_buffer;
+
+// Per-channel receive counters, written by the ISR only
+static volatile uint32_t channel_frames[16];
+static volatile uint32_t channel_bytes[16];
+static volatile uint32_t channel_drops[16];
+
+// Pipeline counters, one per ieee802154_transceiver_stats_t member
+#define STATS_COUNT (sizeof(ieee802154_transceiver_stats_t) / sizeof(uint32_t))
+#define STATS_INDEX(field) (offsetof(ieee802154_transceiver_stats_t, field) / sizeof(uint32_t))
+#define STATS_ADD(field, n) atomic_fetch_add_explicit(&stats_counters[STATS_INDEX(field)], (n), memory_order_relaxed)
+#define STATS_INC(field) STATS_ADD(field, 1)
+#define STATS_MAX(field, v) stats_max(&stats_counters[STATS_INDEX(field)], (v))
+static atomic_uint_least32_t stats_counters[STATS_COUNT];
+
+// Internal: Raise a high-water mark
+static inline void stats_max(atomic_uint_least32_t *counter, uint32_t value) {
+    uint32_t current = atomic_load_explicit(counter, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(counter, &current, value, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+// Receive filter table, read by the ISR
+static ieee802154_transceiver_filter_t filters[FILTER_MAX];
+static volatile size_t filter_count = 0;
+static portMUX_TYPE filter_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Receive subscribers. A change is made to the spare set, its index built without any lock
+// held, and the set published by swapping subscriber_set. Only the receive side reads it.
+static subscriber_set_t subscriber_sets[2];
+static subscriber_set_t *subscriber_set = &subscriber_sets[0];      // Published set
+static const subscriber_set_t *subscriber_reading = NULL;           // Set the receive side is matching against
+static volatile uint32_t subscriber_active = 0;                     // Copy of subscriber_set->active
+static portMUX_TYPE subscriber_lock = portMUX_INITIALIZER_UNLOCKED; // Guards the two pointers
+static SemaphoreHandle_t subscriber_mutex = NULL;                   // Serializes changes
+static StaticSemaphore_t subscriber_mutex_buffer;
+
+// Recently received frames, only touched by the receive task; expiry 0 disables the stage
+static dedupe_entry_t dedupe_entries[DEDUPE_SIZE];
+static dedupe_cache_t dedupe_cache = { .entries = dedupe_entries, .size = DEDUPE_SIZE };
+static volatile uint32_t dedupe_expiry_ms = 0;
+
+// Batch delivery buffers, only touched by the receive task
+static ieee802154_frame_t rx_batch_frames[RX_BATCH_MAX];
+static esp_ieee802154_frame_info_t rx_batch_infos[RX_BATCH_MAX];
+
+// Transmit buffer
+static uint8_t transmit_buffer[ MAX_FRAME_LEN ] = {0};
+
+// Forward declarations
+static void receive_packet_task(void *pvParameters);
+static void dispatch_packet_task(void *pvParameters);
+static void transmit_packet_task(void *pvParameters);
+
+// Internal: Check the parameters of a task
+static bool task_config_valid(const ieee802154_transceiver_task_config_t *task) {
+#if !CONFIG_IDF_TARGET_LINUX
+    if (task->core_id < IEEE802154_TRANSCEIVER_NO_AFFINITY || task->core_id >= portNUM_PROCESSORS) {
+        return false;
+    }
+#endif
+    return task->stack_size >= 1024 && task->priority < configMAX_PRIORITIES;
+}
+
+// Internal: Queue depths of a configuration, 0 meaning the Kconfig default
+static uint32_t config_rx_depth(const ieee802154_transceiver_config_t *config) {
+    return config->rx_queue_depth ? config->rx_queue_depth : RX_QUEUE_DEPTH;
+}
+
+static uint32_t config_tx_depth(const ieee802154_transceiver_config_t *config) {
+    return config->tx_queue_depth ? config->tx_queue_depth : TX_QUEUE_DEPTH;
+}
+
+// Internal: Check a transmit policy
+static bool tx_policy_valid(const ieee802154_transceiver_tx_policy_t *policy) {
+    return policy->max_csma_backoffs <= 5 && policy->min_be <= policy->max_be && policy->max_be <= 8 &&
+           policy->max_retries <= 7;
+}
+
+// Internal: Check a configuration, storage aside
+static bool config_valid(const ieee802154_transceiver_config_t *config) {
+    if (config->channel < 11 || config->channel > 26) {
+        ESP_LOGE(TAG, "Invalid channel: %d", config->channel);
+        return false;
+    }
+    if (config_rx_depth(config) < 2 || config_rx_depth(config) > 256 ||
+        config_tx_depth(config) > 64) {
+        ESP_LOGE(TAG, "Invalid queue depth");
+        return false;
+    }
+    if (rx_batch_callback && rx_batch_size > config_rx_depth(config)) {
+        ESP_LOGE(TAG, "Receive queue shallower than the batch size: %" PRIu32, rx_batch_size);
+        return false;
+    }
+    if (!task_config_valid(&config->rx_task) || !task_config_valid(&config->tx_task) ||
+        (config->pipelined && !task_config_valid(&config->dispatch_task))) {
+        ESP_LOGE(TAG, "Invalid task configuration");
+        return false;
+    }
+    if (!tx_policy_valid(&config->tx_policy)) {
+        ESP_LOGE(TAG, "Invalid transmit policy");
+        return false;
+    }
+    return true;
+}
+
+// Internal: Reserve an aligned piece of the storage at base, or only count it if base is NULL
+static void *storage_take(uint8_t *base, size_t *used, size_t len) {
+    size_t offset = (*used + STORAGE_ALIGN - 1) & ~(size_t)(STORAGE_ALIGN - 1);
+    *used = offset + len;
+    return base ? base + offset : NULL;
+}
+
+// Internal: Lay the rings, transmit queue and tasks out in storage at base; returns the bytes used
+static size_t storage_layout(const ieee802154_transceiver_config_t *config, uint8_t *base,
+                             static_objects_t *objects) {
+    size_t used = 0;
+    uint32_t rx_depth = config_rx_depth(config);
+
+    memset(objects, 0, sizeof(*objects));
+    objects->rx_ring = storage_take(base, &used, rx_depth * sizeof(frame_data_t));
+    objects->tx_queue = storage_take(base, &used, config_tx_depth(config) * sizeof(tx_request_t));
+    objects->tx_queue_struct = storage_take(base, &used, sizeof(StaticQueue_t));
+    objects->rx_tcb = storage_take(base, &used, sizeof(StaticTask_t));
+    objects->rx_stack = storage_take(base, &used, config->rx_task.stack_size);
+    objects->tx_tcb = storage_take(base, &used, sizeof(StaticTask_t));
+    objects->tx_stack = storage_take(base, &used, config->tx_task.stack_size);
+    if (config->pipelined) {
+        objects->dispatch_ring = storage_take(base, &used, rx_depth * sizeof(dispatch_item_t));
+        objects->dispatch_tcb = storage_take(base, &used, sizeof(StaticTask_t));
+        objects->dispatch_stack = storage_take(base, &used, config->dispatch_task.stack_size);
+    }
+    return used;
+}
+
+// Internal: Create a task as configured, pinned to a core if asked to, on the given stack if any
+static BaseType_t task_create(TaskFunction_t function, const char *name,
+                              const ieee802154_transceiver_task_config_t *task,
+                              StackType_t *stack, StaticTask_t *tcb, TaskHandle_t *handle) {
+#if CONFIG_IDF_TARGET_LINUX
+    if (stack) {
+        *handle = xTaskCreateStatic(function, name, task->stack_size, NULL, task->priority, stack, tcb);
+        return *handle ? pdPASS : pdFAIL;
+    }
+    return xTaskCreate(function, name, task->stack_size, NULL, task->priority, handle);
+#else
+    BaseType_t core_id = task->core_id == IEEE802154_TRANSCEIVER_NO_AFFINITY ? tskNO_AFFINITY : task->core_id;
+    if (stack) {
+        *handle = xTaskCreateStaticPinnedToCore(function, name, task->stack_size, NULL, task->priority,
+                                                stack, tcb, core_id);
+        return *handle ? pdPASS : pdFAIL;
+    }
+    return xTaskCreatePinnedToCore(function, name, task->stack_size, NULL, task->priority, handle, core_id);
+#endif
+}
+
+// Internal: Program the radio's address filter and acknowledgment behavior
+static esp_err_t radio_set_address(const ieee802154_transceiver_address_t *address) {
+    esp_err_t ret = esp_ieee802154_set_panid(address->pan_id);
+    if (ret == ESP_OK) {
+        ret = esp_ieee802154_set_short_address(address->short_addr);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_ieee802154_set_extended_address(address->ext_addr);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_ieee802154_set_pending_mode(address->pending_mode);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set the radio address: %d", ret);
+    }
+    return ret;
+}
+
+/**
+ * @brief Initialize the IEEE 802.15.4 radio in promiscuous mode with a specified channel.
+ *
+ * @param channel Channel number (11-26) to set for the transceiver.
+ * @note NVS must be initialized by the user before calling this function.
+ */
+esp_err_t ieee802154_transceiver_init(uint8_t channel) {
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(channel);
+    return ieee802154_transceiver_init_with_config(&config);
+}
+
+/**
+ * @brief Get the static storage size a configuration needs.
+ */
+esp_err_t ieee802154_transceiver_get_storage_size(const ieee802154_transceiver_config_t *config, size_t *size) {
+    if (!config || !size || !config_valid(config)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    static_objects_t objects;
+    *size = storage_layout(config, NULL, &objects);
+    return ESP_OK;
+}
+
+/**
+ * @brief Initialize the IEEE 802.15.4 radio from a configuration.
+ */
+esp_err_t ieee802154_transceiver_init_with_config(const ieee802154_transceiver_config_t *config) {
+    esp_err_t ret;
+
+    if (!config) {
+        ESP_LOGE(TAG, "Invalid configuration pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!config_valid(config)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t channel = config->channel;
+    uint32_t rx_depth = config_rx_depth(config);
+    ieee802154_transceiver_set_tx_policy(&config->tx_policy);
+
+    // Lay everything out in the caller's storage, when given
+    static_objects_t objects = {0};
+    if (config->storage) {
+        const ieee802154_transceiver_storage_t *storage = config->storage;
+        if (!storage->buffer || (uintptr_t)storage->buffer % STORAGE_ALIGN != 0) {
+            ESP_LOGE(TAG, "Invalid storage buffer");
+            return ESP_ERR_INVALID_ARG;
+        }
+        size_t needed = storage_layout(config, NULL, &objects);
+        if (storage->size < needed) {
+            ESP_LOGE(TAG, "Storage too small: %u bytes, %u needed", (unsigned)storage->size, (unsigned)needed);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        storage_layout(config, storage->buffer, &objects);
+        static_storage = true;
+    }
+
+    // Create receive ring
+    rx_ring_storage = static_storage ? objects.rx_ring : calloc(rx_depth, sizeof(frame_data_t));
+    if (!rx_ring_storage) {
+        ESP_LOGE(TAG, "Failed to allocate receive ring");
+        ieee802154_transceiver_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+    frame_ring_init(&rx_ring, rx_ring_storage, sizeof(frame_data_t), rx_depth);
+
+    // Create the ring between the parse and dispatch stages
+    if (config->pipelined) {
+        dispatch_ring_storage = static_storage ? objects.dispatch_ring : calloc(rx_depth, sizeof(dispatch_item_t));
+        if (!dispatch_ring_storage) {
+            ESP_LOGE(TAG, "Failed to allocate dispatch ring");
+            ieee802154_transceiver_deinit();
+            return ESP_ERR_NO_MEM;
+        }
+        frame_ring_init(&dispatch_ring, dispatch_ring_storage, sizeof(dispatch_item_t), rx_depth);
+        atomic_store(&parse_waiting, false);
+    }
+    rx_pipelined = config->pipelined;
+
+    // Create transmit queue
+    tx_queue = static_storage ?
+               xQueueCreateStatic(config_tx_depth(config), sizeof(tx_request_t), objects.tx_queue,
+                                  objects.tx_queue_struct) :
+               xQueueCreate(config_tx_depth(config), sizeof(tx_request_t));
+    if (!tx_queue) {
+        ESP_LOGE(TAG, "Failed to create transmit queue");
+        ieee802154_transceiver_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+    tx_queue_depth = config_tx_depth(config);
+    radio_mutex = xSemaphoreCreateMutexStatic(&radio_mutex_buffer);
+    sync_done = xSemaphoreCreateBinaryStatic(&sync_done_buffer);
+    tx_sync_wait = config->tx_sync_wait;
+
+    // Initialize IEEE 802.15.4 radio
+    ret = esp_ieee802154_enable();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enable IEEE 802.15.4 radio: %d", ret);
+        ieee802154_transceiver_deinit();
+        return ret;
+    }
+    radio_enabled = true;
+
+    ret = esp_ieee802154_set_coordinator(config->coordinator);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set coordinator mode: %d", ret);
+        ieee802154_transceiver_deinit();
+        return ret;
+    }
+
+    ret = esp_ieee802154_set_promiscuous(config->promiscuous);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set promiscuous mode: %d", ret);
+        ieee802154_transceiver_deinit();
+        return ret;
+    }
+
+    ret = esp_ieee802154_set_rx_when_idle(config->rx_when_idle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set rx when idle: %d", ret);
+        ieee802154_transceiver_deinit();
+        return ret;
+    }
+
+    if (config->tx_power != IEEE802154_TRANSCEIVER_TX_POWER_KEEP) {
+        ret = esp_ieee802154_set_txpower(config->tx_power);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set transmit power %d dBm: %d", config->tx_power, ret);
+            ieee802154_transceiver_deinit();
+            return ret;
+        }
+    }
+
+    if (config->address) {
+        ret = radio_set_address(config->address);
+        if (ret != ESP_OK) {
+            ieee802154_transceiver_deinit();
+            return ret;
+        }
+    }
+
+    ret = esp_ieee802154_set_channel(channel);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
+        ieee802154_transceiver_deinit();
+        return ret;
+    }
+    rx_channel = channel;
+
+    ret = esp_ieee802154_receive();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start receiving: %d", ret);
+        ieee802154_transceiver_deinit();
+        return ret;
+    }
+
+    // Start dispatch task, then the receive task feeding it
+    if (rx_pipelined && task_create(dispatch_packet_task, "RX_DISPATCH", &config->dispatch_task,
+                                    objects.dispatch_stack, objects.dispatch_tcb, &dispatch_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create dispatch task");
+        ieee802154_transceiver_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Start receive task
+    if (task_create(receive_packet_task, "RX", &config->rx_task, objects.rx_stack, objects.rx_tcb,
+                    &rx_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create receive task");
+        ieee802154_transceiver_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Start transmit task
+    if (task_create(transmit_packet_task, "TX", &config->tx_task, objects.tx_stack, objects.tx_tcb,
+                    &tx_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create transmit task");
+        ieee802154_transceiver_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "IEEE 802.15.4 transceiver initialized on channel %d%s%s%s", channel,
+             config->promiscuous ? "" : " (address filtering)",
+             rx_pipelined ? " (pipelined)" : "", static_storage ? " (static)" : "");
+    return ESP_OK;
+}
+
+/**
+ * @brief Deinitialize the transceiver and free resources.
+ */
+esp_err_t ieee802154_transceiver_deinit(void) {
+    esp_err_t ret;
+
+    // Stop receive task
+    if (rx_task_handle) {
+        vTaskDelete(rx_task_handle);
+        rx_task_handle = NULL;
+    }
+
+    // Stop dispatch task
+    if (dispatch_task_handle) {
+        vTaskDelete(dispatch_task_handle);
+        dispatch_task_handle = NULL;
+    }
+
+    // Stop transmit task
+    if (tx_task_handle) {
+        vTaskDelete(tx_task_handle);
+        tx_task_handle = NULL;
+    }
+    tx_in_flight = NULL;
+
+    // Free transmit queue
+    if (tx_queue) {
+        vQueueDelete(tx_queue);
+        tx_queue = NULL;
+        tx_queue_depth = 0;
+    }
+    if (radio_mutex) {
+        vSemaphoreDelete(radio_mutex);
+        radio_mutex = NULL;
+    }
+    if (sync_done) {
+        vSemaphoreDelete(sync_done);
+        sync_done = NULL;
+    }
+    sync_in_flight = NULL;
+    tx_sync_wait = false;
+
+    // Free receive ring
+    if (rx_ring_storage && !static_storage) {
+        free(rx_ring_storage);
+    }
+    rx_ring_storage = NULL;
+
+    // Free dispatch ring
+    if (dispatch_ring_storage && !static_storage) {
+        free(dispatch_ring_storage);
+    }
+    dispatch_ring_storage = NULL;
+    rx_pipelined = false;
+    static_storage = false;
+
+    // Disable radio
+    if (radio_enabled) {
+        ret = esp_ieee802154_disable();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to disable IEEE 802.15.4 radio: %d", ret);
+            return ret;
+        }
+        radio_enabled = false;
+    }
+
+    ESP_LOGI(TAG, "IEEE 802.15.4 transceiver deinitialized");
+    return ESP_OK;
+}
+
+/**
+ * @brief Set the receive callback function.
+ */
+esp_err_t ieee802154_transceiver_set_rx_callback(ieee802154_transceiver_rx_callback_t callback, void *user_data) {
+    rx_callback = callback;
+    rx_callback_user_data = user_data;
+    ESP_LOGI(TAG, "Receive callback set");
+    return ESP_OK;
+}
+
+/**
+ * @brief Set the raw receive callback function.
+ */
+esp_err_t ieee802154_transceiver_set_rx_raw_callback(ieee802154_transceiver_rx_raw_callback_t callback, void *user_data) {
+    rx_raw_callback = callback;
+    rx_raw_user_data = user_data;
+    ESP_LOGI(TAG, "Raw receive callback set");
+    return ESP_OK;
+}
+
+// Internal: Install the receive hook of a feature (bridge, capture)
+void transceiver_set_rx_hook(transceiver_hook_slot_t slot, transceiver_rx_hook_t hook, void *arg) {
+    rx_hooks[slot] = NULL;
+    rx_hook_args[slot] = arg;
+    rx_hooks[slot] = hook;
+}
+
+// Internal: Run the installed receive hooks on a queued frame
+static inline void run_rx_hooks(const frame_data_t *packet, const ieee802154_transceiver_header_t *header) {
+    for (int slot = 0; slot < TRANSCEIVER_HOOK_MAX; slot++) {
+        transceiver_rx_hook_t hook = rx_hooks[slot];
+        if (hook) {
+            hook(packet->frame, header, &packet->frame_info, packet->rx_time_us, rx_hook_args[slot]);
+        }
+    }
+}
+
+/**
+ * @brief Set the batched receive callback function.
+ */
+esp_err_t ieee802154_transceiver_set_rx_batch_callback(ieee802154_transceiver_rx_batch_callback_t callback,
+                                                       size_t max_batch, uint32_t max_delay_ms,
+                                                       void *user_data) {
+    // Once initialized, a batch must also fit in the receive ring
+    uint32_t rx_depth = rx_ring_storage ? rx_ring.depth : RX_BATCH_MAX;
+    if (callback && (max_batch < 1 || max_batch > RX_BATCH_MAX || max_batch > rx_depth)) {
+        ESP_LOGE(TAG, "Invalid batch size: %zu", max_batch);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    rx_batch_callback = NULL; // Stop batching while the parameters change
+    rx_batch_size = callback ? max_batch : 1;
+    // Rounded up to whole ticks: pdMS_TO_TICKS() would turn a delay below one tick into none
+    rx_batch_delay = max_delay_ms / portTICK_PERIOD_MS + (max_delay_ms % portTICK_PERIOD_MS != 0);
+    rx_batch_user_data = user_data;
+    rx_wake_threshold = rx_batch_size;
+    rx_batch_callback = callback;
+
+    TaskHandle_t consumer = rx_pipelined ? dispatch_task_handle : rx_task_handle;
+    if (consumer) {
+        xTaskNotifyGive(consumer); // Re-evaluate pending frames with the new settings
+    }
+    ESP_LOGI(TAG, "Receive batch callback set (max_batch=%zu, max_delay=%" PRIu32 " ms)", max_batch, max_delay_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief Enable or disable duplicate frame suppression.
+ */
+esp_err_t ieee802154_transceiver_set_dedupe(uint32_t expiry_ms) {
+    // Entries older than the expiry are ignored, so the cache needs no flush
+    dedupe_expiry_ms = expiry_ms;
+    ESP_LOGI(TAG, "Duplicate suppression %s (expiry=%" PRIu32 " ms)", expiry_ms ? "enabled" : "disabled", expiry_ms);
+    return ESP_OK;
+}
+
+// Internal: Check the address lengths of a filter entry
+static bool filter_valid(const ieee802154_transceiver_filter_t *filter) {
+    if (((filter->match & IEEE802154_TRANSCEIVER_FILTER_DEST_ADDR) &&
+         filter->dest_addr_len != 2 && filter->dest_addr_len != 8) ||
+        ((filter->match & IEEE802154_TRANSCEIVER_FILTER_SRC_ADDR) &&
+         filter->src_addr_len != 2 && filter->src_addr_len != 8)) {
+        ESP_LOGE(TAG, "Invalid filter address length");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Add an entry to the receive filter table.
+ */
+esp_err_t ieee802154_transceiver_add_filter(const ieee802154_transceiver_filter_t *filter) {
+    if (!filter) {
+        ESP_LOGE(TAG, "Invalid filter pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!filter_valid(filter)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&filter_lock);
+    if (filter_count < FILTER_MAX) {
+        filters[filter_count] = *filter;
+        filter_count++;
+    } else {
+        ret = ESP_ERR_NO_MEM;
+    }
+    portEXIT_CRITICAL(&filter_lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Filter table full");
+    }
+    return ret;
+}
+
+/**
+ * @brief Remove every entry from the receive filter table.
+ */
+esp_err_t ieee802154_transceiver_clear_filters(void) {
+    portENTER_CRITICAL(&filter_lock);
+    filter_count = 0;
+    portEXIT_CRITICAL(&filter_lock);
+    return ESP_OK;
+}
+
+// Internal: Start a subscriber change, returning the spare set as a copy of the published one
+static subscriber_set_t *subscriber_change_begin(void) {
+    // Created once and kept, on the first change
+    portENTER_CRITICAL(&subscriber_lock);
+    if (!subscriber_mutex) {
+        subscriber_mutex = xSemaphoreCreateMutexStatic(&subscriber_mutex_buffer);
+    }
+    portEXIT_CRITICAL(&subscriber_lock);
+    xSemaphoreTake(subscriber_mutex, portMAX_DELAY);
+
+    // The receive side may still be matching against the spare, taken before the last swap
+    subscriber_set_t *current = subscriber_set;
+    subscriber_set_t *spare = (current == &subscriber_sets[0]) ? &subscriber_sets[1] : &subscriber_sets[0];
+    while (1) {
+        portENTER_CRITICAL(&subscriber_lock);
+        bool busy = subscriber_reading == spare;
+        portEXIT_CRITICAL(&subscriber_lock);
+        if (!busy) {
+            break;
+        }
+        vTaskDelay(1);
+    }
+    memcpy(spare, current, offsetof(subscriber_set_t, index));
+    return spare;
+}
+
+// Internal: Finish a subscriber change, rebuilding the index and publishing the set if changed
+static void subscriber_change_end(subscriber_set_t *set, bool changed) {
+    if (changed) {
+        subscriber_index_build(&set->index, set->filters, set->active);
+        portENTER_CRITICAL(&subscriber_lock);
+        subscriber_set = set;
+        subscriber_active = set->active;
+        portEXIT_CRITICAL(&subscriber_lock);
+    }
+    xSemaphoreGive(subscriber_mutex);
+}
+
+/**
+ * @brief Register a receive callback for the frames matching a filter.
+ */
+esp_err_t ieee802154_transceiver_subscribe(const ieee802154_transceiver_filter_t *filter,
+                                           ieee802154_transceiver_rx_raw_callback_t callback, void *user_data,
+                                           int *subscriber_id) {
+    if (!callback) {
+        ESP_LOGE(TAG, "Invalid subscriber callback");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (filter && !filter_valid(filter)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int id = -1;
+    subscriber_set_t *set = subscriber_change_begin();
+    for (int i = 0; i < SUBSCRIBER_MAX; i++) {
+        if (!(set->active & (1u << i))) {
+            id = i;
+            break;
+        }
+    }
+    if (id >= 0) {
+        set->subscribers[id].callback = callback;
+        set->subscribers[id].user_data = user_data;
+        if (filter) {
+            set->filters[id] = *filter;
+            set->catch_all &= ~(1u << id);
+        } else {
+            memset(&set->filters[id], 0, sizeof(set->filters[id]));
+            set->catch_all |= 1u << id;
+        }
+        set->active |= 1u << id;
+    }
+    subscriber_change_end(set, id >= 0);
+
+    if (id < 0) {
+        ESP_LOGE(TAG, "Subscriber table full");
+        return ESP_ERR_NO_MEM;
+    }
+    if (subscriber_id) {
+        *subscriber_id = id;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Remove a subscriber.
+ */
+esp_err_t ieee802154_transceiver_unsubscribe(int subscriber_id) {
+    if (subscriber_id < 0 || subscriber_id >= SUBSCRIBER_MAX) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    subscriber_set_t *set = subscriber_change_begin();
+    if (set->active & (1u << subscriber_id)) {
+        set->active &= ~(1u << subscriber_id);
+        set->catch_all &= ~(1u << subscriber_id);
+        ret = ESP_OK;
+    }
+    subscriber_change_end(set, ret == ESP_OK);
+    return ret;
+}
+
+
+// Internal: Tune the radio and listen; the caller holds the radio
+static esp_err_t radio_set_channel(uint8_t channel) {
+    esp_err_t ret;
+
+    // Set channel
+    ret = esp_ieee802154_set_channel(channel);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
+        return ret;
+    }
+
+    // Start receiving
+    ret = esp_ieee802154_receive();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start receiving: %d", ret);
+        return ret;
+    }
+    rx_channel = channel;
+    return ESP_OK;
+}
+
+/**
+ * @brief Take the radio from the transmit task.
+ */
+esp_err_t transceiver_radio_acquire(uint32_t wait_ms) {
+    if (!radio_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return xSemaphoreTake(radio_mutex, pdMS_TO_TICKS(wait_ms)) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Give the radio back to the transmit task.
+ */
+void transceiver_radio_release(void) {
+    xSemaphoreGive(radio_mutex);
+}
+
+// Internal: Hand a frame to the radio, counting the attempt
+static esp_err_t radio_transmit(const uint8_t *frame, bool cca) {
+    esp_err_t ret = esp_ieee802154_transmit(frame, cca);
+    if (ret == ESP_OK) {
+        STATS_INC(tx_submitted);
+    } else {
+        STATS_INC(tx_refused);
+    }
+    return ret;
+}
+
+// Internal: Retune and send a frame, with the radio held until its outcome when tx_sync_wait is set
+static esp_err_t transmit_frame_locked(const uint8_t *buffer, uint8_t channel, bool change_channel)
+{
+    esp_err_t ret;
+
+    if (change_channel) {
+        // Set channel
+        ret = esp_ieee802154_set_channel(channel);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
+            return ret;
+        }
+    }
+
+    // Transmit frame, only assessing the channel: no backoffs or retries here
+    portENTER_CRITICAL(&tx_policy_lock);
+    bool cca = tx_policy.cca;
+    portEXIT_CRITICAL(&tx_policy_lock);
+    bool wait = sync_done && tx_sync_wait;
+    if (wait) {
+        xSemaphoreTake(sync_done, 0); // Drop a stale completion
+        sync_in_flight = buffer;
+    }
+    ret = radio_transmit(buffer, cca);
+    if (ret != ESP_OK) {
+        sync_in_flight = NULL;
+        ESP_LOGE(TAG, "Failed to transmit frame: %d", ret);
+        return ret;
+    }
+
+    // The transmit task or a survey would abort the frame if given the radio before it is out
+    if (wait && xSemaphoreTake(sync_done, pdMS_TO_TICKS(TX_DONE_TIMEOUT_MS)) != pdTRUE) {
+        sync_in_flight = NULL;
+        ESP_LOGE(TAG, "Transmission did not complete");
+        return ESP_ERR_TIMEOUT;
+    }
+    return wait ? sync_status : ESP_OK;
+}
+
+// Internal: Report the end of a synchronous transmission, from the transmit ISRs
+static void sync_transmit_done(const uint8_t *frame, esp_err_t status) {
+    if (frame != sync_in_flight || !sync_done) {
+        return;
+    }
+    sync_status = status;
+    sync_in_flight = NULL;
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xSemaphoreGiveFromISR(sync_done, &higher_priority_task_woken);
+    if (higher_priority_task_woken) {
+        portYIELD_FROM_ISR(higher_priority_task_woken);
+    }
+}
+
+// Internal: Transmit an already built frame buffer
+static esp_err_t transmit_frame_buffer(const uint8_t *buffer, uint8_t channel, bool change_channel)
+{
+    bool verbose = false;
+    esp_err_t ret;
+
+    // Wait for a transmission or survey in progress to finish
+    if (!radio_mutex) {
+        ret = transmit_frame_locked(buffer, channel, change_channel);
+    } else {
+        xSemaphoreTake(radio_mutex, portMAX_DELAY);
+        ret = transmit_frame_locked(buffer, channel, change_channel);
+        xSemaphoreGive(radio_mutex);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (verbose) {
+        if (change_channel)
+            ESP_LOGI(TAG, "Transmitted frame of %d bytes on channel %d", buffer[0], channel);
+        else   
+            ESP_LOGI(TAG, "Transmitted frame of %d bytes", buffer[0]);
+    }
+    return ESP_OK;
+}
+
+// Internal: Transmit an IEEE 802.15.4 frame
+esp_err_t transmit_channel(const ieee802154_frame_t *frame, uint8_t channel, bool change_channel)
+{
+    if (!frame) {
+        ESP_LOGE(TAG, "Invalid frame pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (change_channel) {
+        if (channel < 11 || channel > 26) {
+            ESP_LOGE(TAG, "Invalid channel: %d", channel);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    // Build frame into a byte array. Every byte up to the length is written,
+    // so the buffer does not need to be cleared first.
+    size_t len = ieee802154_frame_build(frame, transmit_buffer, false);
+    if (len == 0) {
+        ESP_LOGE(TAG, "Failed to build frame");
+        return ESP_FAIL;
+    }
+    // ESP_LOGI(TAG, "len: %d, buffer[0]: %d", len, buffer[0]);
+    // ESP_LOG_BUFFER_HEX(TAG, buffer, buffer[0]);
+
+    return transmit_frame_buffer(transmit_buffer, channel, change_channel);
+}
+
+
+/**
+ * @brief Transmit an IEEE 802.15.4 frame on the current channel.
+ */
+esp_err_t ieee802154_transceiver_transmit(const ieee802154_frame_t *frame) {
+    return transmit_channel(frame, -1, false);
+}
+
+/**
+ * @brief Transmit an IEEE 802.15.4 frame on a specified channel.
+ */
+esp_err_t ieee802154_transceiver_transmit_channel(const ieee802154_frame_t *frame, uint8_t channel) {
+    return transmit_channel(frame, channel, true);
+}
+
+/**
+ * @brief Transmit a raw frame as is, without building it.
+ */
+esp_err_t ieee802154_transceiver_transmit_raw(const uint8_t *psdu, uint8_t channel) {
+    if (!psdu || psdu[0] < 2 || psdu[0] + 1 > MAX_FRAME_LEN) {
+        ESP_LOGE(TAG, "Invalid raw frame");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (channel != 0 && (channel < 11 || channel > 26)) {
+        ESP_LOGE(TAG, "Invalid channel: %d", channel);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The radio reads the buffer while sending, so the caller's copy is not used directly
+    memcpy(transmit_buffer, psdu, psdu[0] + 1);
+    return transmit_frame_buffer(transmit_buffer, channel, channel != 0);
+}
+
+
+// Internal: Hand a prepared request to the transmit task
+static esp_err_t transmit_enqueue(tx_request_t *request) {
+    request->queued_time_us = transceiver_now_us();
+    if (xQueueSend(tx_queue, request, 0) != pdTRUE) {
+        STATS_INC(tx_dropped_queue_full);
+        ESP_LOGW(TAG, "Transmit queue full");
+        return ESP_ERR_NO_MEM;
+    }
+    STATS_INC(tx_queued);
+    STATS_MAX(tx_queue_high_water, uxQueueMessagesWaiting(tx_queue));
+    return ESP_OK;
+}
+
+// Internal: Free entries in the transmit queue
+esp_err_t transceiver_tx_queue_space(size_t *space) {
+    QueueHandle_t queue = tx_queue;
+    if (!queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *space = uxQueueSpacesAvailable(queue);
+    return ESP_OK;
+}
+
+// Internal: Entries the transmit queue was created with
+esp_err_t transceiver_tx_queue_depth(size_t *depth) {
+    if (!tx_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *depth = tx_queue_depth;
+    return ESP_OK;
+}
+
+// Internal: Build a frame into a transmit queue slot
+static esp_err_t transmit_async(const ieee802154_frame_t *frame, uint8_t channel,
+                                ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx) {
+    if (!frame) {
+        ESP_LOGE(TAG, "Invalid frame pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (channel != 0 && (channel < 11 || channel > 26)) {
+        ESP_LOGE(TAG, "Invalid channel: %d", channel);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!tx_queue) {
+        ESP_LOGE(TAG, "Transceiver not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    tx_request_t request = {
+        .channel = channel,
+        .done_cb = done_cb,
+        .ctx = ctx,
+    };
+    if (ieee802154_frame_build(frame, request.frame, false) == 0) {
+        ESP_LOGE(TAG, "Failed to build frame");
+        return ESP_FAIL;
+    }
+
+    return transmit_enqueue(&request);
+}
+
+// Internal: Queue an already built frame on the transmit task
+esp_err_t transceiver_transmit_frame_async(const uint8_t *frame, uint8_t channel,
+                                           ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx) {
+    if (!tx_queue) {
+        ESP_LOGE(TAG, "Transceiver not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (frame[0] + 1 > MAX_FRAME_LEN) {
+        ESP_LOGE(TAG, "Invalid frame length: %d", frame[0]);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    tx_request_t request = {
+        .channel = channel,
+        .done_cb = done_cb,
+        .ctx = ctx,
+    };
+    memcpy(request.frame, frame, frame[0] + 1);
+    return transmit_enqueue(&request);
+}
+
+/**
+ * @brief Queue an IEEE 802.15.4 frame for transmission on the current receive channel.
+ */
+esp_err_t ieee802154_transceiver_transmit_async(const ieee802154_frame_t *frame,
+                                                ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx) {
+    return transmit_async(frame, 0, done_cb, ctx);
+}
+
+/**
+ * @brief Queue an IEEE 802.15.4 frame for transmission on a specified channel.
+ */
+esp_err_t ieee802154_transceiver_transmit_channel_async(const ieee802154_frame_t *frame, uint8_t channel,
+                                                        ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx) {
+    if (channel < 11 || channel > 26) {
+        ESP_LOGE(TAG, "Invalid channel: %d", channel);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return transmit_async(frame, channel, done_cb, ctx);
+}
+
+/**
+ * @brief Queue a raw frame for transmission, without building it.
+ */
+esp_err_t ieee802154_transceiver_transmit_raw_async(const uint8_t *psdu, uint8_t channel,
+                                                    ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx) {
+    if (!psdu || psdu[0] < 2) {
+        ESP_LOGE(TAG, "Invalid raw frame");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (channel != 0 && (channel < 11 || channel > 26)) {
+        ESP_LOGE(TAG, "Invalid channel: %d", channel);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return transceiver_transmit_frame_async(psdu, channel, done_cb, ctx);
+}
+
+/**
+ * @brief Build a frame template.
+ */
+esp_err_t ieee802154_transceiver_template_build(ieee802154_transceiver_template_t *tmpl, const ieee802154_frame_t *frame) {
+    if (!tmpl || !frame) {
+        ESP_LOGE(TAG, "Invalid template or frame pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t len = ieee802154_frame_build(frame, tmpl->frame, false);
+    if (len == 0) {
+        ESP_LOGE(TAG, "Failed to build frame");
+        return ESP_FAIL;
+    }
+
+    // The payload ends right before the FCS
+    ieee802154_transceiver_header_t header;
+    if (!ieee802154_transceiver_header_decode(tmpl->frame, &header) ||
+        frame->payloadLen > (size_t)(tmpl->frame[0] - 2)) {
+        ESP_LOGE(TAG, "Failed to locate template fields");
+        return ESP_FAIL;
+    }
+    tmpl->seq_offset = header.seq_offset;
+    tmpl->payload_len = frame->payloadLen;
+    tmpl->payload_offset = tmpl->frame[0] + 1 - 2 - frame->payloadLen;
+    return ESP_OK;
+}
+
+/**
+ * @brief Overwrite part of a template's payload in place.
+ */
+esp_err_t ieee802154_transceiver_template_patch(ieee802154_transceiver_template_t *tmpl, size_t offset,
+                                                const void *data, size_t len) {
+    if (!tmpl || (!data && len > 0) || offset + len > tmpl->payload_len) {
+        ESP_LOGE(TAG, "Invalid template patch");
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(&tmpl->frame[tmpl->payload_offset + offset], data, len);
+    return ESP_OK;
+}
+
+/**
+ * @brief Transmit a frame template on the current channel.
+ */
+esp_err_t ieee802154_transceiver_template_transmit(const ieee802154_transceiver_template_t *tmpl) {
+    if (!tmpl) {
+        ESP_LOGE(TAG, "Invalid template pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    return transmit_frame_buffer(tmpl->frame, 0, false);
+}
+
+/**
+ * @brief Transmit a frame template on a specified channel.
+ */
+esp_err_t ieee802154_transceiver_template_transmit_channel(const ieee802154_transceiver_template_t *tmpl, uint8_t channel) {
+    if (!tmpl) {
+        ESP_LOGE(TAG, "Invalid template pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (channel < 11 || channel > 26) {
+        ESP_LOGE(TAG, "Invalid channel: %d", channel);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return transmit_frame_buffer(tmpl->frame, channel, true);
+}
+
+/**
+ * @brief Queue a copy of a frame template for transmission on the current receive channel.
+ */
+esp_err_t ieee802154_transceiver_template_transmit_async(const ieee802154_transceiver_template_t *tmpl,
+                                                         ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx) {
+    if (!tmpl) {
+        ESP_LOGE(TAG, "Invalid template pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    return transceiver_transmit_frame_async(tmpl->frame, 0, done_cb, ctx);
+}
+
+/**
+ * @brief Handle the callback for successfully transmitted IEEE 802.15.4 frames.
+ */
+void ieee802154_transceiver_handle_transmit_done(const uint8_t *frame, const uint8_t *ack,
+                                                 esp_ieee802154_frame_info_t *ack_frame_info) {
+    STATS_INC(tx_succeeded);
+    STATS_ADD(tx_bytes, frame[0]);
+    sync_transmit_done(frame, ESP_OK);
+
+    if (frame == tx_in_flight && tx_task_handle) {
+        tx_isr_result.done_time_us = transceiver_now_us();
+        tx_isr_result.status = ESP_OK;
+        tx_isr_result.error = ESP_IEEE802154_TX_ERR_NONE;
+        tx_isr_result.ack_received = ack != NULL;
+        tx_isr_result.ack_frame_pending = ack && ((ack[1] >> 4) & 0x01);
+        if (ack && ack_frame_info) {
+            tx_isr_result.ack_info = *ack_frame_info;
+        }
+        tx_in_flight = NULL;
+
+        BaseType_t higher_priority_task_woken = pdFALSE;
+        vTaskNotifyGiveFromISR(tx_task_handle, &higher_priority_task_woken);
+        if (higher_priority_task_woken) {
+            portYIELD_FROM_ISR(higher_priority_task_woken);
+        }
+    }
+
+    // Release the ACK frame buffer
+    if (ack) {
+        esp_ieee802154_receive_handle_done(ack);
+    }
+}
+
+/**
+ * @brief Handle the callback for failed IEEE 802.15.4 transmissions.
+ */
+void ieee802154_transceiver_handle_transmit_failed(const uint8_t *frame, esp_ieee802154_tx_error_t error) {
+    STATS_INC(tx_failed);
+    sync_transmit_done(frame, ESP_FAIL);
+
+    if (frame != tx_in_flight || !tx_task_handle) {
+        return;
+    }
+
+    tx_isr_result.done_time_us = transceiver_now_us();
+    tx_isr_result.status = ESP_FAIL;
+    tx_isr_result.error = error;
+    tx_isr_result.ack_received = false;
+    tx_isr_result.ack_frame_pending = false;
+    tx_in_flight = NULL;
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(tx_task_handle, &higher_priority_task_woken);
+    if (higher_priority_task_woken) {
+        portYIELD_FROM_ISR(higher_priority_task_woken);
+    }
+}
+
+// Internal: Draw a backoff of 0 to 2^be - 1 periods (xorshift32)
+static uint32_t backoff_draw(uint8_t be) {
+    uint32_t x = backoff_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    backoff_rng = x;
+    return (x & ((1u << be) - 1)) * BACKOFF_PERIOD_US;
+}
+
+// Internal: Wait out a backoff, busy-waiting only the shortest ones
+static void backoff_wait(uint32_t wait_us) {
+    uint32_t ticks = transceiver_wait_ticks(wait_us, portTICK_PERIOD_MS * 1000, BACKOFF_SPIN_MAX_US);
+    if (ticks > 0) {
+        vTaskDelay(ticks);
+    } else {
+        transceiver_delay_us(wait_us);
+    }
+}
+
+// Internal: Hand the frame to the radio once and wait for its report
+static esp_err_t transmit_attempt(const uint8_t *frame, bool cca, ieee802154_transceiver_tx_result_t *result) {
+    ulTaskNotifyTake(pdTRUE, 0); // Drop a stale completion
+    tx_in_flight = frame;
+    result->attempts++;
+    esp_err_t ret = radio_transmit(frame, cca);
+    if (ret != ESP_OK) {
+        tx_in_flight = NULL;
+        result->outcome = IEEE802154_TRANSCEIVER_TX_OUTCOME_REFUSED;
+        ESP_LOGE(TAG, "Failed to transmit frame: %d", ret);
+        return ret;
+    }
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TX_DONE_TIMEOUT_MS)) == 0) {
+        tx_in_flight = NULL;
+        result->outcome = IEEE802154_TRANSCEIVER_TX_OUTCOME_TIMEOUT;
+        ESP_LOGE(TAG, "Transmission did not complete");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    result->error = tx_isr_result.error;
+    result->ack_received = tx_isr_result.ack_received;
+    result->ack_frame_pending = tx_isr_result.ack_frame_pending;
+    result->ack_info = tx_isr_result.ack_info;
+    result->done_time_us = tx_isr_result.done_time_us;
+    switch (result->error) {
+    case ESP_IEEE802154_TX_ERR_NONE:
+        result->outcome = IEEE802154_TRANSCEIVER_TX_OUTCOME_OK;
+        break;
+    case ESP_IEEE802154_TX_ERR_NO_ACK:
+        result->outcome = IEEE802154_TRANSCEIVER_TX_OUTCOME_NO_ACK;
+        STATS_INC(tx_no_ack);
+        break;
+    case ESP_IEEE802154_TX_ERR_CCA_BUSY:
+        result->outcome = IEEE802154_TRANSCEIVER_TX_OUTCOME_CHANNEL_BUSY;
+        result->cca_busy++;
+        STATS_INC(tx_cca_busy);
+        break;
+    default:
+        result->outcome = IEEE802154_TRANSCEIVER_TX_OUTCOME_RADIO_ERROR;
+        break;
+    }
+    return tx_isr_result.status;
+}
+
+// Internal: Send a frame under the transmit policy: backoffs, CCA and retries
+static esp_err_t transmit_with_policy(const uint8_t *frame, const ieee802154_transceiver_tx_policy_t *policy,
+                                      ieee802154_transceiver_tx_result_t *result) {
+    esp_err_t ret;
+    while (1) {
+        // CSMA-CA: back off, assess, and back off longer while the channel is busy
+        uint8_t be = policy->min_be;
+        for (uint8_t backoffs = 0;; backoffs++) {
+            uint32_t wait_us = policy->cca ? backoff_draw(be) : 0; // Without CCA nothing waits for a clear channel
+            if (wait_us) {
+                result->backoff_us += wait_us;
+                backoff_wait(wait_us);
+            }
+            ret = transmit_attempt(frame, policy->cca, result);
+            if (result->outcome != IEEE802154_TRANSCEIVER_TX_OUTCOME_CHANNEL_BUSY ||
+                backoffs >= policy->max_csma_backoffs) {
+                break;
+            }
+            be = be < policy->max_be ? be + 1 : policy->max_be;
+        }
+
+        if ((result->outcome != IEEE802154_TRANSCEIVER_TX_OUTCOME_NO_ACK &&
+             result->outcome != IEEE802154_TRANSCEIVER_TX_OUTCOME_CHANNEL_BUSY) ||
+            result->retries >= policy->max_retries) {
+            return ret;
+        }
+        result->retries++;
+        STATS_INC(tx_retries);
+    }
+}
+
+/**
+ * @brief Task to send queued frames back-to-back and report their completion.
+ */
+static void transmit_packet_task(void *pvParameters) {
+    static tx_request_t request; // Must stay valid while the radio reads it
+    uint8_t current_channel = 0; // Channel switched to for transmission, 0 if none
+
+    ESP_LOGI(TAG, "Transmit packet task started");
+    backoff_rng = (uint32_t)transceiver_now_us() | 1;
+
+    while (1) {
+        // Return to the receive channel once the queue has drained
+        if (current_channel != 0 && uxQueueMessagesWaiting(tx_queue) == 0) {
+            if (current_channel != rx_channel) {
+                xSemaphoreTake(radio_mutex, portMAX_DELAY);
+                radio_set_channel(rx_channel);
+                xSemaphoreGive(radio_mutex);
+            }
+            current_channel = 0;
+        }
+
+        if (xQueueReceive(tx_queue, &request, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        ieee802154_transceiver_tx_policy_t policy;
+        portENTER_CRITICAL(&tx_policy_lock);
+        policy = tx_policy;
+        portEXIT_CRITICAL(&tx_policy_lock);
+
+        // Keep the radio from being retuned until this frame is out
+        xSemaphoreTake(radio_mutex, portMAX_DELAY);
+
+        ieee802154_transceiver_tx_result_t result = {
+            .frame = request.frame,
+            .channel = request.channel ? request.channel : rx_channel,
+            .queued_time_us = request.queued_time_us,
+        };
+
+        // Switch only when the channel differs from the previous frame's
+        uint8_t channel = request.channel ? request.channel : rx_channel;
+        esp_err_t ret = ESP_OK;
+        if (channel != (current_channel ? current_channel : rx_channel)) {
+            ret = esp_ieee802154_set_channel(channel);
+            if (ret != ESP_OK) {
+                result.outcome = IEEE802154_TRANSCEIVER_TX_OUTCOME_REFUSED;
+                ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
+            }
+        }
+        current_channel = channel;
+
+        if (ret == ESP_OK) {
+            int64_t submit_us = TRACE_NOW();
+            TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_TX_QUEUE, request.queued_time_us, submit_us);
+            ret = transmit_with_policy(request.frame, &policy, &result);
+            if (result.done_time_us) {
+                TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_TX_RADIO, submit_us, result.done_time_us);
+            }
+        }
+        result.status = ret;
+        if (ret != ESP_OK) {
+            STATS_INC(tx_frames_failed);
+        }
+        xSemaphoreGive(radio_mutex);
+
+        if (request.done_cb) {
+            request.done_cb(&result, request.ctx);
+        }
+    }
+}
+
+/**
+ * @brief Change the channel access and retry policy of queued frames.
+ */
+esp_err_t ieee802154_transceiver_set_tx_policy(const ieee802154_transceiver_tx_policy_t *policy) {
+    if (!policy || !tx_policy_valid(policy)) {
+        ESP_LOGE(TAG, "Invalid transmit policy");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&tx_policy_lock);
+    tx_policy = *policy;
+    portEXIT_CRITICAL(&tx_policy_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the channel access and retry policy of queued frames.
+ */
+esp_err_t ieee802154_transceiver_get_tx_policy(ieee802154_transceiver_tx_policy_t *policy) {
+    if (!policy) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&tx_policy_lock);
+    *policy = tx_policy;
+    portEXIT_CRITICAL(&tx_policy_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Set the IEEE 802.15.4 channel.
+ */
+esp_err_t ieee802154_transceiver_set_channel(uint8_t channel) {
+    if (channel < 11 || channel > 26) {
+        ESP_LOGE(TAG, "Invalid channel: %d", channel);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Wait for a transmission or survey in progress to finish
+    if (!radio_mutex) {
+        return radio_set_channel(channel);
+    }
+    xSemaphoreTake(radio_mutex, portMAX_DELAY);
+    esp_err_t ret = radio_set_channel(channel);
+    xSemaphoreGive(radio_mutex);
+
+    // ESP_LOGI(TAG, "Channel set to %d", channel);
+    return ret;
+}
+
+/**
+ * @brief Change the radio identity.
+ */
+esp_err_t ieee802154_transceiver_set_address(const ieee802154_transceiver_address_t *address) {
+    if (!address) {
+        ESP_LOGE(TAG, "Invalid address pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!radio_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return radio_set_address(address);
+}
+
+/**
+ * @brief Mark a neighbor as having frames pending, or clear it.
+ */
+esp_err_t ieee802154_transceiver_set_pending(const uint8_t *addr, uint8_t addr_len, bool pending) {
+    if (!addr || (addr_len != 2 && addr_len != 8)) {
+        ESP_LOGE(TAG, "Invalid pending address");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!radio_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (pending) {
+        return esp_ieee802154_add_pending_addr(addr, addr_len == 2);
+    }
+    // Clearing an address that was not marked is not an error
+    esp_err_t ret = esp_ieee802154_clear_pending_addr(addr, addr_len == 2);
+    return ret == ESP_ERR_NOT_FOUND ? ESP_OK : ret;
+}
+
+/**
+ * @brief Clear the pending marks of every neighbor.
+ */
+esp_err_t ieee802154_transceiver_clear_pending(void) {
+    if (!radio_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_ieee802154_reset_pending_table(true);
+    esp_ieee802154_reset_pending_table(false);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the pipeline counters.
+ */
+esp_err_t ieee802154_transceiver_get_stats(ieee802154_transceiver_stats_t *stats, bool reset) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t *out = (uint32_t *)stats;
+    for (size_t i = 0; i < STATS_COUNT; i++) {
+        out[i] = reset ? atomic_exchange_explicit(&stats_counters[i], 0, memory_order_relaxed)
+                       : atomic_load_explicit(&stats_counters[i], memory_order_relaxed);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the receive counters of a channel.
+ */
+esp_err_t ieee802154_transceiver_get_channel_stats(uint8_t channel, ieee802154_transceiver_channel_stats_t *stats) {
+    if (channel < 11 || channel > 26 || !stats) {
+        ESP_LOGE(TAG, "Invalid channel stats request: %d", channel);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    stats->frames = channel_frames[channel - 11];
+    stats->bytes = channel_bytes[channel - 11];
+    stats->drops = channel_drops[channel - 11];
+    return ESP_OK;
+}
+
+/**
+ * @brief Locate the MAC header fields of a raw frame.
+ */
+bool ieee802154_transceiver_header_decode(const uint8_t *frame, ieee802154_transceiver_header_t *header) {
+    static const uint8_t addr_len[4] = {0, 0, 2, 8}; // By addressing mode
+
+    uint8_t psdu_len = frame[0];
+    if (psdu_len < 5 || psdu_len >= MAX_FRAME_LEN) { // FCF + FCS at least
+        return false;
+    }
+
+    uint16_t fcf = frame[1] | (frame[2] << 8);
+    uint8_t version = (fcf >> 12) & 0x03;
+    uint8_t dest_mode = (fcf >> 10) & 0x03;
+    uint8_t src_mode = (fcf >> 14) & 0x03;
+    bool pan_id_compression = (fcf >> 6) & 0x01;
+    bool seq_suppressed = (version == 2) && ((fcf >> 8) & 0x01);
+
+    if (dest_mode == 1 || src_mode == 1) { // Reserved addressing mode
+        return false;
+    }
+
+    // PAN ID presence
+    bool dest_pan, src_pan;
+    if (version < 2) {
+        dest_pan = dest_mode != 0;
+        src_pan = src_mode != 0 && !pan_id_compression;
+    } else if (dest_mode == 0 && src_mode == 0) {
+        dest_pan = pan_id_compression;
+        src_pan = false;
+    } else if (dest_mode == 0 || src_mode == 0) {
+        dest_pan = dest_mode != 0 && !pan_id_compression;
+        src_pan = src_mode != 0 && !pan_id_compression;
+    } else if (dest_mode == 3 && src_mode == 3) {
+        dest_pan = !pan_id_compression;
+        src_pan = false;
+    } else {
+        dest_pan = true;
+        src_pan = !pan_id_compression;
+    }
+
+    uint8_t pos = 3;
+    header->frame = frame;
+    header->fcf = fcf;
+    header->seq_offset = seq_suppressed ? 0 : pos;
+    pos += seq_suppressed ? 0 : 1;
+    header->dest_pan_offset = dest_pan ? pos : 0;
+    pos += dest_pan ? 2 : 0;
+    header->dest_addr_len = addr_len[dest_mode];
+    header->dest_addr_offset = dest_mode ? pos : 0;
+    pos += header->dest_addr_len;
+    header->src_pan_offset = src_pan ? pos : 0;
+    pos += src_pan ? 2 : 0;
+    header->src_addr_len = addr_len[src_mode];
+    header->src_addr_offset = src_mode ? pos : 0;
+    pos += header->src_addr_len;
+    header->payload_offset = pos;
+
+    // The header must end before the FCS
+    return pos <= psdu_len + 1 - 2;
+}
+
+/**
+ * @brief Overwrite selected MAC header fields of a raw frame in place.
+ */
+esp_err_t ieee802154_transceiver_rewrite(uint8_t *frame, const ieee802154_transceiver_rewrite_t *rewrite) {
+    ieee802154_transceiver_header_t header;
+    if (!frame || !rewrite || !ieee802154_transceiver_header_decode(frame, &header)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if ((rewrite->fields & IEEE802154_TRANSCEIVER_REWRITE_SEQ) && header.seq_offset) {
+        frame[header.seq_offset] = rewrite->seq;
+    }
+    if ((rewrite->fields & IEEE802154_TRANSCEIVER_REWRITE_DEST_PAN) && header.dest_pan_offset) {
+        frame[header.dest_pan_offset] = rewrite->dest_pan_id & 0xff;
+        frame[header.dest_pan_offset + 1] = rewrite->dest_pan_id >> 8;
+    }
+    if ((rewrite->fields & IEEE802154_TRANSCEIVER_REWRITE_SRC_PAN) && header.src_pan_offset) {
+        frame[header.src_pan_offset] = rewrite->src_pan_id & 0xff;
+        frame[header.src_pan_offset + 1] = rewrite->src_pan_id >> 8;
+    }
+    return ESP_OK;
+}
+
+// Internal: Check one decoded frame against one filter entry
+static bool filter_match(const ieee802154_transceiver_filter_t *filter,
+                         const ieee802154_transceiver_header_t *header,
+                         const esp_ieee802154_frame_info_t *frame_info) {
+    uint32_t match = filter->match;
+    uint16_t pan_id;
+
+    if ((match & IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE) &&
+        !(filter->frame_types & (1 << ieee802154_transceiver_header_frame_type(header)))) {
+        return false;
+    }
+    if ((match & IEEE802154_TRANSCEIVER_FILTER_MIN_RSSI) && frame_info->rssi < filter->min_rssi) {
+        return false;
+    }
+    if ((match & IEEE802154_TRANSCEIVER_FILTER_MIN_LQI) && frame_info->lqi < filter->min_lqi) {
+        return false;
+    }
+    if (match & IEEE802154_TRANSCEIVER_FILTER_DEST_PAN) {
+        if (!ieee802154_transceiver_header_dest_pan(header, &pan_id) || pan_id != filter->dest_pan_id) {
+            return false;
+        }
+    }
+    if (match & IEEE802154_TRANSCEIVER_FILTER_SRC_PAN) {
+        bool compressed = (header->fcf >> 6) & 0x01;
+        if (!ieee802154_transceiver_header_src_pan(header, &pan_id) &&
+            !(compressed && ieee802154_transceiver_header_dest_pan(header, &pan_id))) {
+            return false;
+        }
+        if (pan_id != filter->src_pan_id) {
+            return false;
+        }
+    }
+    if (match & IEEE802154_TRANSCEIVER_FILTER_DEST_ADDR) {
+        if (header->dest_addr_len != filter->dest_addr_len ||
+            memcmp(ieee802154_transceiver_header_dest_addr(header), filter->dest_addr, filter->dest_addr_len) != 0) {
+            return false;
+        }
+    }
+    if (match & IEEE802154_TRANSCEIVER_FILTER_SRC_ADDR) {
+        if (header->src_addr_len != filter->src_addr_len ||
+            memcmp(ieee802154_transceiver_header_src_addr(header), filter->src_addr, filter->src_addr_len) != 0) {
+            return false;
+        }
+    }
+    if (match & IEEE802154_TRANSCEIVER_FILTER_COMMAND_ID) {
+        uint8_t command_id;
+        if (!ieee802154_transceiver_header_command_id(header, &command_id) || command_id != filter->command_id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Internal: Check a decoded frame against one filter entry
+bool transceiver_filter_match(const ieee802154_transceiver_filter_t *filter,
+                              const ieee802154_transceiver_header_t *header,
+                              const esp_ieee802154_frame_info_t *frame_info) {
+    return header && filter_match(filter, header, frame_info);
+}
+
+// Internal: Evaluate the filter table in ISR context
+static bool filter_accept(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info) {
+    ieee802154_transceiver_header_t header;
+    bool accept = false;
+
+    if (!ieee802154_transceiver_header_decode(frame, &header)) {
+        return false;
+    }
+
+    portENTER_CRITICAL_ISR(&filter_lock);
+    for (size_t i = 0; i < filter_count && !accept; i++) {
+        accept = filter_match(&filters[i], &header, frame_info);
+    }
+    portEXIT_CRITICAL_ISR(&filter_lock);
+
+    return accept;
+}
+
+/**
+ * @brief Handle the callback for received IEEE 802.15.4 frames.
+ */
+void ieee802154_transceiver_handle_receive_done(uint8_t *frame, esp_ieee802154_frame_info_t *frame_info) {
+    int64_t rx_time_us = transceiver_now_us();
+
+    if (!rx_ring_storage || !rx_task_handle) {
+        esp_ieee802154_receive_handle_done(frame);
+        return;
+    }
+
+    // Length byte plus PSDU
+    size_t len = frame[0] + 1;
+    STATS_INC(rx_frames);
+    if (len > MAX_FRAME_LEN) {
+        STATS_INC(rx_dropped_invalid);
+        esp_ieee802154_receive_handle_done(frame);
+        return;
+    }
+    STATS_ADD(rx_bytes, frame[0]);
+
+    // Count everything heard on the channel
+    uint8_t channel_index = ((frame_info->channel >= 11 && frame_info->channel <= 26) ?
+                             frame_info->channel : rx_channel) - 11;
+    if (channel_index < 16) {
+        channel_frames[channel_index]++;
+        channel_bytes[channel_index] += frame[0];
+    }
+
+    // Release frames nobody is interested in before spending a slot on them
+    if (filter_count > 0 && !filter_accept(frame, frame_info)) {
+        STATS_INC(rx_dropped_filtered);
+        esp_ieee802154_receive_handle_done(frame);
+        return;
+    }
+
+    // Copy straight into the next free slot
+    frame_data_t *packet = frame_ring_acquire(&rx_ring);
+    if (!packet) {
+        if (channel_index < 16) {
+            channel_drops[channel_index]++;
+        }
+        STATS_INC(rx_dropped_queue_full);
+        ESP_EARLY_LOGW(TAG, "Receive ring full, packet discarded");
+        esp_ieee802154_receive_handle_done(frame);
+        return;
+    }
+    memcpy(packet->frame, frame, len);
+    packet->frame_info = *frame_info;
+    packet->rx_time_us = rx_time_us;
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+    packet->queued_time_us = TRACE_NOW();
+    TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_ISR, rx_time_us, packet->queued_time_us);
+#endif
+
+    bool was_empty = frame_ring_commit(&rx_ring);
+    uint32_t pending = frame_ring_count(&rx_ring);
+    STATS_INC(rx_queued);
+    STATS_MAX(rx_queue_high_water, pending);
+
+    esp_ieee802154_receive_handle_done(frame);
+
+    // Only wake the receive task when it may be waiting on an empty ring,
+    // or when enough frames are pending to fill a batch
+    if (was_empty || (rx_wake_threshold > 1 && pending == rx_wake_threshold)) {
+        BaseType_t higher_priority_task_woken = pdFALSE;
+        vTaskNotifyGiveFromISR(rx_task_handle, &higher_priority_task_woken);
+        if (higher_priority_task_woken) {
+            portYIELD_FROM_ISR(higher_priority_task_woken);
+        }
+    }
+}
+
+// Internal: Decode the header of a queued frame, once for the dedupe check, the hooks and the subscribers
+static inline const ieee802154_transceiver_header_t *decode_packet(const frame_data_t *packet,
+                                                                   ieee802154_transceiver_header_t *header) {
+    return ieee802154_transceiver_header_decode(packet->frame, header) ? header : NULL;
+}
+
+// Internal: Deliver a queued frame to the subscribers whose filters it matches
+static void run_subscribers(const frame_data_t *packet, const ieee802154_transceiver_header_t *header) {
+    if (!subscriber_active) {
+        return;
+    }
+
+    // Pin the published set; changes go to the other one meanwhile
+    portENTER_CRITICAL(&subscriber_lock);
+    const subscriber_set_t *set = subscriber_set;
+    subscriber_reading = set;
+    portEXIT_CRITICAL(&subscriber_lock);
+
+    // Look the candidates up in the index, then confirm them against their whole filter
+    // (source fields, RSSI, LQI). The callbacks are copied out to run with the set released.
+    subscriber_t targets[SUBSCRIBER_MAX];
+    uint32_t count = 0;
+    // Frames without a readable header only go to the subscribers without a filter
+    uint32_t mask = header ? subscriber_index_lookup(&set->index, header) & set->active : set->catch_all;
+    while (mask) {
+        int i = __builtin_ctz(mask);
+        mask &= mask - 1;
+        if (!header || filter_match(&set->filters[i], header, &packet->frame_info)) {
+            targets[count++] = set->subscribers[i];
+        }
+    }
+
+    portENTER_CRITICAL(&subscriber_lock);
+    subscriber_reading = NULL;
+    portEXIT_CRITICAL(&subscriber_lock);
+
+    for (uint32_t i = 0; i < count; i++) {
+        targets[i].callback(packet->frame, &packet->frame_info, targets[i].user_data);
+        STATS_INC(rx_callbacks);
+    }
+}
+
+// Internal: Check a queued frame against the recently received ones, counting duplicates
+static bool rx_duplicate(const frame_data_t *packet, const ieee802154_transceiver_header_t *header) {
+    uint32_t expiry_ms = dedupe_expiry_ms;
+    if (!expiry_ms) {
+        return false;
+    }
+
+    dedupe_key_t key;
+    if (!header || !dedupe_cache_key(header, &key) ||
+        !dedupe_cache_check(&dedupe_cache, &key, packet->rx_time_us, (int64_t)expiry_ms * 1000)) {
+        return false;
+    }
+    STATS_INC(rx_dropped_duplicate);
+    return true;
+}
+
+// Internal: Parse a queued packet, counting failures
+static bool parse_packet(const frame_data_t *packet, ieee802154_frame_t *frame) {
+    int64_t parse_start_us = TRACE_NOW();
+    bool parsed = ieee802154_frame_parse(packet->frame, frame, false);
+    TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_PARSE, parse_start_us, TRACE_NOW());
+    if (!parsed) {
+        STATS_INC(rx_parse_failures);
+        ESP_LOGE(TAG, "Failed to parse frame");
+    }
+    return parsed;
+}
+
+// Internal: Return delivered slots to their producer
+static void release_slots(frame_ring_t *ring, uint32_t count) {
+    frame_ring_release(ring, count);
+    if (ring == &dispatch_ring && atomic_exchange(&parse_waiting, false)) {
+        xTaskNotifyGive(rx_task_handle);
+    }
+}
+
+/**
+ * @brief Hand one received packet to the raw callback, then parse it for the parsed callback.
+ *
+ * The slot is a frame_data_t, or a dispatch_item_t already parsed by the receive task when pipelined.
+ */
+static void dispatch_packet(void *slot, ieee802154_frame_t *frame) {
+    frame_data_t *packet = slot;
+    dispatch_item_t *item = rx_pipelined ? slot : NULL;
+    int64_t start_us = TRACE_NOW();
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+    TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_QUEUE, packet->queued_time_us, start_us);
+#endif
+
+    // Decode once, drop duplicates and run the hooks, unless the receive task already has
+    ieee802154_transceiver_header_t decoded;
+    const ieee802154_transceiver_header_t *header;
+    if (!item) {
+        header = decode_packet(packet, &decoded);
+        if (rx_duplicate(packet, header)) {
+            return;
+        }
+        run_rx_hooks(packet, header);
+    } else {
+        header = item->header_ok ? &item->header : NULL;
+    }
+    run_subscribers(packet, header);
+    if (rx_raw_callback) {
+        rx_raw_callback(packet->frame, &packet->frame_info, rx_raw_user_data);
+        STATS_INC(rx_callbacks);
+    }
+
+    // Skip parsing when nobody consumes the parsed frame
+    if (!rx_callback) {
+        TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_CALLBACK, start_us, TRACE_NOW());
+        return;
+    }
+
+    // Parse frame, unless the receive task already has
+    int64_t parse_us = 0;
+    bool parsed;
+    if (item && item->parsed) {
+        frame = &item->frame;
+        parsed = item->parse_ok;
+    } else {
+        int64_t parse_start_us = TRACE_NOW();
+        parsed = parse_packet(packet, frame);
+        parse_us = TRACE_NOW() - parse_start_us;
+    }
+    if (!parsed) {
+        return;
+    }
+
+    // Invoke callback if set
+    if (rx_callback) {
+        rx_callback(frame, &packet->frame_info, rx_callback_user_data);
+        STATS_INC(rx_callbacks);
+    }
+    TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_CALLBACK, start_us + parse_us, TRACE_NOW());
+}
+
+/**
+ * @brief Parse the oldest count packets of a ring and deliver them as one batch.
+ */
+static void dispatch_batch(frame_ring_t *ring, uint32_t count) {
+    size_t parsed = 0;
+    int64_t start_us = TRACE_NOW();
+    int64_t parse_us = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        void *slot = frame_ring_peek(ring, i);
+        frame_data_t *packet = slot;
+        dispatch_item_t *item = rx_pipelined ? slot : NULL;
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+        TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_QUEUE, packet->queued_time_us, TRACE_NOW());
+#endif
+        ieee802154_transceiver_header_t decoded;
+        const ieee802154_transceiver_header_t *header;
+        if (!item) {
+            header = decode_packet(packet, &decoded);
+            if (rx_duplicate(packet, header)) {
+                continue;
+            }
+            run_rx_hooks(packet, header);
+        } else {
+            header = item->header_ok ? &item->header : NULL;
+        }
+        run_subscribers(packet, header);
+        if (rx_raw_callback) {
+            rx_raw_callback(packet->frame, &packet->frame_info, rx_raw_user_data);
+            STATS_INC(rx_callbacks);
+        }
+
+        bool ok;
+        if (item && item->parsed) {
+            // The payload still points into the slot, which is held until the batch is delivered
+            ok = item->parse_ok;
+            if (ok) {
+                rx_batch_frames[parsed] = item->frame;
+            }
+        } else {
+            int64_t parse_start_us = TRACE_NOW();
+            ok = parse_packet(packet, &rx_batch_frames[parsed]);
+            parse_us += TRACE_NOW() - parse_start_us;
+        }
+        if (!ok) {
+            continue;
+        }
+        rx_batch_infos[parsed] = packet->frame_info;
+
+        if (rx_callback) {
+            rx_callback(&rx_batch_frames[parsed], &rx_batch_infos[parsed], rx_callback_user_data);
+            STATS_INC(rx_callbacks);
+        }
+        parsed++;
+    }
+
+    ieee802154_transceiver_rx_batch_callback_t callback = rx_batch_callback;
+    if (callback && parsed > 0) {
+        callback(rx_batch_frames, rx_batch_infos, parsed, rx_batch_user_data);
+        STATS_INC(rx_callbacks);
+    }
+    TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_CALLBACK, start_us + parse_us, TRACE_NOW());
+
+    // The slots back the parsed payloads until the batch has been delivered
+    release_slots(ring, count);
+}
+
+/**
+ * @brief Deliver the packets of a ring to the callbacks, one at a time or in batches.
+ *
+ * Runs forever in the receive task, or in the dispatch task when pipelined.
+ */
+static void dispatch_loop(frame_ring_t *ring) {
+    ieee802154_frame_t frame = {0};
+    TickType_t wait_ticks = portMAX_DELAY;
+    TickType_t batch_start = 0;
+    bool batch_open = false;
+
+    while (1) {
+        // Sleep until a frame is published into an empty ring, a batch
+        // fills up, or the oldest frame of a partial batch is due
+        ulTaskNotifyTake(pdTRUE, wait_ticks);
+        wait_ticks = portMAX_DELAY;
+
+        if (!rx_batch_callback) {
+            // Drain every pending packet before sleeping again. The slot backs the
+            // parsed frame, so it is only released once the callback has returned.
+            void *slot;
+            while ((slot = frame_ring_peek(ring, 0)) != NULL) {
+                dispatch_packet(slot, &frame);
+                release_slots(ring, 1);
+            }
+            batch_open = false;
+            continue;
+        }
+
+        // Deliver full batches, and the partial one once it is overdue
+        uint32_t pending;
+        while ((pending = frame_ring_count(ring)) > 0) {
+            if (pending < rx_batch_size) {
+                TickType_t now = xTaskGetTickCount();
+                if (!batch_open) {
+                    batch_open = true;
+                    batch_start = now;
+                }
+                TickType_t waited = now - batch_start;
+                if (waited < rx_batch_delay) {
+                    wait_ticks = rx_batch_delay - waited;
+                    break;
+                }
+            }
+            dispatch_batch(ring, pending < rx_batch_size ? pending : rx_batch_size);
+            batch_open = false;
+        }
+    }
+}
+
+/**
+ * @brief Pipelined receive: copy and parse received packets into the dispatch ring.
+ *
+ * Receive slots are released as soon as they are copied, so a slow callback in the
+ * dispatch task only fills the dispatch ring, and the ISR keeps finding free slots.
+ */
+static void parse_loop(void) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        frame_data_t *packet;
+        while ((packet = frame_ring_peek(&rx_ring, 0)) != NULL) {
+            dispatch_item_t *item = frame_ring_acquire(&dispatch_ring);
+            if (!item) {
+                // Ask the dispatch task for a wakeup, then check again so a release is not missed
+                atomic_store(&parse_waiting, true);
+                item = frame_ring_acquire(&dispatch_ring);
+                if (!item) {
+                    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                    continue;
+                }
+                atomic_store(&parse_waiting, false);
+            }
+
+            // Work on the copy, so the header decoded here stays valid in the dispatch task
+            item->packet = *packet;
+            frame_ring_release(&rx_ring, 1);
+            item->header_ok = decode_packet(&item->packet, &item->header) != NULL;
+            const ieee802154_transceiver_header_t *header = item->header_ok ? &item->header : NULL;
+
+            // The acquired slot is simply reused when the frame is dropped
+            if (rx_duplicate(&item->packet, header)) {
+                continue;
+            }
+            run_rx_hooks(&item->packet, header);
+
+            // Parse the copy, which the parsed payload then points into
+            item->parsed = rx_callback || rx_batch_callback;
+            item->parse_ok = item->parsed && parse_packet(&item->packet, &item->frame);
+
+            bool was_empty = frame_ring_commit(&dispatch_ring);
+            uint32_t pending = frame_ring_count(&dispatch_ring);
+            STATS_MAX(rx_pipe_high_water, pending);
+            if (was_empty || (rx_wake_threshold > 1 && pending == rx_wake_threshold)) {
+                xTaskNotifyGive(dispatch_task_handle);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Task to process received packets and invoke callback.
+ */
+static void receive_packet_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Receive packet task started");
+
+    if (rx_pipelined) {
+        parse_loop();
+    } else {
+        dispatch_loop(&rx_ring);
+    }
+}
+
+/**
+ * @brief Task to invoke the callbacks on packets parsed by the receive task (pipelined mode).
+ */
+static void dispatch_packet_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Dispatch packet task started");
+
+    dispatch_loop(&dispatch_ring);
+}
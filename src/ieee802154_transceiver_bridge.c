@@ -0,0 +1,287 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_bridge.h"
+#include "ieee802154_transceiver_priv.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_BRIDGE"
+
+#define MAX_FRAME_LEN 128
+#define BRIDGE_QUEUE_DEPTH CONFIG_IEEE802154_TRANSCEIVER_BRIDGE_QUEUE_DEPTH
+#define TX_QUEUE_DEPTH CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH
+
+// Frame waiting to be forwarded
+typedef struct {
+    uint8_t frame[MAX_FRAME_LEN];
+    int64_t rx_time_us; // Receive ISR time, 0 marks the stop request
+} bridge_item_t;
+
+// Global state
+static ieee802154_transceiver_bridge_config_t bridge_config;
+static ieee802154_transceiver_filter_t bridge_filter;
+static ieee802154_transceiver_rewrite_t bridge_rewrite;
+static QueueHandle_t bridge_queue = NULL;
+static TaskHandle_t bridge_task_handle = NULL;
+static TaskHandle_t bridge_stop_waiter = NULL;
+static bridge_item_t bridge_batch[TX_QUEUE_DEPTH]; // Owned by the bridge task
+
+// Held by the receive hook while it queues a frame, so stopping never races a send to the queue
+static bool bridge_running = false;
+static SemaphoreHandle_t bridge_mutex = NULL;
+static StaticSemaphore_t bridge_mutex_buffer;
+
+// Statistics, updated from the receive, bridge and transmit tasks
+static ieee802154_transceiver_bridge_stats_t bridge_stats;
+static uint64_t bridge_latency_sum_us = 0;
+static portMUX_TYPE bridge_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Forward declarations
+static void bridge_task(void *pvParameters);
+
+// Internal: Transmit completion, runs in the transmit task
+static void bridge_tx_done(const ieee802154_transceiver_tx_result_t *result, void *ctx) {
+    // ctx carries the low 32 bits of the receive time; the difference is exact below ~71 minutes
+    uint32_t latency_us = (uint32_t)result->done_time_us - (uint32_t)(uintptr_t)ctx;
+
+    portENTER_CRITICAL(&bridge_stats_lock);
+    if (result->status == ESP_OK) {
+        bridge_stats.forwarded++;
+        bridge_stats.latency_samples++;
+        bridge_latency_sum_us += latency_us;
+        if (latency_us > bridge_stats.latency_max_us) {
+            bridge_stats.latency_max_us = latency_us;
+        }
+    } else {
+        bridge_stats.tx_failed++;
+    }
+    portEXIT_CRITICAL(&bridge_stats_lock);
+
+    if (result->status == ESP_OK) {
+        TRACE_RECORD(IEEE802154_TRANSCEIVER_TRACE_RELAY, 0, latency_us);
+    }
+}
+
+// Internal: Receive hook, runs in the receive task
+static void bridge_rx_hook(const uint8_t *frame, const ieee802154_transceiver_header_t *header,
+                           const esp_ieee802154_frame_info_t *frame_info, int64_t rx_time_us, void *arg) {
+    xSemaphoreTake(bridge_mutex, portMAX_DELAY);
+    if (!bridge_running || frame_info->channel != bridge_config.src_channel ||
+        (bridge_config.filter && !transceiver_filter_match(&bridge_filter, header, frame_info))) {
+        xSemaphoreGive(bridge_mutex);
+        return;
+    }
+
+    // The ring slot is read-only here, so rewriting needs a copy
+    static bridge_item_t item;
+    if (bridge_config.rewrite) {
+        memcpy(item.frame, frame, frame[0] + 1);
+        ieee802154_transceiver_rewrite(item.frame, &bridge_rewrite);
+        frame = item.frame;
+    }
+
+    bool queued;
+    if (bridge_config.max_batch == 1) {
+        // No batching: straight from the receive slot to the transmit queue
+        queued = transceiver_transmit_frame_async(frame, bridge_config.dst_channel, bridge_tx_done,
+                                                  (void *)(uintptr_t)(uint32_t)rx_time_us) == ESP_OK;
+    } else {
+        if (frame != item.frame) {
+            memcpy(item.frame, frame, frame[0] + 1);
+        }
+        item.rx_time_us = rx_time_us ? rx_time_us : 1;
+        queued = xQueueSend(bridge_queue, &item, 0) == pdTRUE;
+    }
+    xSemaphoreGive(bridge_mutex);
+
+    portENTER_CRITICAL(&bridge_stats_lock);
+    if (!queued) {
+        bridge_stats.dropped++;
+    } else if (bridge_config.max_batch == 1) {
+        bridge_stats.batches++;
+    }
+    portEXIT_CRITICAL(&bridge_stats_lock);
+}
+
+/**
+ * @brief Start forwarding frames from one channel to another.
+ */
+esp_err_t ieee802154_transceiver_bridge_start(const ieee802154_transceiver_bridge_config_t *config) {
+    if (!config || config->src_channel < 11 || config->src_channel > 26 ||
+        config->dst_channel < 11 || config->dst_channel > 26 ||
+        config->max_batch == 0 || config->max_batch > TX_QUEUE_DEPTH) {
+        ESP_LOGE(TAG, "Invalid bridge configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (bridge_task_handle) {
+        ESP_LOGE(TAG, "Already bridging");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // The batch buffer holds TX_QUEUE_DEPTH frames, and a batch is submitted back-to-back, so it must
+    // also fit in the transmit queue as configured at init
+    size_t tx_depth;
+    esp_err_t ret = transceiver_tx_queue_depth(&tx_depth);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Transceiver not initialized");
+        return ret;
+    }
+    if (config->max_batch > tx_depth) {
+        ESP_LOGE(TAG, "Batch of %d larger than the transmit queue (%u)", config->max_batch, (unsigned)tx_depth);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ret = ieee802154_transceiver_set_channel(config->src_channel);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    bridge_config = *config;
+    if (config->filter) {
+        bridge_filter = *config->filter;
+    }
+    if (config->rewrite) {
+        bridge_rewrite = *config->rewrite;
+    }
+    portENTER_CRITICAL(&bridge_stats_lock);
+    memset(&bridge_stats, 0, sizeof(bridge_stats));
+    bridge_latency_sum_us = 0;
+    portEXIT_CRITICAL(&bridge_stats_lock);
+
+    bridge_queue = xQueueCreate(BRIDGE_QUEUE_DEPTH, sizeof(bridge_item_t));
+    if (!bridge_queue) {
+        ESP_LOGE(TAG, "Failed to create bridge queue");
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(bridge_task, "BRIDGE", 1024 * 3, NULL, 5, &bridge_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create bridge task");
+        vQueueDelete(bridge_queue);
+        bridge_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Created once and kept: a hook may still be waiting on it after a stop
+    if (!bridge_mutex) {
+        bridge_mutex = xSemaphoreCreateMutexStatic(&bridge_mutex_buffer);
+    }
+    xSemaphoreTake(bridge_mutex, portMAX_DELAY);
+    bridge_running = true;
+    xSemaphoreGive(bridge_mutex);
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_BRIDGE, bridge_rx_hook, NULL);
+
+    ESP_LOGI(TAG, "Bridging channel %d to %d (batch=%d, hold=%lu ms)", config->src_channel,
+             config->dst_channel, config->max_batch, (unsigned long)config->max_hold_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop forwarding.
+ */
+esp_err_t ieee802154_transceiver_bridge_stop(void) {
+    if (!bridge_task_handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_BRIDGE, NULL, NULL);
+
+    // A hook already running finishes its send first, or sees the bridge stopped
+    xSemaphoreTake(bridge_mutex, portMAX_DELAY);
+    bridge_running = false;
+    xSemaphoreGive(bridge_mutex);
+
+    // Queue the stop marker behind pending frames and wait for the task to exit
+    static bridge_item_t stop_item;
+    stop_item.rx_time_us = 0;
+    bridge_stop_waiter = xTaskGetCurrentTaskHandle();
+    xQueueSend(bridge_queue, &stop_item, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    bridge_task_handle = NULL;
+
+    vQueueDelete(bridge_queue);
+    bridge_queue = NULL;
+
+    ESP_LOGI(TAG, "Bridging stopped");
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the bridge statistics.
+ */
+esp_err_t ieee802154_transceiver_bridge_get_stats(ieee802154_transceiver_bridge_stats_t *stats, bool reset) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&bridge_stats_lock);
+    uint64_t sum_us = bridge_latency_sum_us;
+    ieee802154_transceiver_bridge_stats_t snapshot = bridge_stats;
+    if (reset) {
+        memset(&bridge_stats, 0, sizeof(bridge_stats));
+        bridge_latency_sum_us = 0;
+    }
+    portEXIT_CRITICAL(&bridge_stats_lock);
+
+    snapshot.latency_avg_us = snapshot.latency_samples ? (uint32_t)(sum_us / snapshot.latency_samples) : 0;
+    *stats = snapshot;
+    return ESP_OK;
+}
+
+/**
+ * @brief Task to collect queued frames into batches and hand them to the transmit task.
+ */
+static void bridge_task(void *pvParameters) {
+    bridge_item_t *batch = bridge_batch;
+    bool running = true;
+
+    while (running) {
+        if (xQueueReceive(bridge_queue, &batch[0], portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        // Fill the batch until it is full or the first frame has waited long enough
+        TickType_t start = xTaskGetTickCount();
+        TickType_t hold = pdMS_TO_TICKS(bridge_config.max_hold_ms);
+        uint8_t count = 0;
+        while (1) {
+            if (batch[count].rx_time_us == 0) {
+                running = false;
+                break;
+            }
+            if (++count >= bridge_config.max_batch) {
+                break;
+            }
+            TickType_t waited = xTaskGetTickCount() - start;
+            if (xQueueReceive(bridge_queue, &batch[count], waited < hold ? hold - waited : 0) != pdTRUE) {
+                break;
+            }
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        // Submit back-to-back so the transmit task sends them all on one switch to dst_channel
+        uint32_t dropped = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            esp_err_t ret = transceiver_transmit_frame_async(batch[i].frame, bridge_config.dst_channel, bridge_tx_done,
+                                                             (void *)(uintptr_t)(uint32_t)batch[i].rx_time_us);
+            if (ret != ESP_OK) {
+                dropped++;
+            }
+        }
+
+        portENTER_CRITICAL(&bridge_stats_lock);
+        bridge_stats.batches++;
+        bridge_stats.dropped += dropped;
+        portEXIT_CRITICAL(&bridge_stats_lock);
+    }
+
+    xTaskNotifyGive(bridge_stop_waiter);
+    vTaskDelete(NULL);
+}
@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#endif
+
+#include "ieee802154_transceiver_capture.h"
+#include "ieee802154_transceiver_priv.h"
+#include "capture_ring.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_CAPTURE"
+
+#define DEFAULT_SIZE (64 * 1024)
+#define MIN_SIZE 1024
+#define PARTITION_LABEL_MAX 16
+
+// Configuration
+static ieee802154_transceiver_capture_config_t capture_config;
+static char capture_partition_label[PARTITION_LABEL_MAX + 1];
+
+// The ring image; frames are only appended while not frozen
+static capture_ring_t *capture_ring = NULL;
+static int64_t capture_deadline_us = 0; // Freeze time after a trigger
+static ieee802154_transceiver_capture_stats_t capture_stats;
+static portMUX_TYPE capture_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Internal: Allocate the ring image, from PSRAM if asked to
+static void *capture_image_alloc(size_t size, bool use_psram) {
+#if CONFIG_IDF_TARGET_LINUX
+    return malloc(size);
+#else
+    return heap_caps_malloc(size, use_psram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT);
+#endif
+}
+
+// Internal: Freeze once the post-trigger time is over; call with the lock held
+static void capture_check_deadline(int64_t now_us) {
+    if ((capture_ring->flags & (CAPTURE_RING_FLAG_TRIGGERED | CAPTURE_RING_FLAG_FROZEN)) ==
+            CAPTURE_RING_FLAG_TRIGGERED && now_us >= capture_deadline_us) {
+        capture_ring->flags |= CAPTURE_RING_FLAG_FROZEN;
+    }
+}
+
+// Internal: Append every received frame to the ring (receive task)
+static void capture_rx_hook(const uint8_t *frame, const ieee802154_transceiver_header_t *header,
+                            const esp_ieee802154_frame_info_t *frame_info, int64_t rx_time_us, void *arg) {
+    if (frame[0] > 127) {
+        return;
+    }
+
+    portENTER_CRITICAL(&capture_lock);
+    if (capture_ring) {
+        capture_check_deadline(rx_time_us);
+        if (capture_ring->flags & CAPTURE_RING_FLAG_FROZEN) {
+            capture_stats.ignored++;
+        } else {
+            capture_stats.evicted += capture_ring_append(capture_ring, frame, frame_info, rx_time_us);
+            capture_stats.frames++;
+        }
+    }
+    portEXIT_CRITICAL(&capture_lock);
+}
+
+/**
+ * @brief Start recording received frames into an empty capture ring.
+ */
+esp_err_t ieee802154_transceiver_capture_start(const ieee802154_transceiver_capture_config_t *config) {
+    if (!config || (config->size != 0 && config->size < MIN_SIZE) ||
+        (config->partition_label && strlen(config->partition_label) > PARTITION_LABEL_MAX)) {
+        ESP_LOGE(TAG, "Invalid capture ring configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (capture_ring) {
+        ESP_LOGE(TAG, "Capture ring already started");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    capture_config = *config;
+    if (capture_config.size == 0) {
+        capture_config.size = DEFAULT_SIZE;
+    }
+    capture_config.size &= ~(size_t)7; // 64-bit header fields stay aligned
+    capture_partition_label[0] = '\0';
+    if (config->partition_label) {
+        strcpy(capture_partition_label, config->partition_label);
+        capture_config.partition_label = capture_partition_label;
+    }
+
+    capture_ring_t *ring = capture_image_alloc(capture_config.size, capture_config.use_psram);
+    if (!ring) {
+        ESP_LOGE(TAG, "Failed to allocate %u byte capture ring", (unsigned)capture_config.size);
+        return ESP_ERR_NO_MEM;
+    }
+    capture_ring_init(ring, capture_config.size);
+
+    // Records are timed on the transceiver clock; the image carries the offset to the epoch
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    ring->epoch_offset_us = (int64_t)now.tv_sec * 1000000 + now.tv_usec - transceiver_now_us();
+
+    portENTER_CRITICAL(&capture_lock);
+    memset(&capture_stats, 0, sizeof(capture_stats));
+    capture_ring = ring;
+    portEXIT_CRITICAL(&capture_lock);
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_CAPTURE, capture_rx_hook, NULL);
+
+    ESP_LOGI(TAG, "Capture ring started (%u bytes%s)", (unsigned)capture_config.size,
+             capture_config.use_psram ? ", PSRAM" : "");
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop recording and release the ring.
+ */
+esp_err_t ieee802154_transceiver_capture_stop(void) {
+    if (!capture_ring) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_CAPTURE, NULL, NULL);
+
+    // A hook already running sees the ring gone under the lock
+    portENTER_CRITICAL(&capture_lock);
+    capture_ring_t *ring = capture_ring;
+    capture_ring = NULL;
+    portEXIT_CRITICAL(&capture_lock);
+    free(ring);
+
+    ESP_LOGI(TAG, "Capture ring stopped");
+    return ESP_OK;
+}
+
+/**
+ * @brief Mark an incident: keep recording for post_trigger_ms, then freeze.
+ */
+esp_err_t ieee802154_transceiver_capture_trigger(void) {
+    int64_t now_us = transceiver_now_us();
+
+    portENTER_CRITICAL(&capture_lock);
+    if (!capture_ring) {
+        portEXIT_CRITICAL(&capture_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!(capture_ring->flags & CAPTURE_RING_FLAG_TRIGGERED)) {
+        capture_ring->flags |= CAPTURE_RING_FLAG_TRIGGERED;
+        capture_ring->trigger_time_us = now_us;
+        capture_deadline_us = now_us + (int64_t)capture_config.post_trigger_ms * 1000;
+        capture_check_deadline(now_us);
+    }
+    portEXIT_CRITICAL(&capture_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Freeze the ring now.
+ */
+esp_err_t ieee802154_transceiver_capture_freeze(void) {
+    portENTER_CRITICAL(&capture_lock);
+    if (!capture_ring) {
+        portEXIT_CRITICAL(&capture_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    capture_ring->flags |= CAPTURE_RING_FLAG_FROZEN;
+    portEXIT_CRITICAL(&capture_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Clear any trigger and go on recording; the ring keeps its records.
+ */
+esp_err_t ieee802154_transceiver_capture_resume(void) {
+    portENTER_CRITICAL(&capture_lock);
+    if (!capture_ring) {
+        portEXIT_CRITICAL(&capture_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    capture_ring->flags = 0;
+    capture_ring->trigger_time_us = 0;
+    portEXIT_CRITICAL(&capture_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the ring image of a frozen ring.
+ */
+esp_err_t ieee802154_transceiver_capture_get_image(const uint8_t **image, size_t *len) {
+    if (!image || !len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&capture_lock);
+    if (capture_ring) {
+        capture_check_deadline(transceiver_now_us());
+    }
+    if (!capture_ring || !(capture_ring->flags & CAPTURE_RING_FLAG_FROZEN)) {
+        portEXIT_CRITICAL(&capture_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    *image = (const uint8_t *)capture_ring;
+    *len = capture_ring_image_len(capture_ring);
+    portEXIT_CRITICAL(&capture_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Write the image of a frozen ring to the configured flash partition.
+ */
+esp_err_t ieee802154_transceiver_capture_save(void) {
+    const uint8_t *image;
+    size_t len;
+    esp_err_t ret = ieee802154_transceiver_capture_get_image(&image, &len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+#if CONFIG_IDF_TARGET_LINUX
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    if (!capture_config.partition_label) {
+        ESP_LOGE(TAG, "No capture partition configured");
+        return ESP_ERR_NOT_FOUND;
+    }
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                                capture_config.partition_label);
+    if (!partition) {
+        ESP_LOGE(TAG, "Capture partition '%s' not found", capture_config.partition_label);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (len > partition->size) {
+        ESP_LOGE(TAG, "Capture image (%u bytes) does not fit partition '%s'", (unsigned)len, partition->label);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t erase_len = (len + partition->erase_size - 1) / partition->erase_size * partition->erase_size;
+    ret = esp_partition_erase_range(partition, 0, erase_len);
+    if (ret == ESP_OK) {
+        ret = esp_partition_write(partition, 0, image, len);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save capture image: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Saved %u byte capture image to partition '%s'", (unsigned)len, partition->label);
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief Get the capture ring statistics.
+ */
+esp_err_t ieee802154_transceiver_capture_get_stats(ieee802154_transceiver_capture_stats_t *stats, bool reset) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&capture_lock);
+    if (capture_ring) {
+        capture_check_deadline(transceiver_now_us());
+        capture_stats.records = capture_ring->records;
+        capture_stats.used = capture_ring->used;
+        capture_stats.triggered = (capture_ring->flags & CAPTURE_RING_FLAG_TRIGGERED) != 0;
+        capture_stats.frozen = (capture_ring->flags & CAPTURE_RING_FLAG_FROZEN) != 0;
+    }
+    *stats = capture_stats;
+    if (reset) {
+        capture_stats.frames = 0;
+        capture_stats.evicted = 0;
+        capture_stats.ignored = 0;
+    }
+    portEXIT_CRITICAL(&capture_lock);
+    return ESP_OK;
+}
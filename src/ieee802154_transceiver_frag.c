@@ -0,0 +1,406 @@
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_frag.h"
+#include "ieee802154_transceiver_priv.h"
+#include "reassembly.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_FRAG"
+
+#define MAX_PSDU_LEN 127
+#define FCS_LEN 2
+#define DEFAULT_SLOTS 4
+#define DEFAULT_MAX_SIZE 4096
+#define DEFAULT_TIMEOUT_MS 1000
+#define MAX_SLOTS 16
+#define TX_WAIT_MS 1000 // Allowed without any progress from the transmit task
+
+// Completion state of one fragmented transmission, on the sender's stack
+typedef struct {
+    TaskHandle_t task;
+    uint32_t reported; // Fragments reported by the transmit task
+    uint32_t sent;
+    uint32_t failed;
+    uint32_t retries;
+    int64_t done_us;   // Report of the latest fragment
+} frag_send_state_t;
+
+// Reassembly pool, used by the receive task under the mutex, which the callback runs under
+static reassembly_pool_t frag_pool;
+static void *frag_storage = NULL;
+static bool frag_rx_started = false;
+static ieee802154_transceiver_frag_rx_callback_t frag_rx_callback = NULL;
+static void *frag_rx_ctx = NULL;
+static SemaphoreHandle_t frag_rx_mutex = NULL;
+static StaticSemaphore_t frag_rx_mutex_buffer;
+
+// Tag of the next datagram sent
+static atomic_uint_least16_t frag_next_tag;
+
+// Statistics, updated from the sending tasks, the transmit task and the receive task
+static ieee802154_transceiver_frag_stats_t frag_stats;
+static portMUX_TYPE frag_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Internal: Fragment completion, runs in the transmit task
+static void frag_tx_done(const ieee802154_transceiver_tx_result_t *result, void *ctx) {
+    frag_send_state_t *state = ctx;
+
+    // The sender may return as soon as the last report is counted; nothing of state is touched after
+    portENTER_CRITICAL(&frag_lock);
+    TaskHandle_t task = state->task;
+    if (result->status == ESP_OK) {
+        state->sent++;
+        frag_stats.tx_fragments++;
+    } else {
+        state->failed++;
+    }
+    state->retries += result->retries;
+    state->done_us = result->done_time_us ? result->done_time_us : transceiver_now_us();
+    state->reported++;
+    portEXIT_CRITICAL(&frag_lock);
+
+    xTaskNotifyGive(task);
+}
+
+// Internal: Copy the next len bytes of the pieces, advancing the cursor
+static void frag_gather(const ieee802154_transceiver_frag_iov_t *iov, size_t *piece, size_t *offset, uint8_t *out,
+                        size_t len) {
+    while (len > 0) {
+        const ieee802154_transceiver_frag_iov_t *current = &iov[*piece];
+        size_t take = current->len - *offset;
+        if (take > len) {
+            take = len;
+        }
+        memcpy(out, (const uint8_t *)current->data + *offset, take);
+        out += take;
+        len -= take;
+        *offset += take;
+        if (*offset == current->len) {
+            (*piece)++;
+            *offset = 0;
+        }
+    }
+}
+
+// Internal: Fragments reported so far, read under the lock
+static uint32_t frag_reported(frag_send_state_t *state) {
+    portENTER_CRITICAL(&frag_lock);
+    uint32_t reported = state->reported;
+    portEXIT_CRITICAL(&frag_lock);
+    return reported;
+}
+
+/**
+ * @brief Send a datagram gathered from several pieces, cut into fragments.
+ */
+esp_err_t ieee802154_transceiver_frag_send(const ieee802154_frame_t *frame, const ieee802154_transceiver_frag_iov_t *iov,
+                                           size_t iov_count, uint8_t channel,
+                                           ieee802154_transceiver_frag_send_result_t *result) {
+    if (!frame || (!iov && iov_count > 0) || (channel != 0 && (channel < 11 || channel > 26))) {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < iov_count; i++) {
+        if (!iov[i].data && iov[i].len > 0) {
+            ESP_LOGE(TAG, "Invalid piece %u", (unsigned)i);
+            return ESP_ERR_INVALID_ARG;
+        }
+        total += iov[i].len;
+    }
+    if (total == 0 || total > UINT16_MAX) {
+        ESP_LOGE(TAG, "Invalid datagram size: %u", (unsigned)total);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t space = 0;
+    if (transceiver_tx_queue_space(&space) != ESP_OK) {
+        ESP_LOGE(TAG, "Transceiver not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // The caller's MAC header, built once; fragments are written after it in place
+    ieee802154_transceiver_template_t tmpl;
+    ieee802154_frame_t header = *frame;
+    uint8_t no_payload = 0;
+    header.payload = &no_payload;
+    header.payloadLen = 0;
+    esp_err_t ret = ieee802154_transceiver_template_build(&tmpl, &header);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int room = MAX_PSDU_LEN - FCS_LEN - (tmpl.payload_offset - 1) - IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN;
+    if (room < REASSEMBLY_MIN_CHUNK) {
+        ESP_LOGE(TAG, "No room for fragments after a %d-byte header", tmpl.payload_offset - 1);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint8_t chunk = room > UINT8_MAX ? UINT8_MAX : (uint8_t)room;
+    uint32_t fragments = reassembly_fragment_count(total, chunk);
+    uint16_t tag = atomic_fetch_add(&frag_next_tag, 1);
+
+    frag_send_state_t state = { .task = xTaskGetCurrentTaskHandle() };
+    ulTaskNotifyTake(pdTRUE, 0); // Drop a stale report
+    int64_t start_us = transceiver_now_us();
+
+    size_t piece = 0;
+    size_t piece_offset = 0;
+    uint32_t queued = 0;
+    for (uint32_t index = 0; index < fragments && ret == ESP_OK; index++) {
+        portENTER_CRITICAL(&frag_lock);
+        bool failed = state.failed > 0;
+        portEXIT_CRITICAL(&frag_lock);
+        if (failed) {
+            break;
+        }
+
+        size_t len = total - index * chunk < chunk ? total - index * chunk : chunk;
+        uint8_t *p = &tmpl.frame[tmpl.payload_offset];
+        p[0] = IEEE802154_TRANSCEIVER_FRAG_DISPATCH;
+        p[1] = chunk;
+        p[2] = tag & 0xff;
+        p[3] = tag >> 8;
+        p[4] = total & 0xff;
+        p[5] = total >> 8;
+        p[6] = index & 0xff;
+        p[7] = index >> 8;
+        frag_gather(iov, &piece, &piece_offset, &p[IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN], len);
+        tmpl.frame[0] = tmpl.payload_offset - 1 + IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN + len + FCS_LEN;
+        ieee802154_transceiver_template_set_seq(&tmpl, frame->sequenceNumber + index);
+
+        // Keep the transmit queue full: wait for a free entry, a report or a tick at a time
+        TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(TX_WAIT_MS);
+        uint32_t progress = frag_reported(&state);
+        while (1) {
+            ret = transceiver_tx_queue_space(&space);
+            if (ret != ESP_OK) {
+                break;
+            }
+            if (space > 0) {
+                ret = transceiver_transmit_frame_async(tmpl.frame, channel, frag_tx_done, &state);
+                if (ret != ESP_ERR_NO_MEM) {
+                    break; // Taken by another sender otherwise
+                }
+            }
+            if (frag_reported(&state) != progress) {
+                progress = frag_reported(&state);
+                deadline = xTaskGetTickCount() + pdMS_TO_TICKS(TX_WAIT_MS);
+            } else if ((int32_t)(xTaskGetTickCount() - deadline) >= 0) {
+                ESP_LOGE(TAG, "Transmit queue stalled");
+                ret = ESP_ERR_TIMEOUT;
+                break;
+            }
+            ulTaskNotifyTake(pdTRUE, 1);
+        }
+        if (ret == ESP_OK) {
+            queued++;
+        } else if (ret != ESP_ERR_TIMEOUT) {
+            ESP_LOGE(TAG, "Failed to queue fragment %" PRIu32 ": %d", index, ret);
+        }
+    }
+
+    // Wait for the queued fragments to be reported
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(TX_WAIT_MS);
+    uint32_t progress = frag_reported(&state);
+    while (progress < queued) {
+        if ((int32_t)(xTaskGetTickCount() - deadline) >= 0) {
+            // The transmit task still holds a pointer to state; it can only be left once reported
+            ESP_LOGW(TAG, "Waiting for %" PRIu32 " fragment reports", queued - progress);
+            deadline = xTaskGetTickCount() + pdMS_TO_TICKS(TX_WAIT_MS);
+            ret = ret == ESP_OK ? ESP_ERR_TIMEOUT : ret;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+        progress = frag_reported(&state);
+    }
+
+    portENTER_CRITICAL(&frag_lock);
+    bool complete = ret == ESP_OK && state.sent == fragments;
+    if (complete) {
+        frag_stats.tx_datagrams++;
+    } else {
+        frag_stats.tx_failed++;
+    }
+    portEXIT_CRITICAL(&frag_lock);
+    if (ret == ESP_OK && !complete) {
+        ret = ESP_FAIL;
+    }
+
+    if (result) {
+        result->tag = tag;
+        result->fragments = (uint16_t)fragments;
+        result->sent = (uint16_t)state.sent;
+        result->retries = (uint16_t)state.retries;
+        result->duration_us = (uint32_t)((queued ? state.done_us : transceiver_now_us()) - start_us);
+    }
+    return ret;
+}
+
+// Internal: Reassemble the fragments among received frames (receive task)
+static void frag_rx_hook(const uint8_t *frame, const ieee802154_transceiver_header_t *header,
+                         const esp_ieee802154_frame_info_t *frame_info, int64_t rx_time_us, void *arg) {
+    if (!header ||
+        ieee802154_transceiver_header_frame_type(header) != IEEE802154_FRAME_TYPE_DATA ||
+        (header->fcf & ((1 << 3) | (1 << 9)))) { // Security enabled, IE present
+        return;
+    }
+    int payload_len = frame[0] - FCS_LEN + 1 - header->payload_offset;
+    const uint8_t *p = &frame[header->payload_offset];
+    if (payload_len <= IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN || p[0] != IEEE802154_TRANSCEIVER_FRAG_DISPATCH) {
+        return;
+    }
+
+    // Datagrams are told apart by sender; short addresses are scoped by the source PAN
+    const uint8_t *src_addr = ieee802154_transceiver_header_src_addr(header);
+    if (!src_addr) {
+        portENTER_CRITICAL(&frag_lock);
+        frag_stats.rx_invalid++;
+        portEXIT_CRITICAL(&frag_lock);
+        return;
+    }
+    uint16_t pan_id = 0xffff;
+    if (!ieee802154_transceiver_header_src_pan(header, &pan_id)) {
+        ieee802154_transceiver_header_dest_pan(header, &pan_id);
+    }
+    reassembly_fragment_t fragment = {
+        .chunk = p[1],
+        .tag = p[2] | (p[3] << 8),
+        .size = p[4] | (p[5] << 8),
+        .index = p[6] | (p[7] << 8),
+    };
+    reassembly_key_t key = reassembly_key(src_addr, header->src_addr_len, pan_id, fragment.tag);
+
+    xSemaphoreTake(frag_rx_mutex, portMAX_DELAY);
+    if (!frag_rx_started) {
+        xSemaphoreGive(frag_rx_mutex);
+        return;
+    }
+    uint32_t expired = reassembly_expire(&frag_pool, rx_time_us);
+    reassembly_slot_t *slot = NULL;
+    reassembly_status_t status = reassembly_add(&frag_pool, &key, &fragment, &p[IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN],
+                                                payload_len - IEEE802154_TRANSCEIVER_FRAG_HEADER_LEN, rx_time_us, &slot);
+
+    portENTER_CRITICAL(&frag_lock);
+    frag_stats.rx_timeouts += expired;
+    switch (status) {
+    case REASSEMBLY_ADDED:
+        frag_stats.rx_fragments++;
+        break;
+    case REASSEMBLY_COMPLETE:
+        frag_stats.rx_fragments++;
+        frag_stats.rx_datagrams++;
+        break;
+    case REASSEMBLY_DUPLICATE:
+        frag_stats.rx_duplicates++;
+        break;
+    case REASSEMBLY_INVALID:
+        frag_stats.rx_invalid++;
+        break;
+    case REASSEMBLY_TOO_LARGE:
+        frag_stats.rx_too_large++;
+        break;
+    case REASSEMBLY_NO_SLOT:
+        frag_stats.rx_no_slot++;
+        break;
+    }
+    portEXIT_CRITICAL(&frag_lock);
+
+    if (status == REASSEMBLY_COMPLETE) {
+        ieee802154_transceiver_frag_source_t source = {
+            .addr_len = header->src_addr_len,
+            .pan_id = key.pan_id,
+            .tag = fragment.tag,
+            .fragments = slot->fragments,
+            .duration_us = (uint32_t)(slot->last_us - slot->first_us),
+        };
+        memcpy(source.addr, src_addr, header->src_addr_len);
+        frag_rx_callback(slot->data, slot->size, &source, frag_rx_ctx);
+        reassembly_release(&frag_pool, slot);
+    }
+    xSemaphoreGive(frag_rx_mutex);
+}
+
+/**
+ * @brief Start reassembling the fragments heard by the receive task.
+ */
+esp_err_t ieee802154_transceiver_frag_rx_start(const ieee802154_transceiver_frag_rx_config_t *config) {
+    if (!config || !config->callback || config->slots > MAX_SLOTS) {
+        ESP_LOGE(TAG, "Invalid reassembly configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (frag_rx_started) {
+        ESP_LOGE(TAG, "Reassembly already started");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t slots = config->slots ? config->slots : DEFAULT_SLOTS;
+    uint16_t max_size = config->max_size ? config->max_size : DEFAULT_MAX_SIZE;
+    uint32_t timeout_ms = config->timeout_ms ? config->timeout_ms : DEFAULT_TIMEOUT_MS;
+    void *storage = calloc(1, reassembly_storage_size(slots, max_size));
+    if (!storage) {
+        ESP_LOGE(TAG, "Failed to allocate reassembly buffers");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Created once and kept: a hook may still be waiting on it after a stop
+    if (!frag_rx_mutex) {
+        frag_rx_mutex = xSemaphoreCreateMutexStatic(&frag_rx_mutex_buffer);
+    }
+    xSemaphoreTake(frag_rx_mutex, portMAX_DELAY);
+    reassembly_init(&frag_pool, storage, slots, max_size, (int64_t)timeout_ms * 1000);
+    frag_storage = storage;
+    frag_rx_callback = config->callback;
+    frag_rx_ctx = config->ctx;
+    frag_rx_started = true;
+    xSemaphoreGive(frag_rx_mutex);
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_FRAG, frag_rx_hook, NULL);
+
+    ESP_LOGI(TAG, "Reassembly started (slots=%u, max_size=%u, timeout=%" PRIu32 " ms)", slots, max_size, timeout_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop reassembling and release the buffers.
+ */
+esp_err_t ieee802154_transceiver_frag_rx_stop(void) {
+    if (!frag_rx_started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_FRAG, NULL, NULL);
+
+    // A hook already running finishes its callback first, or sees the pool gone
+    xSemaphoreTake(frag_rx_mutex, portMAX_DELAY);
+    frag_rx_started = false;
+    void *storage = frag_storage;
+    frag_storage = NULL;
+    memset(&frag_pool, 0, sizeof(frag_pool));
+    xSemaphoreGive(frag_rx_mutex);
+    free(storage);
+
+    ESP_LOGI(TAG, "Reassembly stopped");
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the fragmentation statistics.
+ */
+esp_err_t ieee802154_transceiver_frag_get_stats(ieee802154_transceiver_frag_stats_t *stats, bool reset) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&frag_lock);
+    *stats = frag_stats;
+    if (reset) {
+        memset(&frag_stats, 0, sizeof(frag_stats));
+    }
+    portEXIT_CRITICAL(&frag_lock);
+    return ESP_OK;
+}
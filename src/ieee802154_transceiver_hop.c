@@ -0,0 +1,147 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_hop.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_HOP"
+
+// Global state
+static ieee802154_transceiver_hop_config_t hop_config;
+static TaskHandle_t hop_task_handle = NULL;
+static TaskHandle_t hop_stop_waiter = NULL;
+static volatile bool hop_running = false;
+
+// Counters at hop start, and scheduler counters per channel
+static ieee802154_transceiver_channel_stats_t hop_baseline[16];
+static uint32_t hop_visits[16];
+static uint32_t hop_dwell_ms[16];
+
+// Forward declarations
+static void hop_task(void *pvParameters);
+
+// Internal: Frames heard on a channel so far
+static uint32_t channel_frames(uint8_t channel) {
+    ieee802154_transceiver_channel_stats_t stats;
+    ieee802154_transceiver_get_channel_stats(channel, &stats);
+    return stats.frames;
+}
+
+// Internal: Sleep for a dwell window; returns false if asked to stop
+static bool hop_wait(uint32_t ms) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms) ? pdMS_TO_TICKS(ms) : 1);
+    return hop_running;
+}
+
+/**
+ * @brief Start cycling through a set of channels.
+ */
+esp_err_t ieee802154_transceiver_hop_start(const ieee802154_transceiver_hop_config_t *config) {
+    if (!config || (config->channel_mask & IEEE802154_TRANSCEIVER_HOP_ALL_CHANNELS) == 0 ||
+        (config->channel_mask & ~IEEE802154_TRANSCEIVER_HOP_ALL_CHANNELS) != 0 || config->dwell_ms == 0) {
+        ESP_LOGE(TAG, "Invalid hopping configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (hop_task_handle) {
+        ESP_LOGE(TAG, "Already hopping");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    hop_config = *config;
+    for (uint8_t channel = 11; channel <= 26; channel++) {
+        ieee802154_transceiver_get_channel_stats(channel, &hop_baseline[channel - 11]);
+    }
+    memset(hop_visits, 0, sizeof(hop_visits));
+    memset(hop_dwell_ms, 0, sizeof(hop_dwell_ms));
+
+    hop_running = true;
+    if (xTaskCreate(hop_task, "HOP", 1024 * 3, NULL, 6, &hop_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create hopping task");
+        hop_running = false;
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Hopping started (mask=0x%08lx, dwell=%lu ms)",
+             (unsigned long)config->channel_mask, (unsigned long)config->dwell_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop hopping and stay on the current channel.
+ */
+esp_err_t ieee802154_transceiver_hop_stop(void) {
+    if (!hop_task_handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Let the task finish its channel switch and exit by itself
+    hop_stop_waiter = xTaskGetCurrentTaskHandle();
+    hop_running = false;
+    xTaskNotifyGive(hop_task_handle);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    hop_task_handle = NULL;
+
+    ESP_LOGI(TAG, "Hopping stopped");
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the hopping statistics of a channel.
+ */
+esp_err_t ieee802154_transceiver_hop_get_stats(uint8_t channel, ieee802154_transceiver_hop_stats_t *stats) {
+    ieee802154_transceiver_channel_stats_t now;
+    esp_err_t ret = ieee802154_transceiver_get_channel_stats(channel, &now);
+    if (ret != ESP_OK || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const ieee802154_transceiver_channel_stats_t *base = &hop_baseline[channel - 11];
+    stats->frames = now.frames - base->frames;
+    stats->bytes = now.bytes - base->bytes;
+    stats->drops = now.drops - base->drops;
+    stats->visits = hop_visits[channel - 11];
+    stats->dwell_ms = hop_dwell_ms[channel - 11];
+    return ESP_OK;
+}
+
+/**
+ * @brief Task to visit each channel of the mask in turn.
+ */
+static void hop_task(void *pvParameters) {
+    bool adaptive = hop_config.max_dwell_ms > hop_config.dwell_ms && hop_config.extend_ms > 0;
+
+    while (hop_running) {
+        for (uint8_t channel = 11; channel <= 26 && hop_running; channel++) {
+            if (!(hop_config.channel_mask & (1UL << channel))) {
+                continue;
+            }
+
+            if (ieee802154_transceiver_set_channel(channel) != ESP_OK) {
+                continue;
+            }
+            hop_visits[channel - 11]++;
+
+            // Base dwell, then extend while the last window carried traffic
+            uint32_t frames = channel_frames(channel);
+            uint32_t dwell = hop_config.dwell_ms;
+            if (hop_wait(dwell) && adaptive) {
+                while (channel_frames(channel) != frames &&
+                       dwell + hop_config.extend_ms <= hop_config.max_dwell_ms) {
+                    frames = channel_frames(channel);
+                    dwell += hop_config.extend_ms;
+                    if (!hop_wait(hop_config.extend_ms)) {
+                        break;
+                    }
+                }
+            }
+            hop_dwell_ms[channel - 11] += dwell;
+        }
+    }
+
+    xTaskNotifyGive(hop_stop_waiter);
+    vTaskDelete(NULL);
+}
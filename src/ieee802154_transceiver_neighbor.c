@@ -0,0 +1,205 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_log.h"
+
+#include "ieee802154_transceiver_neighbor.h"
+#include "ieee802154_transceiver_priv.h"
+#include "neighbor_table.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_NEIGHBOR"
+
+#define DEFAULT_CAPACITY 32
+#define DEFAULT_EWMA_SHIFT 3
+#define MAX_CAPACITY 1024
+#define MAX_EWMA_SHIFT 7
+
+// The table, updated by the receive task and read by the application under the lock
+static neighbor_table_t neighbor_table;
+static bool neighbor_started = false;
+static ieee802154_transceiver_neighbor_stats_t neighbor_stats;
+static portMUX_TYPE neighbor_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Internal: Account every received frame to its sender (receive task)
+static void neighbor_rx_hook(const uint8_t *frame, const ieee802154_transceiver_header_t *header,
+                             const esp_ieee802154_frame_info_t *frame_info, int64_t rx_time_us, void *arg) {
+    const uint8_t *src_addr;
+    if (!header || !(src_addr = ieee802154_transceiver_header_src_addr(header))) {
+        portENTER_CRITICAL(&neighbor_lock);
+        neighbor_stats.ignored++;
+        portEXIT_CRITICAL(&neighbor_lock);
+        return;
+    }
+
+    // Short addresses are scoped by the source PAN, which is the destination PAN when compressed
+    uint16_t pan_id = 0xffff;
+    if (!ieee802154_transceiver_header_src_pan(header, &pan_id)) {
+        ieee802154_transceiver_header_dest_pan(header, &pan_id);
+    }
+    neighbor_key_t key = neighbor_table_key(src_addr, header->src_addr_len, pan_id);
+
+    // Beacons are numbered apart from the data sequence
+    uint8_t seq = 0;
+    bool has_seq = ieee802154_transceiver_header_frame_type(header) != IEEE802154_FRAME_TYPE_BEACON &&
+                   ieee802154_transceiver_header_seq(header, &seq);
+
+    portENTER_CRITICAL(&neighbor_lock);
+    if (neighbor_started) {
+        if (neighbor_table_update(&neighbor_table, &key, frame_info->rssi, frame_info->lqi, has_seq, seq,
+                                  rx_time_us)) {
+            neighbor_stats.evicted++;
+        }
+        neighbor_stats.updates++;
+    }
+    portEXIT_CRITICAL(&neighbor_lock);
+}
+
+/**
+ * @brief Start tracking the neighbors heard by the receive task, with an empty table.
+ */
+esp_err_t ieee802154_transceiver_neighbor_start(const ieee802154_transceiver_neighbor_config_t *config) {
+    ieee802154_transceiver_neighbor_config_t defaults = { 0 };
+    if (!config) {
+        config = &defaults;
+    }
+    if (config->capacity > MAX_CAPACITY || config->ewma_shift > MAX_EWMA_SHIFT) {
+        ESP_LOGE(TAG, "Invalid neighbor table configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (neighbor_started) {
+        ESP_LOGE(TAG, "Neighbor table already started");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint16_t capacity = config->capacity ? config->capacity : DEFAULT_CAPACITY;
+    uint8_t ewma_shift = config->ewma_shift ? config->ewma_shift : DEFAULT_EWMA_SHIFT;
+    neighbor_entry_t *entries = calloc(capacity, sizeof(neighbor_entry_t));
+    uint16_t *slots = calloc(neighbor_table_slot_count(capacity), sizeof(uint16_t));
+    if (!entries || !slots) {
+        free(entries);
+        free(slots);
+        ESP_LOGE(TAG, "Failed to allocate neighbor table");
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&neighbor_lock);
+    neighbor_table_init(&neighbor_table, entries, capacity, slots, ewma_shift);
+    memset(&neighbor_stats, 0, sizeof(neighbor_stats));
+    neighbor_started = true;
+    portEXIT_CRITICAL(&neighbor_lock);
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_NEIGHBOR, neighbor_rx_hook, NULL);
+
+    ESP_LOGI(TAG, "Neighbor table started (capacity=%u, weight=1/%u)", capacity, 1u << ewma_shift);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop tracking neighbors and release the table.
+ */
+esp_err_t ieee802154_transceiver_neighbor_stop(void) {
+    if (!neighbor_started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    transceiver_set_rx_hook(TRANSCEIVER_HOOK_NEIGHBOR, NULL, NULL);
+
+    // A hook already running sees the table gone under the lock
+    portENTER_CRITICAL(&neighbor_lock);
+    neighbor_started = false;
+    neighbor_entry_t *entries = neighbor_table.entries;
+    uint16_t *slots = neighbor_table.slots;
+    memset(&neighbor_table, 0, sizeof(neighbor_table));
+    portEXIT_CRITICAL(&neighbor_lock);
+    free(entries);
+    free(slots);
+
+    ESP_LOGI(TAG, "Neighbor table stopped");
+    return ESP_OK;
+}
+
+/**
+ * @brief Look a neighbor up by address, in constant time.
+ */
+esp_err_t ieee802154_transceiver_neighbor_get(const uint8_t *addr, uint8_t addr_len, uint16_t pan_id,
+                                              ieee802154_transceiver_neighbor_t *neighbor) {
+    if (!addr || !neighbor || (addr_len != 2 && addr_len != 8)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    neighbor_key_t key = neighbor_table_key(addr, addr_len, pan_id);
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&neighbor_lock);
+    if (!neighbor_started) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        const neighbor_entry_t *entry = neighbor_table_get(&neighbor_table, &key);
+        if (entry) {
+            *neighbor = entry->info;
+        } else {
+            ret = ESP_ERR_NOT_FOUND;
+        }
+    }
+    portEXIT_CRITICAL(&neighbor_lock);
+    return ret;
+}
+
+/**
+ * @brief Copy the neighbors out, most recently heard first.
+ */
+esp_err_t ieee802154_transceiver_neighbor_list(ieee802154_transceiver_neighbor_t *neighbors, size_t max,
+                                               size_t *count) {
+    if (!neighbors || !count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&neighbor_lock);
+    if (!neighbor_started) {
+        portEXIT_CRITICAL(&neighbor_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    size_t filled = 0;
+    for (uint16_t index = neighbor_table.head; index != NEIGHBOR_TABLE_NONE && filled < max;
+         index = neighbor_table.entries[index].next) {
+        neighbors[filled++] = neighbor_table.entries[index].info;
+    }
+    portEXIT_CRITICAL(&neighbor_lock);
+
+    *count = filled;
+    return ESP_OK;
+}
+
+/**
+ * @brief Empty the table; statistics are kept.
+ */
+esp_err_t ieee802154_transceiver_neighbor_clear(void) {
+    portENTER_CRITICAL(&neighbor_lock);
+    if (!neighbor_started) {
+        portEXIT_CRITICAL(&neighbor_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    neighbor_table_clear(&neighbor_table);
+    portEXIT_CRITICAL(&neighbor_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the neighbor table statistics.
+ */
+esp_err_t ieee802154_transceiver_neighbor_get_stats(ieee802154_transceiver_neighbor_stats_t *stats, bool reset) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&neighbor_lock);
+    neighbor_stats.neighbors = neighbor_table.count;
+    *stats = neighbor_stats;
+    if (reset) {
+        neighbor_stats.updates = 0;
+        neighbor_stats.evicted = 0;
+        neighbor_stats.ignored = 0;
+    }
+    portEXIT_CRITICAL(&neighbor_lock);
+    return ESP_OK;
+}
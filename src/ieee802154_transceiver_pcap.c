@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_heap_caps.h"
+#endif
+
+#include "ieee802154_transceiver_pcap.h"
+#include "ieee802154_transceiver_priv.h"
+#include "pcapng.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_PCAP"
+
+#define DEFAULT_BLOCK_SIZE 4096
+#define DEFAULT_FLUSH_MS 100
+#define MIN_BLOCK_SIZE (PCAPNG_HEADER_LEN + PCAPNG_EPB_MAX_LEN)
+
+// Configuration
+static ieee802154_transceiver_pcap_config_t pcap_config;
+static int64_t pcap_epoch_offset_us = 0;
+
+// Double buffer: frames are recorded into the active block while the other one is with the output
+static uint8_t *pcap_blocks[2] = { NULL, NULL };
+static size_t pcap_fill[2] = { 0, 0 };
+static uint8_t pcap_active = 0;
+static bool pcap_sending = false;
+static int64_t pcap_first_us = 0; // When the active block got its first bytes
+static bool pcap_running = false;
+static bool pcap_stop_requested = false;
+static ieee802154_transceiver_pcap_stats_t pcap_stats;
+static portMUX_TYPE pcap_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t pcap_task_handle = NULL;
+static TaskHandle_t pcap_stop_waiter = NULL;
+
+// Forward declarations
+static void pcap_task(void *pvParameters);
+
+// Internal: Allocate an output block, from DMA-capable memory on the device
+static uint8_t *pcap_block_alloc(size_t size) {
+#if CONFIG_IDF_TARGET_LINUX
+    return malloc(size);
+#else
+    return heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+#endif
+}
+
+// Internal: Release the output blocks
+static void pcap_blocks_free(void) {
+    for (int i = 0; i < 2; i++) {
+        free(pcap_blocks[i]);
+        pcap_blocks[i] = NULL;
+    }
+}
+
+/**
+ * @brief Start a capture stream.
+ */
+esp_err_t ieee802154_transceiver_pcap_start(const ieee802154_transceiver_pcap_config_t *config) {
+    if (!config || !config->output || (config->block_size != 0 && config->block_size < MIN_BLOCK_SIZE)) {
+        ESP_LOGE(TAG, "Invalid capture configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pcap_task_handle) {
+        ESP_LOGE(TAG, "Already capturing");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    pcap_config = *config;
+    if (pcap_config.block_size == 0) {
+        pcap_config.block_size = DEFAULT_BLOCK_SIZE;
+    }
+    pcap_config.block_size &= ~(size_t)3; // Blocks stay 32-bit aligned
+    if (pcap_config.flush_ms == 0) {
+        pcap_config.flush_ms = DEFAULT_FLUSH_MS;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        pcap_blocks[i] = pcap_block_alloc(pcap_config.block_size);
+        if (!pcap_blocks[i]) {
+            ESP_LOGE(TAG, "Failed to allocate capture blocks");
+            pcap_blocks_free();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // Frame timestamps run on the transceiver clock; pcapng wants the epoch
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    pcap_epoch_offset_us = (int64_t)now.tv_sec * 1000000 + now.tv_usec - transceiver_now_us();
+
+    portENTER_CRITICAL(&pcap_lock);
+    pcap_active = 0;
+    pcap_fill[0] = pcapng_write_header(pcap_blocks[0]);
+    pcap_fill[1] = 0;
+    pcap_first_us = transceiver_now_us();
+    pcap_sending = false;
+    pcap_stop_requested = false;
+    memset(&pcap_stats, 0, sizeof(pcap_stats));
+    portEXIT_CRITICAL(&pcap_lock);
+
+    if (xTaskCreate(pcap_task, "PCAP", 1024 * 3, NULL, 4, &pcap_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create capture task");
+        pcap_task_handle = NULL;
+        pcap_blocks_free();
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&pcap_lock);
+    pcap_running = true;
+    portEXIT_CRITICAL(&pcap_lock);
+
+    ESP_LOGI(TAG, "Capture started (block=%u, flush=%lu ms)", (unsigned)pcap_config.block_size,
+             (unsigned long)pcap_config.flush_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop the capture stream after sending everything recorded so far.
+ */
+esp_err_t ieee802154_transceiver_pcap_stop(void) {
+    if (!pcap_task_handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // No more frames, then wait for the task to send what is left and exit
+    portENTER_CRITICAL(&pcap_lock);
+    pcap_running = false;
+    pcap_stop_requested = true;
+    pcap_stop_waiter = xTaskGetCurrentTaskHandle();
+    portEXIT_CRITICAL(&pcap_lock);
+    xTaskNotifyGive(pcap_task_handle);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    pcap_task_handle = NULL;
+
+    pcap_blocks_free();
+
+    ESP_LOGI(TAG, "Capture stopped");
+    return ESP_OK;
+}
+
+/**
+ * @brief Add a received frame to the capture stream.
+ */
+esp_err_t ieee802154_transceiver_pcap_record(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info) {
+    if (!frame || !frame_info || frame[0] < 2 || frame[0] > 127) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t now_us = transceiver_now_us();
+    uint64_t timestamp_us = (frame_info->timestamp ? (int64_t)frame_info->timestamp : now_us) + pcap_epoch_offset_us;
+    size_t len = pcapng_epb_len(frame);
+    bool wake = false;
+
+    portENTER_CRITICAL(&pcap_lock);
+    if (!pcap_running) {
+        portEXIT_CRITICAL(&pcap_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (pcap_fill[pcap_active] + len > pcap_config.block_size) {
+        if (pcap_sending) {
+            pcap_stats.dropped++;
+            portEXIT_CRITICAL(&pcap_lock);
+            return ESP_ERR_NO_MEM;
+        }
+        // Hand the full block over and carry on in the other one
+        pcap_active ^= 1;
+        pcap_fill[pcap_active] = 0;
+        pcap_sending = true;
+        wake = true;
+    }
+    if (pcap_fill[pcap_active] == 0) {
+        // Start the flush timer
+        pcap_first_us = now_us;
+        wake = true;
+    }
+    pcap_fill[pcap_active] += pcapng_write_epb(pcap_blocks[pcap_active] + pcap_fill[pcap_active], frame,
+                                               frame_info, timestamp_us);
+    pcap_stats.frames++;
+    if (wake) {
+        // Under the lock, so the task cannot be stopping meanwhile
+        xTaskNotifyGive(pcap_task_handle);
+    }
+    portEXIT_CRITICAL(&pcap_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the capture statistics.
+ */
+esp_err_t ieee802154_transceiver_pcap_get_stats(ieee802154_transceiver_pcap_stats_t *stats, bool reset) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&pcap_lock);
+    *stats = pcap_stats;
+    if (reset) {
+        memset(&pcap_stats, 0, sizeof(pcap_stats));
+    }
+    portEXIT_CRITICAL(&pcap_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Task to hand filled or overdue blocks to the output function.
+ */
+static void pcap_task(void *pvParameters) {
+    int64_t flush_us = (int64_t)pcap_config.flush_ms * 1000;
+    TickType_t wait_ticks = 0; // The headers are already waiting
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, wait_ticks);
+
+        portENTER_CRITICAL(&pcap_lock);
+        bool stopping = pcap_stop_requested;
+        int64_t waited_us = transceiver_now_us() - pcap_first_us;
+        if (!pcap_sending && pcap_fill[pcap_active] > 0 && (stopping || waited_us >= flush_us)) {
+            // The oldest frame is due: send the partial block
+            pcap_active ^= 1;
+            pcap_fill[pcap_active] = 0;
+            pcap_sending = true;
+        }
+        bool sending = pcap_sending;
+        uint8_t index = pcap_active ^ 1;
+        bool pending = pcap_fill[pcap_active] > 0;
+        portEXIT_CRITICAL(&pcap_lock);
+
+        if (sending) {
+            pcap_config.output(pcap_blocks[index], pcap_fill[index], pcap_config.ctx);
+
+            portENTER_CRITICAL(&pcap_lock);
+            pcap_stats.bytes += pcap_fill[index];
+            pcap_stats.blocks++;
+            pcap_sending = false;
+            portEXIT_CRITICAL(&pcap_lock);
+
+            // The other block may have filled up or come due meanwhile
+            wait_ticks = 0;
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+
+        // Sleep until a block is handed over, or the oldest recorded frame is due
+        if (pending) {
+            int64_t remaining_us = flush_us - waited_us;
+            wait_ticks = remaining_us > 0 ? pdMS_TO_TICKS((remaining_us + 999) / 1000) : 0;
+            if (wait_ticks == 0 && remaining_us > 0) {
+                wait_ticks = 1;
+            }
+        } else {
+            wait_ticks = portMAX_DELAY;
+        }
+    }
+
+    xTaskNotifyGive(pcap_stop_waiter);
+    vTaskDelete(NULL);
+}
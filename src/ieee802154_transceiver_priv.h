@@ -0,0 +1,152 @@
+#ifndef IEEE802154_TRANSCEIVER_PRIV_H
+#define IEEE802154_TRANSCEIVER_PRIV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_ieee802154.h"
+#include "sdkconfig.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#endif
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_trace.h"
+
+// Internal interfaces shared between the transceiver's source files
+
+/**
+ * @brief Monotonic time in microseconds, callable from the receive and transmit ISRs.
+ *
+ * esp_timer on the chip; the host clock on the Linux target, where esp_timer
+ * is not available.
+ */
+static inline int64_t transceiver_now_us(void) {
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+/**
+ * @brief Busy-wait for a few microseconds, for waits shorter than a FreeRTOS tick.
+ */
+static inline void transceiver_delay_us(uint32_t us) {
+#if CONFIG_IDF_TARGET_LINUX
+    int64_t end_us = transceiver_now_us() + us;
+    while (transceiver_now_us() < end_us) {
+    }
+#else
+    esp_rom_delay_us(us);
+#endif
+}
+
+/**
+ * @brief Ticks to sleep for a wait, or 0 if it is short enough to busy-wait.
+ *
+ * vTaskDelay(n) returns after n - 1 to n tick periods, so the wait is rounded up
+ * to whole ticks and one more is added: it is never cut short.
+ *
+ * @param wait_us Wait in microseconds.
+ * @param tick_us FreeRTOS tick period in microseconds.
+ * @param spin_max_us Longest wait to busy-wait.
+ * @return Ticks to sleep, or 0 to busy-wait wait_us.
+ */
+static inline uint32_t transceiver_wait_ticks(uint32_t wait_us, uint32_t tick_us, uint32_t spin_max_us) {
+    if (wait_us <= spin_max_us) {
+        return 0;
+    }
+    return (wait_us + tick_us - 1) / tick_us + 1;
+}
+
+/**
+ * @brief Hook invoked by the receive task for every frame, before the user callbacks.
+ *
+ * @param frame Raw frame (frame[0] is the PSDU length).
+ * @param header Header of the frame, decoded once by the receive task, or NULL if it has none readable.
+ * @param frame_info Frame information.
+ * @param rx_time_us transceiver_now_us() time at which the receive ISR took the frame.
+ * @param arg Argument given to transceiver_set_rx_hook().
+ */
+typedef void (*transceiver_rx_hook_t)(const uint8_t *frame, const ieee802154_transceiver_header_t *header,
+                                      const esp_ieee802154_frame_info_t *frame_info, int64_t rx_time_us, void *arg);
+
+// Receive hook owners, one slot each; hooks run in slot order
+typedef enum {
+    TRANSCEIVER_HOOK_CAPTURE,
+    TRANSCEIVER_HOOK_BRIDGE,
+    TRANSCEIVER_HOOK_NEIGHBOR,
+    TRANSCEIVER_HOOK_FRAG,
+    TRANSCEIVER_HOOK_MAX,
+} transceiver_hook_slot_t;
+
+/**
+ * @brief Install (or, with NULL, remove) the receive hook of a slot.
+ */
+void transceiver_set_rx_hook(transceiver_hook_slot_t slot, transceiver_rx_hook_t hook, void *arg);
+
+/**
+ * @brief Check a decoded frame against a filter entry.
+ *
+ * @param header Decoded header, or NULL for a frame without one (never matches).
+ */
+bool transceiver_filter_match(const ieee802154_transceiver_filter_t *filter,
+                              const ieee802154_transceiver_header_t *header,
+                              const esp_ieee802154_frame_info_t *frame_info);
+
+/**
+ * @brief Queue an already built frame on the transmit task.
+ *
+ * @param frame Frame to copy (frame[0] is the PSDU length).
+ * @param channel Channel to send on, or 0 for the receive channel.
+ */
+esp_err_t transceiver_transmit_frame_async(const uint8_t *frame, uint8_t channel,
+                                           ieee802154_transceiver_tx_done_callback_t done_cb, void *ctx);
+
+/**
+ * @brief Free entries in the transmit queue.
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if not initialized.
+ */
+esp_err_t transceiver_tx_queue_space(size_t *space);
+
+/**
+ * @brief Entries the transmit queue was created with (the tx_queue_depth given at init).
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if not initialized.
+ */
+esp_err_t transceiver_tx_queue_depth(size_t *depth);
+
+/**
+ * @brief Take the radio from the transmit task, to retune it for a while (channel survey).
+ *
+ * Waits for the frame in flight to complete; queued frames and channel changes
+ * wait until transceiver_radio_release().
+ *
+ * @return ESP_OK, ESP_ERR_TIMEOUT, or ESP_ERR_INVALID_STATE if not initialized.
+ */
+esp_err_t transceiver_radio_acquire(uint32_t wait_ms);
+
+/**
+ * @brief Give the radio back to the transmit task.
+ */
+void transceiver_radio_release(void);
+
+// Stage timing, compiled out unless CONFIG_IEEE802154_TRANSCEIVER_TRACE is set
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+void transceiver_trace_record(ieee802154_transceiver_trace_stage_t stage, int64_t elapsed_us);
+#define TRACE_NOW() transceiver_now_us()
+#define TRACE_RECORD(stage, start_us, end_us) transceiver_trace_record((stage), (end_us) - (start_us))
+#else
+#define TRACE_NOW() ((int64_t)0)
+#define TRACE_RECORD(stage, start_us, end_us) ((void)(start_us), (void)(end_us))
+#endif
+
+#endif // IEEE802154_TRANSCEIVER_PRIV_H
@@ -0,0 +1,213 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_ieee802154.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_scan.h"
+#include "ieee802154_transceiver_priv.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_SCAN"
+
+#define ALL_CHANNELS 0x07FFF800
+#define DEFAULT_SAMPLES 4
+#define DEFAULT_SAMPLE_SYMBOLS 8
+#define MAX_SAMPLES 32
+#define SYMBOL_US 16
+#define RADIO_WAIT_MS 200       // Frame in flight, or a channel change waiting on one
+#define DETECT_TIMEOUT_MS 10    // Allowed on top of the measurement itself
+
+// Task running the survey, notified by the energy detection ISR
+static TaskHandle_t volatile scan_waiter = NULL;
+static volatile int8_t scan_power;
+static portMUX_TYPE scan_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Internal: Take one energy measurement on the current channel
+static esp_err_t measure(uint16_t symbols, int8_t *power) {
+    ulTaskNotifyTake(pdTRUE, 0); // Drop a stale completion
+    esp_err_t ret = esp_ieee802154_energy_detect(symbols);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start energy detection: %d", ret);
+        return ret;
+    }
+
+    TickType_t timeout = pdMS_TO_TICKS((uint32_t)symbols * SYMBOL_US / 1000 + DETECT_TIMEOUT_MS);
+    if (ulTaskNotifyTake(pdTRUE, timeout) == 0) {
+        ESP_LOGE(TAG, "Energy detection did not complete");
+        return ESP_ERR_TIMEOUT;
+    }
+    *power = scan_power;
+    return ESP_OK;
+}
+
+// Internal: Measure one channel, then listen to it
+static esp_err_t survey_channel(uint8_t channel, uint8_t samples, uint16_t symbols, uint16_t listen_ms,
+                                ieee802154_transceiver_scan_channel_t *out) {
+    esp_err_t ret = esp_ieee802154_set_channel(channel);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set channel %d: %d", channel, ret);
+        return ret;
+    }
+
+    ieee802154_transceiver_channel_stats_t before, after;
+    ieee802154_transceiver_get_channel_stats(channel, &before);
+
+    int32_t sum = 0;
+    int8_t max = INT8_MIN;
+    for (uint8_t i = 0; i < samples; i++) {
+        int8_t power;
+        ret = measure(symbols, &power);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        sum += power;
+        max = power > max ? power : max;
+    }
+
+    if (listen_ms) {
+        ret = esp_ieee802154_receive();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start receiving: %d", ret);
+            return ret;
+        }
+        vTaskDelay(pdMS_TO_TICKS(listen_ms) ? pdMS_TO_TICKS(listen_ms) : 1);
+    }
+    ieee802154_transceiver_get_channel_stats(channel, &after);
+
+    // Mean rounded to the nearest dB
+    out->energy_max = max;
+    out->energy_mean = (int8_t)((sum >= 0 ? sum + samples / 2 : sum - samples / 2) / samples);
+    out->samples = samples;
+    out->frames = after.frames - before.frames;
+    return ESP_OK;
+}
+
+/**
+ * @brief Survey the energy on a set of channels.
+ */
+esp_err_t ieee802154_transceiver_scan_energy(const ieee802154_transceiver_scan_config_t *config,
+                                             ieee802154_transceiver_scan_result_t *result) {
+    ieee802154_transceiver_scan_config_t defaults = { 0 };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!result || (config->channel_mask & ~ALL_CHANNELS) != 0 || config->samples > MAX_SAMPLES) {
+        ESP_LOGE(TAG, "Invalid survey configuration");
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t mask = config->channel_mask ? config->channel_mask : ALL_CHANNELS;
+    uint8_t samples = config->samples ? config->samples : DEFAULT_SAMPLES;
+    uint16_t symbols = config->sample_symbols ? config->sample_symbols : DEFAULT_SAMPLE_SYMBOLS;
+
+    portENTER_CRITICAL(&scan_lock);
+    bool busy = scan_waiter != NULL;
+    if (!busy) {
+        scan_waiter = xTaskGetCurrentTaskHandle();
+    }
+    portEXIT_CRITICAL(&scan_lock);
+    if (busy) {
+        ESP_LOGE(TAG, "Survey already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = transceiver_radio_acquire(RADIO_WAIT_MS);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Radio not available: %d", ret);
+        scan_waiter = NULL;
+        return ret == ESP_ERR_TIMEOUT ? ret : ESP_ERR_INVALID_STATE;
+    }
+
+    memset(result, 0, sizeof(*result));
+    uint8_t previous_channel = esp_ieee802154_get_channel();
+    bool was_receiving = esp_ieee802154_get_state() == ESP_IEEE802154_RADIO_RECEIVE;
+    int64_t start_us = transceiver_now_us();
+
+    for (uint8_t channel = 11; channel <= 26 && ret == ESP_OK; channel++) {
+        if (!(mask & (1UL << channel))) {
+            continue;
+        }
+        ret = survey_channel(channel, samples, symbols, config->listen_ms, &result->channels[channel - 11]);
+        if (ret == ESP_OK) {
+            result->channel_mask |= 1UL << channel;
+        }
+    }
+
+    // Back to where the radio was
+    esp_err_t restore = esp_ieee802154_set_channel(previous_channel);
+    if (restore == ESP_OK) {
+        restore = was_receiving ? esp_ieee802154_receive() : esp_ieee802154_sleep();
+    }
+    if (restore != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restore channel %d: %d", previous_channel, restore);
+    }
+    result->duration_us = (uint32_t)(transceiver_now_us() - start_us);
+
+    transceiver_radio_release();
+    scan_waiter = NULL;
+    return ret != ESP_OK ? ret : restore;
+}
+
+// Internal: Whether channel a is a better pick than channel b
+static bool channel_better(const ieee802154_transceiver_scan_result_t *result, uint8_t a, uint8_t b) {
+    const ieee802154_transceiver_scan_channel_t *ca = &result->channels[a - 11];
+    const ieee802154_transceiver_scan_channel_t *cb = &result->channels[b - 11];
+    if (ca->energy_mean != cb->energy_mean) {
+        return ca->energy_mean < cb->energy_mean;
+    }
+    if (ca->energy_max != cb->energy_max) {
+        return ca->energy_max < cb->energy_max;
+    }
+    if (ca->frames != cb->frames) {
+        return ca->frames < cb->frames;
+    }
+    return a < b;
+}
+
+/**
+ * @brief Rank the surveyed channels, quietest first.
+ */
+esp_err_t ieee802154_transceiver_scan_rank(const ieee802154_transceiver_scan_result_t *result, uint8_t *channels,
+                                           size_t max, size_t *count) {
+    if (!result || !channels || !count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Insertion sort, 16 channels at most
+    uint8_t order[16];
+    size_t ranked = 0;
+    for (uint8_t channel = 11; channel <= 26; channel++) {
+        if (!(result->channel_mask & (1UL << channel))) {
+            continue;
+        }
+        size_t i = ranked++;
+        while (i > 0 && channel_better(result, channel, order[i - 1])) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = channel;
+    }
+
+    *count = ranked < max ? ranked : max;
+    memcpy(channels, order, *count);
+    return ESP_OK;
+}
+
+/**
+ * @brief Handle the callback for completed energy detections.
+ */
+void ieee802154_transceiver_handle_energy_detect_done(int8_t power) {
+    TaskHandle_t waiter = scan_waiter;
+    if (!waiter) {
+        return;
+    }
+
+    scan_power = power;
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(waiter, &higher_priority_task_woken);
+    if (higher_priority_task_woken) {
+        portYIELD_FROM_ISR(higher_priority_task_woken);
+    }
+}
@@ -0,0 +1,90 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+
+#include "ieee802154_transceiver_trace.h"
+#include "ieee802154_transceiver_priv.h"
+#include "trace_hist.h"
+
+#define TAG "IEEE802154_TRANSCEIVER_TRACE"
+
+static const char *const stage_names[IEEE802154_TRANSCEIVER_TRACE_STAGE_MAX] = {
+    [IEEE802154_TRANSCEIVER_TRACE_ISR] = "isr",
+    [IEEE802154_TRANSCEIVER_TRACE_QUEUE] = "queue",
+    [IEEE802154_TRANSCEIVER_TRACE_PARSE] = "parse",
+    [IEEE802154_TRANSCEIVER_TRACE_CALLBACK] = "callback",
+    [IEEE802154_TRANSCEIVER_TRACE_TX_QUEUE] = "tx_queue",
+    [IEEE802154_TRANSCEIVER_TRACE_TX_RADIO] = "tx_radio",
+    [IEEE802154_TRANSCEIVER_TRACE_RELAY] = "relay",
+};
+
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+
+// Histograms, written from the receive ISR and the transceiver tasks
+static ieee802154_transceiver_trace_hist_t trace_hists[IEEE802154_TRANSCEIVER_TRACE_STAGE_MAX];
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Internal: Add a sample to a stage, from a task or an ISR
+void transceiver_trace_record(ieee802154_transceiver_trace_stage_t stage, int64_t elapsed_us) {
+    uint32_t us = (elapsed_us < 0) ? 0 : (elapsed_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_us;
+
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    trace_hist_add(&trace_hists[stage], us);
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+/**
+ * @brief Copy the histogram of a stage.
+ */
+esp_err_t ieee802154_transceiver_trace_get(ieee802154_transceiver_trace_stage_t stage,
+                                           ieee802154_transceiver_trace_hist_t *hist) {
+    if (stage >= IEEE802154_TRANSCEIVER_TRACE_STAGE_MAX || !hist) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&trace_lock);
+    *hist = trace_hists[stage];
+    portEXIT_CRITICAL(&trace_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Clear every stage histogram.
+ */
+esp_err_t ieee802154_transceiver_trace_reset(void) {
+    portENTER_CRITICAL(&trace_lock);
+    memset(trace_hists, 0, sizeof(trace_hists));
+    portEXIT_CRITICAL(&trace_lock);
+    return ESP_OK;
+}
+
+#else // CONFIG_IEEE802154_TRANSCEIVER_TRACE
+
+esp_err_t ieee802154_transceiver_trace_get(ieee802154_transceiver_trace_stage_t stage,
+                                           ieee802154_transceiver_trace_hist_t *hist) {
+    ESP_LOGE(TAG, "Tracing disabled (CONFIG_IEEE802154_TRANSCEIVER_TRACE)");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t ieee802154_transceiver_trace_reset(void) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_IEEE802154_TRANSCEIVER_TRACE
+
+/**
+ * @brief Estimate a percentile from a histogram.
+ */
+uint32_t ieee802154_transceiver_trace_percentile(const ieee802154_transceiver_trace_hist_t *hist, float percent) {
+    return hist ? trace_hist_percentile(hist, percent) : 0;
+}
+
+/**
+ * @brief Name of a stage, for logs.
+ */
+const char *ieee802154_transceiver_trace_stage_name(ieee802154_transceiver_trace_stage_t stage) {
+    return (stage < IEEE802154_TRANSCEIVER_TRACE_STAGE_MAX) ? stage_names[stage] : "unknown";
+}
@@ -0,0 +1,254 @@
+#ifndef NEIGHBOR_TABLE_H
+#define NEIGHBOR_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_neighbor.h"
+
+/*
+ * Fixed-capacity table of link metrics per source address.
+ *
+ * Entries are found through an open-addressing hash: a power-of-two array of
+ * slots, at least twice the capacity, holding entry indexes, with linear
+ * probing and backward-shift deletion so no tombstones build up. The entries
+ * are also linked in least-recently-heard order; a frame moves its sender to
+ * the front, and when the table is full the entry at the back is evicted and
+ * reused. Lookups, updates and evictions are all constant time on average.
+ *
+ * RSSI and LQI averages are exponentially weighted, kept with 8 fractional
+ * bits. Sequence numbers are compared to the previous frame of the same
+ * sender: a gap of up to NEIGHBOR_TABLE_GAP_MAX counts the frames in between
+ * as lost, a repeated number counts as a retransmission, and a larger jump is
+ * taken as a restart.
+ */
+
+#define NEIGHBOR_TABLE_NONE 0xffff
+#define NEIGHBOR_TABLE_GAP_MAX 32
+
+typedef struct {
+    uint64_t addr;    // Address read as little-endian
+    uint16_t pan_id;  // 0xffff for an extended address
+    uint8_t addr_len; // 2 or 8
+} neighbor_key_t;
+
+typedef struct {
+    neighbor_key_t key;
+    int32_t rssi_q8; // Averages, 8 fractional bits
+    int32_t lqi_q8;
+    uint16_t prev;   // Toward the most recently heard, NEIGHBOR_TABLE_NONE at the front
+    uint16_t next;   // Toward the least recently heard, NEIGHBOR_TABLE_NONE at the back
+    uint8_t last_seq;
+    bool seq_valid;
+    ieee802154_transceiver_neighbor_t info;
+} neighbor_entry_t;
+
+typedef struct {
+    neighbor_entry_t *entries; // capacity entries, the first count in use
+    uint16_t *slots;           // Entry index + 1, 0 for an empty slot
+    uint32_t slot_mask;        // Slot count - 1
+    uint16_t capacity;
+    uint16_t count;
+    uint16_t head;             // Most recently heard
+    uint16_t tail;             // Least recently heard
+    uint8_t ewma_shift;
+} neighbor_table_t;
+
+/**
+ * @brief Hash slots needed for a capacity: a power of two, at least twice as many.
+ */
+static inline uint32_t neighbor_table_slot_count(uint16_t capacity) {
+    uint32_t count = 4;
+    while (count < 2 * (uint32_t)capacity) {
+        count <<= 1;
+    }
+    return count;
+}
+
+/**
+ * @brief Initialize an empty table over caller-provided entries and slots.
+ */
+static inline void neighbor_table_init(neighbor_table_t *table, neighbor_entry_t *entries, uint16_t capacity,
+                                       uint16_t *slots, uint8_t ewma_shift) {
+    table->entries = entries;
+    table->slots = slots;
+    table->slot_mask = neighbor_table_slot_count(capacity) - 1;
+    table->capacity = capacity;
+    table->count = 0;
+    table->head = NEIGHBOR_TABLE_NONE;
+    table->tail = NEIGHBOR_TABLE_NONE;
+    table->ewma_shift = ewma_shift;
+    memset(slots, 0, (table->slot_mask + 1) * sizeof(slots[0]));
+}
+
+/**
+ * @brief Build the key of an address; the PAN only counts for short addresses.
+ */
+static inline neighbor_key_t neighbor_table_key(const uint8_t *addr, uint8_t addr_len, uint16_t pan_id) {
+    neighbor_key_t key = { .addr = 0, .pan_id = addr_len == 2 ? pan_id : 0xffff, .addr_len = addr_len };
+    for (int i = addr_len - 1; i >= 0; i--) {
+        key.addr = (key.addr << 8) | addr[i];
+    }
+    return key;
+}
+
+static inline bool neighbor_key_equal(const neighbor_key_t *a, const neighbor_key_t *b) {
+    return a->addr == b->addr && a->pan_id == b->pan_id && a->addr_len == b->addr_len;
+}
+
+static inline uint32_t neighbor_table_home(const neighbor_table_t *table, const neighbor_key_t *key) {
+    uint64_t hash = key->addr * 0x9e3779b97f4a7c15ULL;
+    hash ^= ((uint64_t)key->pan_id << 8 | key->addr_len) * 0xc2b2ae3d27d4eb4fULL;
+    return (uint32_t)(hash >> 32) & table->slot_mask;
+}
+
+// Find the slot of a key, or the empty slot where it would go
+static inline bool neighbor_table_probe(const neighbor_table_t *table, const neighbor_key_t *key, uint32_t *pos) {
+    uint32_t i = neighbor_table_home(table, key);
+    while (table->slots[i]) {
+        if (neighbor_key_equal(&table->entries[table->slots[i] - 1].key, key)) {
+            *pos = i;
+            return true;
+        }
+        i = (i + 1) & table->slot_mask;
+    }
+    *pos = i;
+    return false;
+}
+
+// Empty a slot, moving later entries of the probe run back so that every entry stays reachable
+static inline void neighbor_table_remove_slot(neighbor_table_t *table, uint32_t pos) {
+    uint32_t hole = pos;
+    uint32_t i = pos;
+    table->slots[hole] = 0;
+    while (1) {
+        i = (i + 1) & table->slot_mask;
+        if (!table->slots[i]) {
+            return;
+        }
+        // An entry may fill the hole if its home is not cyclically within (hole, i]
+        uint32_t home = neighbor_table_home(table, &table->entries[table->slots[i] - 1].key);
+        if (((i - home) & table->slot_mask) >= ((i - hole) & table->slot_mask)) {
+            table->slots[hole] = table->slots[i];
+            table->slots[i] = 0;
+            hole = i;
+        }
+    }
+}
+
+static inline void neighbor_table_unlink(neighbor_table_t *table, uint16_t index) {
+    neighbor_entry_t *entry = &table->entries[index];
+    if (entry->prev != NEIGHBOR_TABLE_NONE) {
+        table->entries[entry->prev].next = entry->next;
+    } else {
+        table->head = entry->next;
+    }
+    if (entry->next != NEIGHBOR_TABLE_NONE) {
+        table->entries[entry->next].prev = entry->prev;
+    } else {
+        table->tail = entry->prev;
+    }
+}
+
+static inline void neighbor_table_push_front(neighbor_table_t *table, uint16_t index) {
+    neighbor_entry_t *entry = &table->entries[index];
+    entry->prev = NEIGHBOR_TABLE_NONE;
+    entry->next = table->head;
+    if (table->head != NEIGHBOR_TABLE_NONE) {
+        table->entries[table->head].prev = index;
+    } else {
+        table->tail = index;
+    }
+    table->head = index;
+}
+
+/**
+ * @brief Entry of a key, or NULL if not in the table.
+ */
+static inline const neighbor_entry_t *neighbor_table_get(const neighbor_table_t *table, const neighbor_key_t *key) {
+    uint32_t pos;
+    return neighbor_table_probe(table, key, &pos) ? &table->entries[table->slots[pos] - 1] : NULL;
+}
+
+/**
+ * @brief Account one received frame to its sender, adding or evicting entries as needed.
+ *
+ * @param has_seq The frame carries a sequence number from the sender's data sequence.
+ * @return true if the least recently heard neighbor was evicted to make room.
+ */
+static inline bool neighbor_table_update(neighbor_table_t *table, const neighbor_key_t *key, int8_t rssi,
+                                         uint8_t lqi, bool has_seq, uint8_t seq, int64_t time_us) {
+    bool evicted = false;
+    uint32_t pos;
+    uint16_t index;
+    neighbor_entry_t *entry;
+
+    if (neighbor_table_probe(table, key, &pos)) {
+        index = table->slots[pos] - 1;
+        entry = &table->entries[index];
+        neighbor_table_unlink(table, index);
+
+        int shift = table->ewma_shift;
+        entry->rssi_q8 += ((int32_t)rssi * 256 - entry->rssi_q8) >> shift;
+        entry->lqi_q8 += ((int32_t)lqi * 256 - entry->lqi_q8) >> shift;
+    } else {
+        if (table->count < table->capacity) {
+            index = table->count++;
+        } else {
+            // Reuse the least recently heard entry; its removal may move slots, so probe again
+            index = table->tail;
+            uint32_t old_pos;
+            neighbor_table_probe(table, &table->entries[index].key, &old_pos);
+            neighbor_table_remove_slot(table, old_pos);
+            neighbor_table_unlink(table, index);
+            neighbor_table_probe(table, key, &pos);
+            evicted = true;
+        }
+        table->slots[pos] = index + 1;
+
+        entry = &table->entries[index];
+        memset(entry, 0, sizeof(*entry));
+        entry->key = *key;
+        entry->rssi_q8 = (int32_t)rssi * 256;
+        entry->lqi_q8 = (int32_t)lqi * 256;
+        for (int i = 0; i < key->addr_len; i++) {
+            entry->info.addr[i] = (uint8_t)(key->addr >> (8 * i));
+        }
+        entry->info.addr_len = key->addr_len;
+        entry->info.pan_id = key->pan_id;
+    }
+    neighbor_table_push_front(table, index);
+
+    if (has_seq) {
+        if (entry->seq_valid) {
+            uint8_t gap = seq - entry->last_seq;
+            if (gap == 0) {
+                entry->info.repeated++;
+            } else if (gap <= NEIGHBOR_TABLE_GAP_MAX) {
+                entry->info.lost += gap - 1;
+            }
+        }
+        entry->last_seq = seq;
+        entry->seq_valid = true;
+    }
+
+    entry->info.rssi_avg = (int8_t)((entry->rssi_q8 + 128) >> 8);
+    entry->info.rssi_last = rssi;
+    entry->info.lqi_avg = (uint8_t)((entry->lqi_q8 + 128) >> 8);
+    entry->info.lqi_last = lqi;
+    entry->info.last_seen_us = time_us;
+    entry->info.frames++;
+    return evicted;
+}
+
+/**
+ * @brief Empty the table.
+ */
+static inline void neighbor_table_clear(neighbor_table_t *table) {
+    neighbor_table_init(table, table->entries, table->capacity, table->slots, table->ewma_shift);
+}
+
+#endif // NEIGHBOR_TABLE_H
@@ -0,0 +1,148 @@
+#ifndef PCAPNG_H
+#define PCAPNG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "esp_ieee802154.h"
+
+/*
+ * pcapng encoder for IEEE 802.15.4 captures, LINKTYPE_IEEE802_15_4_TAP.
+ *
+ * Blocks are written in host byte order, which the section header's byte-order
+ * magic tells readers about. Each packet carries a TAP header with FCS type,
+ * RSS, channel, LQI and start-of-frame timestamp TLVs ahead of the MAC frame.
+ * The FCS is not passed on: the radio does not hand it over intact.
+ */
+
+#define PCAPNG_BLOCK_SHB 0x0A0D0D0A
+#define PCAPNG_BLOCK_IDB 0x00000001
+#define PCAPNG_BLOCK_EPB 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+#define PCAPNG_LINKTYPE_IEEE802_15_4_TAP 283
+
+// TAP TLV types
+#define PCAPNG_TAP_FCS_TYPE 0
+#define PCAPNG_TAP_RSS 1
+#define PCAPNG_TAP_CHANNEL 3
+#define PCAPNG_TAP_SOF_TS 5
+#define PCAPNG_TAP_LQI 10
+
+#define PCAPNG_SHB_LEN 28
+#define PCAPNG_IDB_LEN 20
+#define PCAPNG_HEADER_LEN (PCAPNG_SHB_LEN + PCAPNG_IDB_LEN)
+#define PCAPNG_TAP_LEN 48 // 4-byte header and five TLVs
+#define PCAPNG_EPB_OVERHEAD 32
+
+// Largest packet block: TAP header plus a 125-byte MAC frame, padded
+#define PCAPNG_EPB_MAX_LEN (PCAPNG_EPB_OVERHEAD + PCAPNG_TAP_LEN + 128)
+
+static inline size_t pcapng_pad4(size_t len) {
+    return (len + 3) & ~(size_t)3;
+}
+
+static inline uint8_t *pcapng_put_u16(uint8_t *out, uint16_t value) {
+    memcpy(out, &value, sizeof(value));
+    return out + sizeof(value);
+}
+
+static inline uint8_t *pcapng_put_u32(uint8_t *out, uint32_t value) {
+    memcpy(out, &value, sizeof(value));
+    return out + sizeof(value);
+}
+
+static inline uint8_t *pcapng_put_tlv(uint8_t *out, uint16_t type, const void *value, uint16_t len) {
+    out = pcapng_put_u16(out, type);
+    out = pcapng_put_u16(out, len);
+    memcpy(out, value, len);
+    memset(out + len, 0, pcapng_pad4(len) - len);
+    return out + pcapng_pad4(len);
+}
+
+/**
+ * @brief Write the section header and interface description blocks.
+ *
+ * @return Bytes written, PCAPNG_HEADER_LEN.
+ */
+static inline size_t pcapng_write_header(uint8_t *out) {
+    uint8_t *p = out;
+
+    p = pcapng_put_u32(p, PCAPNG_BLOCK_SHB);
+    p = pcapng_put_u32(p, PCAPNG_SHB_LEN);
+    p = pcapng_put_u32(p, PCAPNG_BYTE_ORDER_MAGIC);
+    p = pcapng_put_u16(p, 1); // Version 1.0
+    p = pcapng_put_u16(p, 0);
+    p = pcapng_put_u32(p, 0xFFFFFFFF); // Section length not known
+    p = pcapng_put_u32(p, 0xFFFFFFFF);
+    p = pcapng_put_u32(p, PCAPNG_SHB_LEN);
+
+    // Timestamps in microseconds, the default resolution
+    p = pcapng_put_u32(p, PCAPNG_BLOCK_IDB);
+    p = pcapng_put_u32(p, PCAPNG_IDB_LEN);
+    p = pcapng_put_u16(p, PCAPNG_LINKTYPE_IEEE802_15_4_TAP);
+    p = pcapng_put_u16(p, 0);
+    p = pcapng_put_u32(p, 0); // No snapshot length limit
+    p = pcapng_put_u32(p, PCAPNG_IDB_LEN);
+
+    return p - out;
+}
+
+/**
+ * @brief Length of the packet block of a raw frame (frame[0] is the PSDU length).
+ */
+static inline size_t pcapng_epb_len(const uint8_t *frame) {
+    size_t mac_len = frame[0] >= 2 ? frame[0] - 2 : 0;
+    return PCAPNG_EPB_OVERHEAD + PCAPNG_TAP_LEN + pcapng_pad4(mac_len);
+}
+
+/**
+ * @brief Write the enhanced packet block of a raw frame.
+ *
+ * @param out Destination, at least pcapng_epb_len(frame) bytes.
+ * @param frame Raw frame (frame[0] is the PSDU length, including the FCS).
+ * @param frame_info Channel, RSSI and LQI.
+ * @param timestamp_us Capture time in microseconds since the epoch.
+ * @return Bytes written.
+ */
+static inline size_t pcapng_write_epb(uint8_t *out, const uint8_t *frame,
+                                      const esp_ieee802154_frame_info_t *frame_info, uint64_t timestamp_us) {
+    uint32_t mac_len = frame[0] >= 2 ? frame[0] - 2 : 0;
+    uint32_t packet_len = PCAPNG_TAP_LEN + mac_len;
+    uint32_t block_len = PCAPNG_EPB_OVERHEAD + PCAPNG_TAP_LEN + pcapng_pad4(mac_len);
+    uint8_t *p = out;
+
+    p = pcapng_put_u32(p, PCAPNG_BLOCK_EPB);
+    p = pcapng_put_u32(p, block_len);
+    p = pcapng_put_u32(p, 0); // Interface
+    p = pcapng_put_u32(p, (uint32_t)(timestamp_us >> 32));
+    p = pcapng_put_u32(p, (uint32_t)timestamp_us);
+    p = pcapng_put_u32(p, packet_len);
+    p = pcapng_put_u32(p, packet_len);
+
+    // TAP header
+    uint8_t fcs_type = 0; // No FCS
+    float rss = frame_info->rssi;
+    uint16_t channel_number = frame_info->channel;
+    uint8_t channel[3] = {0}; // Channel, then page 0
+    memcpy(channel, &channel_number, sizeof(channel_number));
+    uint64_t sof_ns = timestamp_us * 1000;
+    p = pcapng_put_u16(p, 0); // Version and reserved
+    p = pcapng_put_u16(p, PCAPNG_TAP_LEN);
+    p = pcapng_put_tlv(p, PCAPNG_TAP_FCS_TYPE, &fcs_type, sizeof(fcs_type));
+    p = pcapng_put_tlv(p, PCAPNG_TAP_RSS, &rss, sizeof(rss));
+    p = pcapng_put_tlv(p, PCAPNG_TAP_CHANNEL, channel, sizeof(channel));
+    p = pcapng_put_tlv(p, PCAPNG_TAP_LQI, &frame_info->lqi, sizeof(frame_info->lqi));
+    p = pcapng_put_tlv(p, PCAPNG_TAP_SOF_TS, &sof_ns, sizeof(sof_ns));
+
+    // MAC frame without the FCS
+    memcpy(p, &frame[1], mac_len);
+    memset(p + mac_len, 0, pcapng_pad4(mac_len) - mac_len);
+    p += pcapng_pad4(mac_len);
+
+    p = pcapng_put_u32(p, block_len);
+    return p - out;
+}
+
+#endif // PCAPNG_H
@@ -0,0 +1,217 @@
+#ifndef REASSEMBLY_H
+#define REASSEMBLY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * Bounded pool of datagrams being reassembled from fragments.
+ *
+ * Each slot owns a buffer as large as the pool's largest datagram and a bitmap
+ * with one bit per fragment, so fragments are accepted in any order and
+ * repeated ones are recognized. A datagram is identified by its sender and
+ * tag; every fragment carries the datagram size and fragment length, so
+ * whichever fragment arrives first claims a free slot and places itself at
+ * index * chunk. A slot whose last fragment is older than the timeout is freed
+ * by reassembly_expire(), which the caller runs before adding fragments.
+ */
+
+#define REASSEMBLY_MIN_CHUNK 8 // Shortest fragment, but the last; bounds the bitmap
+
+typedef struct {
+    uint64_t addr;    // Sender address read as little-endian
+    uint16_t pan_id;  // Sender PAN for a short address, 0xffff for an extended one
+    uint8_t addr_len; // 2 or 8
+    uint16_t tag;     // Datagram tag of the sender
+} reassembly_key_t;
+
+// Fragment header fields
+typedef struct {
+    uint16_t tag;
+    uint16_t size;  // Datagram bytes
+    uint16_t index; // Fragment number, from 0
+    uint8_t chunk;  // Bytes in every fragment but the last
+} reassembly_fragment_t;
+
+typedef struct {
+    bool used;
+    reassembly_key_t key;
+    uint16_t size;      // Datagram bytes
+    uint16_t fragments; // Fragments in the datagram
+    uint16_t received;  // Distinct fragments stored
+    uint8_t chunk;
+    int64_t first_us;   // Arrival of the first fragment
+    int64_t last_us;    // Arrival of the latest fragment
+    uint8_t *data;      // max_size bytes
+    uint32_t *bitmap;   // One bit per fragment, set once stored
+} reassembly_slot_t;
+
+typedef struct {
+    reassembly_slot_t *slots;
+    uint16_t slot_count;
+    uint16_t max_size;
+    uint32_t bitmap_words; // Per slot
+    int64_t timeout_us;
+} reassembly_pool_t;
+
+typedef enum {
+    REASSEMBLY_ADDED,     // Stored, more fragments needed
+    REASSEMBLY_COMPLETE,  // Stored, and the datagram is whole in the slot
+    REASSEMBLY_DUPLICATE, // Already stored
+    REASSEMBLY_INVALID,   // Inconsistent with the header or with earlier fragments
+    REASSEMBLY_TOO_LARGE, // Datagram larger than the pool's buffers
+    REASSEMBLY_NO_SLOT,   // Every slot holds an unexpired datagram
+} reassembly_status_t;
+
+static inline uint32_t reassembly_bitmap_words(uint16_t max_size) {
+    uint32_t fragments = ((uint32_t)max_size + REASSEMBLY_MIN_CHUNK - 1) / REASSEMBLY_MIN_CHUNK;
+    return (fragments + 31) / 32;
+}
+
+/**
+ * @brief Bytes of storage a pool needs: slots, bitmaps and buffers.
+ */
+static inline size_t reassembly_storage_size(uint16_t slot_count, uint16_t max_size) {
+    size_t data_len = ((size_t)max_size + 3) & ~(size_t)3;
+    return slot_count * (sizeof(reassembly_slot_t) + reassembly_bitmap_words(max_size) * sizeof(uint32_t) + data_len);
+}
+
+/**
+ * @brief Initialize an empty pool over reassembly_storage_size() bytes of 8-byte aligned storage.
+ */
+static inline void reassembly_init(reassembly_pool_t *pool, void *storage, uint16_t slot_count, uint16_t max_size,
+                                   int64_t timeout_us) {
+    size_t data_len = ((size_t)max_size + 3) & ~(size_t)3;
+    pool->slots = storage;
+    pool->slot_count = slot_count;
+    pool->max_size = max_size;
+    pool->bitmap_words = reassembly_bitmap_words(max_size);
+    pool->timeout_us = timeout_us;
+
+    uint32_t *bitmaps = (uint32_t *)&pool->slots[slot_count];
+    uint8_t *data = (uint8_t *)&bitmaps[slot_count * pool->bitmap_words];
+    for (uint16_t i = 0; i < slot_count; i++) {
+        reassembly_slot_t *slot = &pool->slots[i];
+        memset(slot, 0, sizeof(*slot));
+        slot->bitmap = &bitmaps[i * pool->bitmap_words];
+        slot->data = &data[i * data_len];
+    }
+}
+
+/**
+ * @brief Build the key of a datagram; the PAN only counts for short addresses.
+ */
+static inline reassembly_key_t reassembly_key(const uint8_t *addr, uint8_t addr_len, uint16_t pan_id, uint16_t tag) {
+    reassembly_key_t key = { .addr = 0, .pan_id = addr_len == 2 ? pan_id : 0xffff, .addr_len = addr_len, .tag = tag };
+    for (int i = addr_len - 1; i >= 0; i--) {
+        key.addr = (key.addr << 8) | addr[i];
+    }
+    return key;
+}
+
+static inline bool reassembly_key_equal(const reassembly_key_t *a, const reassembly_key_t *b) {
+    return a->addr == b->addr && a->pan_id == b->pan_id && a->addr_len == b->addr_len && a->tag == b->tag;
+}
+
+/**
+ * @brief Fragments of a datagram of size bytes cut into chunk-byte pieces.
+ */
+static inline uint32_t reassembly_fragment_count(uint32_t size, uint8_t chunk) {
+    return (size + chunk - 1) / chunk;
+}
+
+/**
+ * @brief Free the slot of a delivered or abandoned datagram.
+ */
+static inline void reassembly_release(reassembly_pool_t *pool, reassembly_slot_t *slot) {
+    (void)pool;
+    slot->used = false;
+}
+
+/**
+ * @brief Free the slots whose latest fragment is older than the timeout.
+ *
+ * @return Slots freed.
+ */
+static inline uint32_t reassembly_expire(reassembly_pool_t *pool, int64_t now_us) {
+    uint32_t expired = 0;
+    for (uint16_t i = 0; i < pool->slot_count; i++) {
+        reassembly_slot_t *slot = &pool->slots[i];
+        if (slot->used && now_us - slot->last_us > pool->timeout_us) {
+            reassembly_release(pool, slot);
+            expired++;
+        }
+    }
+    return expired;
+}
+
+/**
+ * @brief Store a fragment of a datagram.
+ *
+ * @param slot Slot of the datagram out, for REASSEMBLY_COMPLETE; release it once delivered.
+ */
+static inline reassembly_status_t reassembly_add(reassembly_pool_t *pool, const reassembly_key_t *key,
+                                                 const reassembly_fragment_t *fragment, const uint8_t *data,
+                                                 size_t len, int64_t now_us, reassembly_slot_t **slot_out) {
+    // Every fragment describes the whole datagram, check it on its own first
+    if (fragment->size == 0 || fragment->chunk < REASSEMBLY_MIN_CHUNK) {
+        return REASSEMBLY_INVALID;
+    }
+    if (fragment->size > pool->max_size) {
+        return REASSEMBLY_TOO_LARGE;
+    }
+    uint32_t fragments = reassembly_fragment_count(fragment->size, fragment->chunk);
+    uint32_t offset = (uint32_t)fragment->index * fragment->chunk;
+    if (fragment->index >= fragments ||
+        len != (fragment->index == fragments - 1 ? fragment->size - offset : fragment->chunk)) {
+        return REASSEMBLY_INVALID;
+    }
+
+    reassembly_slot_t *slot = NULL;
+    reassembly_slot_t *free_slot = NULL;
+    for (uint16_t i = 0; i < pool->slot_count && !slot; i++) {
+        reassembly_slot_t *candidate = &pool->slots[i];
+        if (!candidate->used) {
+            free_slot = free_slot ? free_slot : candidate;
+        } else if (reassembly_key_equal(&candidate->key, key)) {
+            slot = candidate;
+        }
+    }
+
+    if (slot) {
+        if (slot->size != fragment->size || slot->chunk != fragment->chunk) {
+            return REASSEMBLY_INVALID;
+        }
+        if (slot->bitmap[fragment->index / 32] & (1u << (fragment->index % 32))) {
+            slot->last_us = now_us;
+            return REASSEMBLY_DUPLICATE;
+        }
+    } else {
+        if (!free_slot) {
+            return REASSEMBLY_NO_SLOT;
+        }
+        slot = free_slot;
+        slot->used = true;
+        slot->key = *key;
+        slot->size = fragment->size;
+        slot->chunk = fragment->chunk;
+        slot->fragments = (uint16_t)fragments;
+        slot->received = 0;
+        slot->first_us = now_us;
+        memset(slot->bitmap, 0, pool->bitmap_words * sizeof(uint32_t));
+    }
+
+    memcpy(&slot->data[offset], data, len);
+    slot->bitmap[fragment->index / 32] |= 1u << (fragment->index % 32);
+    slot->received++;
+    slot->last_us = now_us;
+    if (slot->received < slot->fragments) {
+        return REASSEMBLY_ADDED;
+    }
+    *slot_out = slot;
+    return REASSEMBLY_COMPLETE;
+}
+
+#endif // REASSEMBLY_H
@@ -0,0 +1,157 @@
+#ifndef SUBSCRIBER_INDEX_H
+#define SUBSCRIBER_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "ieee802154_transceiver.h"
+
+/*
+ * Lookup index over the filters of up to 32 receive subscribers.
+ *
+ * Subscribers are bits of a 32-bit mask. For each indexed field (frame type,
+ * destination PAN, destination short and extended address, command ID) the
+ * index holds the mask of subscribers that do not constrain the field, plus a
+ * sorted key table giving the mask of subscribers that require each value.
+ * A frame's candidates are the AND of one mask per field: a direct array read
+ * for the frame type and a binary search for the others, so the cost grows
+ * with the log of the distinct values rather than with the subscribers.
+ *
+ * The index only narrows the set: candidates still have to be checked against
+ * the fields it does not cover (source PAN and address, RSSI, LQI).
+ */
+
+typedef struct {
+    uint64_t key;
+    uint32_t mask; // Subscribers requiring this value
+} subscriber_key_t;
+
+typedef struct {
+    subscriber_key_t keys[32]; // Sorted by key, distinct
+    uint32_t count;
+    uint32_t any;              // Subscribers not constraining the field
+} subscriber_field_t;
+
+typedef struct {
+    uint32_t by_type[8];        // Subscribers accepting each frame type
+    subscriber_field_t dest_pan;
+    subscriber_field_t dest_short;
+    subscriber_field_t dest_ext; // Shares "any" with dest_short
+    subscriber_field_t command;
+} subscriber_index_t;
+
+static inline uint64_t subscriber_addr_key(const uint8_t *addr, uint8_t len) {
+    uint64_t key = 0;
+    for (int i = len - 1; i >= 0; i--) {
+        key = (key << 8) | addr[i];
+    }
+    return key;
+}
+
+// Add a subscriber requiring key, keeping the table sorted
+static inline void subscriber_field_add(subscriber_field_t *field, uint64_t key, uint32_t bit) {
+    uint32_t pos = 0;
+    while (pos < field->count && field->keys[pos].key < key) {
+        pos++;
+    }
+    if (pos < field->count && field->keys[pos].key == key) {
+        field->keys[pos].mask |= bit;
+        return;
+    }
+    memmove(&field->keys[pos + 1], &field->keys[pos], (field->count - pos) * sizeof(field->keys[0]));
+    field->keys[pos].key = key;
+    field->keys[pos].mask = bit;
+    field->count++;
+}
+
+// Subscribers accepting key: those requiring it and those not constraining the field
+static inline uint32_t subscriber_field_lookup(const subscriber_field_t *field, uint64_t key) {
+    uint32_t lo = 0, hi = field->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (field->keys[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return field->any | ((lo < field->count && field->keys[lo].key == key) ? field->keys[lo].mask : 0);
+}
+
+/**
+ * @brief Rebuild the index from the filters of the active subscribers.
+ *
+ * @param filters Filter of each subscriber, indexed by bit number.
+ * @param active Mask of the subscribers in use.
+ */
+static inline void subscriber_index_build(subscriber_index_t *index, const ieee802154_transceiver_filter_t *filters,
+                                          uint32_t active) {
+    memset(index, 0, sizeof(*index));
+
+    for (uint32_t i = 0; i < 32; i++) {
+        uint32_t bit = (uint32_t)1 << i;
+        if (!(active & bit)) {
+            continue;
+        }
+        const ieee802154_transceiver_filter_t *filter = &filters[i];
+
+        for (int type = 0; type < 8; type++) {
+            if (!(filter->match & IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE) || (filter->frame_types & (1 << type))) {
+                index->by_type[type] |= bit;
+            }
+        }
+        if (filter->match & IEEE802154_TRANSCEIVER_FILTER_DEST_PAN) {
+            subscriber_field_add(&index->dest_pan, filter->dest_pan_id, bit);
+        } else {
+            index->dest_pan.any |= bit;
+        }
+        if (!(filter->match & IEEE802154_TRANSCEIVER_FILTER_DEST_ADDR)) {
+            index->dest_short.any |= bit;
+            index->dest_ext.any |= bit;
+        } else if (filter->dest_addr_len == 2) {
+            subscriber_field_add(&index->dest_short, subscriber_addr_key(filter->dest_addr, 2), bit);
+        } else {
+            subscriber_field_add(&index->dest_ext, subscriber_addr_key(filter->dest_addr, 8), bit);
+        }
+        if (filter->match & IEEE802154_TRANSCEIVER_FILTER_COMMAND_ID) {
+            subscriber_field_add(&index->command, filter->command_id, bit);
+        } else {
+            index->command.any |= bit;
+        }
+    }
+}
+
+/**
+ * @brief Subscribers whose filters may match a decoded frame.
+ *
+ * Exact for the frame type, destination PAN, destination address and command
+ * ID; the other fields of the candidates' filters are not looked at.
+ */
+static inline uint32_t subscriber_index_lookup(const subscriber_index_t *index,
+                                               const ieee802154_transceiver_header_t *header) {
+    uint16_t pan_id;
+    uint8_t command_id;
+
+    uint32_t mask = index->by_type[ieee802154_transceiver_header_frame_type(header)];
+    if (!mask) {
+        return 0;
+    }
+    mask &= ieee802154_transceiver_header_dest_pan(header, &pan_id) ?
+            subscriber_field_lookup(&index->dest_pan, pan_id) : index->dest_pan.any;
+
+    const uint8_t *dest_addr = ieee802154_transceiver_header_dest_addr(header);
+    if (!dest_addr) {
+        mask &= index->dest_short.any;
+    } else if (header->dest_addr_len == 2) {
+        mask &= subscriber_field_lookup(&index->dest_short, subscriber_addr_key(dest_addr, 2));
+    } else {
+        mask &= subscriber_field_lookup(&index->dest_ext, subscriber_addr_key(dest_addr, 8));
+    }
+
+    mask &= ieee802154_transceiver_header_command_id(header, &command_id) ?
+            subscriber_field_lookup(&index->command, command_id) : index->command.any;
+    return mask;
+}
+
+#endif // SUBSCRIBER_INDEX_H
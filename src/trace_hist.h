@@ -0,0 +1,62 @@
+#ifndef TRACE_HIST_H
+#define TRACE_HIST_H
+
+#include <stdint.h>
+
+#include "ieee802154_transceiver_trace.h"
+
+/*
+ * Fixed log2-bucket latency histogram. Adding a sample is a count-leading-zeros
+ * and a few increments, cheap enough for the receive ISR.
+ */
+
+/**
+ * @brief Bucket of a sample in microseconds.
+ */
+static inline uint32_t trace_hist_bucket(uint32_t us) {
+    uint32_t bucket = us ? 32 - __builtin_clz(us) : 0;
+    return bucket < IEEE802154_TRANSCEIVER_TRACE_BUCKETS ? bucket : IEEE802154_TRANSCEIVER_TRACE_BUCKETS - 1;
+}
+
+/**
+ * @brief Add a sample in microseconds.
+ */
+static inline void trace_hist_add(ieee802154_transceiver_trace_hist_t *hist, uint32_t us) {
+    hist->count++;
+    hist->sum_us += us;
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+    hist->buckets[trace_hist_bucket(us)]++;
+}
+
+/**
+ * @brief Upper bound of the bucket holding a percentile, capped at the largest sample.
+ */
+static inline uint32_t trace_hist_percentile(const ieee802154_transceiver_trace_hist_t *hist, float percent) {
+    if (hist->count == 0) {
+        return 0;
+    }
+    if (percent > 100.0f) {
+        percent = 100.0f;
+    }
+
+    // Rank of the sample, rounded up so that p100 is the last one
+    double exact = (double)hist->count * percent / 100.0;
+    uint64_t rank = (uint64_t)exact;
+    if (rank < exact || rank == 0) {
+        rank++;
+    }
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < IEEE802154_TRANSCEIVER_TRACE_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = (i == 0) ? 0 : (uint32_t)((1ULL << i) - 1);
+            return (i == IEEE802154_TRANSCEIVER_TRACE_BUCKETS - 1 || upper > hist->max_us) ? hist->max_us : upper;
+        }
+    }
+    return hist->max_us;
+}
+
+#endif // TRACE_HIST_H
@@ -1,67 +1,886 @@
-#include <stdio.h>
-#include "unity.h"
-
-#include "ieee802154_transceiver.h"
-
-#include "nvs_flash.h"
-
-#define TEST_CHANNEL 11
-
-void setUp(void) {
-
-    // Initialize NVS flash
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        nvs_flash_erase();
-        nvs_flash_init();
-    }
-
-}
-
-void tearDown(void) {
-    // Do nothing
-}
-
-TEST_CASE("IEEE 802.15.4 Transceiver Initialization", "[valid]") {
-    // Initialize transceiver
-    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-
-    // Deinitialize transceiver
-    ret = ieee802154_transceiver_deinit();
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-}
-
-TEST_CASE("IEEE 802.15.4 Transceiver Invalid Channel", "[invalid]") {
-    // Attempt to initialize with invalid channel
-    esp_err_t ret = ieee802154_transceiver_init(10); // Invalid channel
-    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
-}
-
-TEST_CASE("IEEE 802.15.4 Transceiver Set Channel", "[valid]") {
-    // Initialize transceiver
-    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-
-    // Set new channel
-    ret = ieee802154_transceiver_set_channel(12);
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-
-    // Deinitialize transceiver
-    ret = ieee802154_transceiver_deinit();
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-}
-
-TEST_CASE("IEEE 802.15.4 Transceiver Set RX Callback", "[valid]") {
-    // Initialize transceiver
-    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-
-    // Set RX callback
-    ret = ieee802154_transceiver_set_rx_callback(NULL, NULL);
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-
-    // Deinitialize transceiver
-    ret = ieee802154_transceiver_deinit();
-    TEST_ASSERT_EQUAL(ESP_OK, ret);
-}
+#include <stdio.h>
+#include "unity.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ieee802154_transceiver.h"
+#include "ieee802154_transceiver_hop.h"
+#include "ieee802154_transceiver_bridge.h"
+#include "ieee802154_transceiver_trace.h"
+#include "ieee802154_transceiver_pcap.h"
+#include "ieee802154_transceiver_capture.h"
+#include "ieee802154_transceiver_neighbor.h"
+#include "ieee802154_transceiver_scan.h"
+#include "ieee802154_transceiver_frag.h"
+
+#include "nvs_flash.h"
+
+#define TEST_CHANNEL 11
+
+void setUp(void) {
+
+    // Initialize NVS flash
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        nvs_flash_init();
+    }
+
+}
+
+void tearDown(void) {
+    // Do nothing
+}
+
+// Energy measurements are reported by the radio driver through this callback
+void esp_ieee802154_energy_detect_done(int8_t power) {
+    ieee802154_transceiver_handle_energy_detect_done(power);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Initialization", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Invalid Channel", "[invalid]") {
+    // Attempt to initialize with invalid channel
+    esp_err_t ret = ieee802154_transceiver_init(10); // Invalid channel
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Initialization With Config", "[valid]") {
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(TEST_CHANNEL);
+
+    // Reject bad task settings
+    config.rx_task.priority = configMAX_PRIORITIES;
+    esp_err_t ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    config.rx_task.priority = 5;
+    config.tx_task.core_id = portNUM_PROCESSORS;
+    ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    config.tx_task.core_id = IEEE802154_TRANSCEIVER_NO_AFFINITY;
+    ret = ieee802154_transceiver_init_with_config(NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Pipelined, with the receive task pinned to the first core
+    config.pipelined = true;
+    config.rx_task.core_id = 0;
+    config.rx_task.priority = 6;
+    ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_set_rx_callback(NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Static Storage", "[valid]") {
+    static uint64_t buffer[4096];
+    ieee802154_transceiver_storage_t storage = { .buffer = buffer, .size = sizeof(buffer) };
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(TEST_CHANNEL);
+    config.tx_queue_depth = 4;
+    config.tx_power = 10;
+    config.storage = &storage;
+
+    // Queue depths out of range
+    size_t size;
+    config.rx_queue_depth = 257;
+    esp_err_t ret = ieee802154_transceiver_get_storage_size(&config, &size);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    config.rx_queue_depth = 8;
+    ret = ieee802154_transceiver_get_storage_size(&config, &size);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_TRUE(size <= sizeof(buffer));
+
+    // Too small
+    storage.size = size - 1;
+    ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, ret);
+
+    storage.size = size;
+    ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(10, esp_ieee802154_get_txpower());
+
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Address Filtering", "[valid]") {
+    ieee802154_transceiver_address_t address = {
+        .pan_id = 0x1234,
+        .short_addr = 0x0001,
+        .ext_addr = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 },
+        .pending_mode = ESP_IEEE802154_AUTO_PENDING_ENABLE,
+    };
+    const uint8_t child[2] = { 0x02, 0x00 };
+
+    // Not available before initialization
+    esp_err_t ret = ieee802154_transceiver_set_address(&address);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(TEST_CHANNEL);
+    config.promiscuous = false;
+    config.coordinator = true;
+    config.address = &address;
+    ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_FALSE(esp_ieee802154_get_promiscuous());
+    TEST_ASSERT_EQUAL_HEX16(0x1234, esp_ieee802154_get_panid());
+    TEST_ASSERT_EQUAL_HEX16(0x0001, esp_ieee802154_get_short_address());
+    TEST_ASSERT_EQUAL(ESP_IEEE802154_AUTO_PENDING_ENABLE, esp_ieee802154_get_pending_mode());
+
+    // Change the short address, as after an association
+    address.short_addr = 0x0003;
+    ret = ieee802154_transceiver_set_address(&address);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL_HEX16(0x0003, esp_ieee802154_get_short_address());
+    ret = ieee802154_transceiver_set_address(NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Pending marks
+    ret = ieee802154_transceiver_set_pending(child, 2, true);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_set_pending(child, 2, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_set_pending(child, 3, true);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_clear_pending();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Set Channel", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Set new channel
+    ret = ieee802154_transceiver_set_channel(12);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Set RX Callback", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Set RX callback
+    ret = ieee802154_transceiver_set_rx_callback(NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+static void test_rx_batch_callback(ieee802154_frame_t *frames, esp_ieee802154_frame_info_t *frame_infos,
+                                   size_t count, void *user_data) {
+    // Do nothing
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Set RX Batch Callback", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Batch size must be between 1 and the configured maximum
+    ret = ieee802154_transceiver_set_rx_batch_callback(test_rx_batch_callback, 0, 10, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_set_rx_batch_callback(test_rx_batch_callback, CONFIG_IEEE802154_TRANSCEIVER_RX_BATCH_MAX + 1, 10, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Set and clear RX batch callback
+    ret = ieee802154_transceiver_set_rx_batch_callback(test_rx_batch_callback, CONFIG_IEEE802154_TRANSCEIVER_RX_BATCH_MAX, 10, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_set_rx_batch_callback(NULL, 0, 0, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Header Decode", "[valid]") {
+    ieee802154_transceiver_header_t header;
+    uint8_t seq;
+    uint16_t pan_id;
+
+    // 2006 data frame, PAN ID compression, short addresses: 1234 / ffff <- abcd
+    const uint8_t data_frame[] = {
+        13,                     // PSDU length
+        0x41, 0x98,             // FCF
+        0x2a,                   // Sequence number
+        0x34, 0x12,             // Destination PAN ID
+        0xff, 0xff,             // Destination address
+        0xcd, 0xab,             // Source address
+        0x01, 0x02,             // Payload
+        0x00, 0x00,             // FCS
+    };
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_decode(data_frame, &header));
+    TEST_ASSERT_EQUAL(IEEE802154_FRAME_TYPE_DATA, ieee802154_transceiver_header_frame_type(&header));
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_seq(&header, &seq));
+    TEST_ASSERT_EQUAL_HEX8(0x2a, seq);
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_dest_pan(&header, &pan_id));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, pan_id);
+    TEST_ASSERT_FALSE(ieee802154_transceiver_header_src_pan(&header, &pan_id));
+    TEST_ASSERT_EQUAL(2, header.src_addr_len);
+    TEST_ASSERT_EQUAL_HEX8(0xcd, ieee802154_transceiver_header_src_addr(&header)[0]);
+    TEST_ASSERT_EQUAL(10, header.payload_offset);
+
+    // Immediate ACK: no addressing fields
+    const uint8_t ack_frame[] = { 5, 0x02, 0x00, 0x2a, 0x00, 0x00 };
+    TEST_ASSERT_TRUE(ieee802154_transceiver_header_decode(ack_frame, &header));
+    TEST_ASSERT_EQUAL(IEEE802154_FRAME_TYPE_ACK, ieee802154_transceiver_header_frame_type(&header));
+    TEST_ASSERT_NULL(ieee802154_transceiver_header_dest_addr(&header));
+    TEST_ASSERT_NULL(ieee802154_transceiver_header_src_addr(&header));
+
+    // Truncated: header claims extended addresses that do not fit
+    const uint8_t short_frame[] = { 6, 0x41, 0xcc, 0x01, 0x34, 0x12, 0x00 };
+    TEST_ASSERT_FALSE(ieee802154_transceiver_header_decode(short_frame, &header));
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Header Rewrite", "[valid]") {
+    // 2006 data frame, PAN ID compression, short addresses: 1234 / ffff <- abcd
+    uint8_t frame[] = {
+        13, 0x41, 0x98, 0x2a, 0x34, 0x12, 0xff, 0xff, 0xcd, 0xab, 0x01, 0x02, 0x00, 0x00,
+    };
+    const uint8_t expected[] = {
+        13, 0x41, 0x98, 0x07, 0x21, 0x43, 0xff, 0xff, 0xcd, 0xab, 0x01, 0x02, 0x00, 0x00,
+    };
+
+    // The compressed source PAN ID is absent and left alone
+    ieee802154_transceiver_rewrite_t rewrite = {
+        .fields = IEEE802154_TRANSCEIVER_REWRITE_SEQ | IEEE802154_TRANSCEIVER_REWRITE_DEST_PAN |
+                  IEEE802154_TRANSCEIVER_REWRITE_SRC_PAN,
+        .seq = 0x07,
+        .dest_pan_id = 0x4321,
+        .src_pan_id = 0x5555,
+    };
+    esp_err_t ret = ieee802154_transceiver_rewrite(frame, &rewrite);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, sizeof(expected));
+
+    // Truncated frames are rejected
+    uint8_t short_frame[] = { 6, 0x41, 0xcc, 0x01, 0x34, 0x12, 0x00 };
+    ret = ieee802154_transceiver_rewrite(short_frame, &rewrite);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Filter Table", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Address length must be short or extended
+    ieee802154_transceiver_filter_t filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_SRC_ADDR,
+        .src_addr_len = 3,
+    };
+    ret = ieee802154_transceiver_add_filter(&filter);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Fill the table with data frames on PAN 0x1234
+    filter = (ieee802154_transceiver_filter_t) {
+        .match = IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE | IEEE802154_TRANSCEIVER_FILTER_DEST_PAN,
+        .frame_types = 1 << IEEE802154_FRAME_TYPE_DATA,
+        .dest_pan_id = 0x1234,
+    };
+    for (int i = 0; i < CONFIG_IEEE802154_TRANSCEIVER_FILTER_MAX; i++) {
+        ret = ieee802154_transceiver_add_filter(&filter);
+        TEST_ASSERT_EQUAL(ESP_OK, ret);
+    }
+    ret = ieee802154_transceiver_add_filter(&filter);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, ret);
+
+    // Clearing makes room again
+    ret = ieee802154_transceiver_clear_filters();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_add_filter(&filter);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ieee802154_transceiver_clear_filters();
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+static void test_subscriber_callback(const uint8_t *frame, const esp_ieee802154_frame_info_t *frame_info,
+                                     void *user_data) {
+    // Do nothing
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Subscribers", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // A callback is required and filters are checked like table entries
+    ret = ieee802154_transceiver_subscribe(NULL, NULL, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ieee802154_transceiver_filter_t filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_DEST_ADDR,
+        .dest_addr_len = 4,
+    };
+    ret = ieee802154_transceiver_subscribe(&filter, test_subscriber_callback, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Fill the subscriber table with MAC command subscribers
+    filter = (ieee802154_transceiver_filter_t) {
+        .match = IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE | IEEE802154_TRANSCEIVER_FILTER_COMMAND_ID,
+        .frame_types = 1 << IEEE802154_FRAME_TYPE_MAC_COMMAND,
+    };
+    int ids[CONFIG_IEEE802154_TRANSCEIVER_SUBSCRIBER_MAX];
+    for (int i = 0; i < CONFIG_IEEE802154_TRANSCEIVER_SUBSCRIBER_MAX; i++) {
+        filter.command_id = i + 1;
+        ret = ieee802154_transceiver_subscribe(&filter, test_subscriber_callback, NULL, &ids[i]);
+        TEST_ASSERT_EQUAL(ESP_OK, ret);
+    }
+    ret = ieee802154_transceiver_subscribe(NULL, test_subscriber_callback, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, ret);
+
+    // Unsubscribing makes room again, and identifiers are only valid once
+    ret = ieee802154_transceiver_unsubscribe(ids[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_unsubscribe(ids[0]);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, ret);
+    ret = ieee802154_transceiver_unsubscribe(-1);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, ret);
+    ret = ieee802154_transceiver_subscribe(NULL, test_subscriber_callback, NULL, &ids[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    for (int i = 0; i < CONFIG_IEEE802154_TRANSCEIVER_SUBSCRIBER_MAX; i++) {
+        ret = ieee802154_transceiver_unsubscribe(ids[i]);
+        TEST_ASSERT_EQUAL(ESP_OK, ret);
+    }
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Duplicate Suppression", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    ret = ieee802154_transceiver_set_dedupe(500);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ieee802154_transceiver_stats_t stats;
+    ret = ieee802154_transceiver_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(0, stats.rx_dropped_duplicate);
+
+    ret = ieee802154_transceiver_set_dedupe(0);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Transmit Async", "[valid]") {
+    uint8_t payload[] = "async";
+    ieee802154_frame_t frame = {
+        .fcf = {
+            .frameType = IEEE802154_FRAME_TYPE_DATA,
+            .destAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .srcAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .frameVersion = IEEE802154_VERSION_2006,
+        },
+        .destPanId = 0x1234,
+        .destAddress = {0xFF, 0xFF},
+        .destAddrLen = 2,
+        .srcPanId = 0x1234,
+        .srcAddress = {0xAB, 0xCD},
+        .srcAddrLen = 2,
+        .payload = payload,
+        .payloadLen = sizeof(payload),
+    };
+
+    // Not initialized yet
+    esp_err_t ret = ieee802154_transceiver_transmit_async(&frame, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    // Initialize transceiver
+    ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Invalid arguments
+    ret = ieee802154_transceiver_transmit_async(NULL, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_transmit_channel_async(&frame, 27, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Valid frame is queued
+    ret = ieee802154_transceiver_transmit_async(&frame, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Raw frames are queued as they are
+    const uint8_t raw[] = { 5, 0x02, 0x00, 0x2a, 0x00, 0x00 };
+    const uint8_t too_long[] = { 128 };
+    ret = ieee802154_transceiver_transmit_raw_async(raw, 27, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_transmit_raw_async(too_long, 0, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, ret);
+    ret = ieee802154_transceiver_transmit_raw_async(raw, 13, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Transmit Policy", "[valid]") {
+    ieee802154_transceiver_tx_policy_t csma = IEEE802154_TRANSCEIVER_TX_POLICY_CSMA;
+    ieee802154_transceiver_tx_policy_t policy;
+
+    // Out-of-range settings are rejected at initialization
+    ieee802154_transceiver_config_t config = IEEE802154_TRANSCEIVER_CONFIG_DEFAULT(TEST_CHANNEL);
+    config.tx_policy.max_be = 9;
+    esp_err_t ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    config.tx_policy = csma;
+    ret = ieee802154_transceiver_init_with_config(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_get_tx_policy(&policy);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_TRUE(policy.cca);
+    TEST_ASSERT_EQUAL(3, policy.max_retries);
+
+    // And at runtime
+    policy.min_be = 6;
+    ret = ieee802154_transceiver_set_tx_policy(&policy);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_set_tx_policy(NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_get_tx_policy(NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    policy = (ieee802154_transceiver_tx_policy_t){ .max_retries = 1 };
+    ret = ieee802154_transceiver_set_tx_policy(&policy);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Statistics", "[valid]") {
+    ieee802154_transceiver_stats_t stats;
+
+    esp_err_t ret = ieee802154_transceiver_get_stats(NULL, false);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Initialize transceiver
+    ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // A queued frame is counted once
+    const uint8_t raw[] = { 5, 0x02, 0x00, 0x2a, 0x00, 0x00 };
+    ret = ieee802154_transceiver_transmit_raw_async(raw, 0, NULL, NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(1, stats.tx_queued);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, stats.tx_queue_high_water);
+
+    // Reset clears everything, high-water marks included
+    ret = ieee802154_transceiver_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(1, stats.tx_queued);
+    ret = ieee802154_transceiver_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(0, stats.tx_queued);
+    TEST_ASSERT_EQUAL(0, stats.tx_queue_high_water);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Trace", "[valid]") {
+    ieee802154_transceiver_trace_hist_t hist;
+
+#if CONFIG_IEEE802154_TRANSCEIVER_TRACE
+    esp_err_t ret = ieee802154_transceiver_trace_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_trace_get(IEEE802154_TRANSCEIVER_TRACE_STAGE_MAX, &hist);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_trace_get(IEEE802154_TRANSCEIVER_TRACE_QUEUE, &hist);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(0, hist.count);
+    TEST_ASSERT_EQUAL(0, ieee802154_transceiver_trace_percentile(&hist, 99));
+#else
+    esp_err_t ret = ieee802154_transceiver_trace_get(IEEE802154_TRANSCEIVER_TRACE_QUEUE, &hist);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, ret);
+#endif
+
+    TEST_ASSERT_EQUAL_STRING("relay", ieee802154_transceiver_trace_stage_name(IEEE802154_TRANSCEIVER_TRACE_RELAY));
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Frame Template", "[valid]") {
+    uint8_t payload[] = {0x00, 0x00, 0x00, 0x00};
+    ieee802154_frame_t frame = {
+        .fcf = {
+            .frameType = IEEE802154_FRAME_TYPE_DATA,
+            .panIdCompression = 1,
+            .destAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .srcAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .frameVersion = IEEE802154_VERSION_2006,
+        },
+        .sequenceNumber = 0x01,
+        .destPanId = 0x1234,
+        .destAddress = {0xFF, 0xFF},
+        .destAddrLen = 2,
+        .srcPanId = 0x1234,
+        .srcAddress = {0xAB, 0xCD},
+        .srcAddrLen = 2,
+        .payload = payload,
+        .payloadLen = sizeof(payload),
+    };
+
+    ieee802154_transceiver_template_t tmpl;
+    esp_err_t ret = ieee802154_transceiver_template_build(&tmpl, &frame);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(3, tmpl.seq_offset);
+    TEST_ASSERT_EQUAL(sizeof(payload), tmpl.payload_len);
+
+    // Patch sequence number and the last two payload bytes in place
+    const uint8_t value[] = {0xbe, 0xef};
+    ieee802154_transceiver_template_set_seq(&tmpl, 0x42);
+    ret = ieee802154_transceiver_template_patch(&tmpl, 2, value, sizeof(value));
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8(0x42, tmpl.frame[3]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(value, &tmpl.frame[tmpl.payload_offset + 2], sizeof(value));
+
+    // Patches must stay inside the payload
+    ret = ieee802154_transceiver_template_patch(&tmpl, 3, value, sizeof(value));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Channel Hopping", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Channels outside 11-26 are rejected
+    ieee802154_transceiver_hop_config_t config = {
+        .channel_mask = 1 << 10,
+        .dwell_ms = 10,
+    };
+    ret = ieee802154_transceiver_hop_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Hop over two channels for a few cycles
+    config.channel_mask = (1 << 11) | (1 << 12);
+    ret = ieee802154_transceiver_hop_start(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_hop_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    ret = ieee802154_transceiver_hop_stop();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    ieee802154_transceiver_hop_stats_t stats;
+    ret = ieee802154_transceiver_hop_get_stats(11, &stats);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_GREATER_THAN(0, stats.visits);
+    ret = ieee802154_transceiver_hop_get_stats(13, &stats);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(0, stats.visits);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Energy Scan", "[valid]") {
+    ieee802154_transceiver_scan_result_t result;
+
+    // The radio must be running
+    esp_err_t ret = ieee802154_transceiver_scan_energy(NULL, &result);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    // Initialize transceiver
+    ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Channels outside 11-26 are rejected
+    ieee802154_transceiver_scan_config_t config = { .channel_mask = 1 << 10 };
+    ret = ieee802154_transceiver_scan_energy(&config, &result);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // The whole band with the defaults
+    ret = ieee802154_transceiver_scan_energy(NULL, &result);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL_HEX32(0x07FFF800, result.channel_mask);
+    TEST_ASSERT_LESS_THAN(100000, result.duration_us);
+    for (int i = 0; i < 16; i++) {
+        TEST_ASSERT_EQUAL(4, result.channels[i].samples);
+        TEST_ASSERT_LESS_OR_EQUAL(result.channels[i].energy_max, result.channels[i].energy_mean);
+    }
+    TEST_ASSERT_EQUAL(TEST_CHANNEL, esp_ieee802154_get_channel());
+
+    uint8_t ranked[16];
+    size_t count;
+    ret = ieee802154_transceiver_scan_rank(&result, ranked, 16, &count);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(16, count);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Bridge", "[valid]") {
+    // Initialize transceiver
+    esp_err_t ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Batches larger than the transmit queue are rejected
+    ieee802154_transceiver_bridge_config_t config = {
+        .src_channel = TEST_CHANNEL,
+        .dst_channel = 13,
+        .max_batch = CONFIG_IEEE802154_TRANSCEIVER_TX_QUEUE_DEPTH + 1,
+    };
+    ret = ieee802154_transceiver_bridge_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    // Only data frames
+    ieee802154_transceiver_filter_t filter = {
+        .match = IEEE802154_TRANSCEIVER_FILTER_FRAME_TYPE,
+        .frame_types = 1 << 1,
+    };
+    config.filter = &filter;
+    config.max_batch = 4;
+    config.max_hold_ms = 2;
+    ret = ieee802154_transceiver_bridge_start(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_bridge_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    ret = ieee802154_transceiver_bridge_stop();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_bridge_stop();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    // Statistics are cleared by a reset read
+    ieee802154_transceiver_bridge_stats_t stats;
+    ret = ieee802154_transceiver_bridge_get_stats(&stats, true);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_bridge_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(0, stats.forwarded);
+    TEST_ASSERT_EQUAL(0, stats.latency_samples);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
+
+static size_t pcap_output_bytes = 0;
+
+static void test_pcap_output(const uint8_t *data, size_t len, void *ctx) {
+    pcap_output_bytes += len;
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Capture", "[valid]") {
+    esp_err_t ret;
+
+    // An output is required and blocks must hold at least one frame
+    ieee802154_transceiver_pcap_config_t config = {0};
+    ret = ieee802154_transceiver_pcap_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    config.output = test_pcap_output;
+    config.block_size = 64;
+    ret = ieee802154_transceiver_pcap_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+
+    uint8_t frame[] = { 12, 0x41, 0x88, 0x01, 0x34, 0x12, 0xff, 0xff, 0x01, 0x00, 0xaa, 0x00, 0x00 };
+    esp_ieee802154_frame_info_t info = { .channel = TEST_CHANNEL, .rssi = -60, .lqi = 200 };
+    ret = ieee802154_transceiver_pcap_record(frame, &info);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    pcap_output_bytes = 0;
+    config.block_size = 0;
+    config.flush_ms = 10;
+    ret = ieee802154_transceiver_pcap_start(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_pcap_record(frame, &info);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_pcap_stop();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_pcap_stop();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    // Everything recorded was sent on stop
+    ieee802154_transceiver_pcap_stats_t stats;
+    ret = ieee802154_transceiver_pcap_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(1, stats.frames);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    TEST_ASSERT_EQUAL(pcap_output_bytes, stats.bytes);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Capture Ring", "[valid]") {
+    esp_err_t ret;
+    const uint8_t *image;
+    size_t len;
+
+    // The ring must hold at least a few frames
+    ieee802154_transceiver_capture_config_t config = { .size = 256 };
+    ret = ieee802154_transceiver_capture_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_capture_trigger();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    config.size = 8192;
+    ret = ieee802154_transceiver_capture_start(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_capture_get_image(&image, &len);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    // Without post-trigger time the ring freezes on the trigger
+    ret = ieee802154_transceiver_capture_trigger();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ieee802154_transceiver_capture_stats_t stats;
+    ret = ieee802154_transceiver_capture_get_stats(&stats, false);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_TRUE(stats.triggered);
+    TEST_ASSERT_TRUE(stats.frozen);
+    ret = ieee802154_transceiver_capture_get_image(&image, &len);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(8192, len);
+
+    // No partition configured
+    ret = ieee802154_transceiver_capture_save();
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, ret);
+
+    ret = ieee802154_transceiver_capture_resume();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_capture_get_image(&image, &len);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    ret = ieee802154_transceiver_capture_stop();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_capture_stop();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Neighbor Table", "[valid]") {
+    esp_err_t ret;
+    const uint8_t addr[2] = { 0x01, 0x00 };
+    ieee802154_transceiver_neighbor_t neighbor;
+    size_t count;
+
+    ieee802154_transceiver_neighbor_config_t config = { .capacity = 2048 };
+    ret = ieee802154_transceiver_neighbor_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_neighbor_get(addr, 2, 0x1234, &neighbor);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    ret = ieee802154_transceiver_neighbor_start(NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_neighbor_start(NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    // Nothing heard yet
+    ret = ieee802154_transceiver_neighbor_get(addr, 2, 0x1234, &neighbor);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, ret);
+    ret = ieee802154_transceiver_neighbor_get(addr, 4, 0x1234, &neighbor);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_neighbor_list(&neighbor, 1, &count);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(0, count);
+
+    ret = ieee802154_transceiver_neighbor_stop();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_neighbor_stop();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+}
+
+static void frag_rx_callback(const uint8_t *data, size_t len, const ieee802154_transceiver_frag_source_t *source,
+                             void *ctx) {
+}
+
+TEST_CASE("IEEE 802.15.4 Transceiver Fragmentation", "[valid]") {
+    static uint8_t datagram[300];
+    ieee802154_frame_t frame = {
+        .fcf = {
+            .frameType = IEEE802154_FRAME_TYPE_DATA,
+            .panIdCompression = 1,
+            .destAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .srcAddrMode = IEEE802154_ADDR_MODE_SHORT,
+            .frameVersion = IEEE802154_VERSION_2006,
+        },
+        .destPanId = 0x1234,
+        .destAddress = {0xFF, 0xFF},
+        .destAddrLen = 2,
+        .srcPanId = 0x1234,
+        .srcAddress = {0xAB, 0xCD},
+        .srcAddrLen = 2,
+    };
+    ieee802154_transceiver_frag_iov_t iov[2] = {
+        { datagram, 100 },
+        { &datagram[100], sizeof(datagram) - 100 },
+    };
+    ieee802154_transceiver_frag_send_result_t result;
+
+    // Not initialized yet
+    esp_err_t ret = ieee802154_transceiver_frag_send(&frame, iov, 2, 0, &result);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    ret = ieee802154_transceiver_init(TEST_CHANNEL);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    // Invalid arguments
+    ret = ieee802154_transceiver_frag_send(NULL, iov, 2, 0, &result);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_frag_send(&frame, iov, 2, 27, &result);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    ret = ieee802154_transceiver_frag_send(&frame, iov, 0, 0, &result);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, ret);
+
+    // Broadcast, 108 bytes per fragment after the 9-byte MAC header
+    ret = ieee802154_transceiver_frag_send(&frame, iov, 2, 0, &result);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(3, result.fragments);
+    TEST_ASSERT_EQUAL(3, result.sent);
+
+    // Reassembly needs a callback
+    ieee802154_transceiver_frag_rx_config_t config = { .callback = NULL };
+    ret = ieee802154_transceiver_frag_rx_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    config.callback = frag_rx_callback;
+    ret = ieee802154_transceiver_frag_rx_start(&config);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_frag_rx_start(&config);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+    ret = ieee802154_transceiver_frag_rx_stop();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    ret = ieee802154_transceiver_frag_rx_stop();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ret);
+
+    // Deinitialize transceiver
+    ret = ieee802154_transceiver_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+}
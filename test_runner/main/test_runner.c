@@ -1,11 +1,11 @@
-#include <stdio.h>
-#include <string.h>
-
-#include "unity.h"
-
-void app_main(void)
-{
-    UNITY_BEGIN();
-    unity_run_all_tests();
-    UNITY_END();
+#include <stdio.h>
+#include <string.h>
+
+#include "unity.h"
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    UNITY_END();
 }
\ No newline at end of file
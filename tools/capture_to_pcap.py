@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Convert an IEEE 802.15.4 capture ring image to a pcap file.
+
+The image is what ieee802154_transceiver_capture_get_image() returns, or the
+capture partition read back from flash, e.g.:
+
+    esptool.py read_flash 0x110000 0x40000 capture.bin
+    python capture_to_pcap.py capture.bin capture.pcap
+
+Packets are written as LINKTYPE_IEEE802_15_4_TAP with RSS, channel and LQI,
+without the FCS, like the live pcapng stream. The layout is defined in
+src/capture_ring.h.
+"""
+
+import argparse
+import mmap
+import struct
+import sys
+
+MAGIC = 0x52433449
+VERSION = 1
+FLAG_TRIGGERED = 0x01
+FLAG_FROZEN = 0x02
+META_LEN = 3
+
+# magic, version, header_len, capacity, head, tail, used, records, flags,
+# tail_time_us, head_time_us, epoch_offset_us, trigger_time_us
+HEADER = struct.Struct("<IHHIIIIIIqqqq")
+
+LINKTYPE_IEEE802_15_4_TAP = 283
+TAP_FCS_TYPE = 0
+TAP_RSS = 1
+TAP_CHANNEL = 3
+TAP_LQI = 10
+
+
+def read_header(image):
+    if len(image) < HEADER.size:
+        raise ValueError("image too short")
+    fields = HEADER.unpack_from(image, 0)
+    header = dict(zip(("magic", "version", "header_len", "capacity", "head", "tail", "used", "records",
+                       "flags", "tail_time_us", "head_time_us", "epoch_offset_us", "trigger_time_us"), fields))
+    if header["magic"] != MAGIC:
+        raise ValueError("not a capture ring image (magic 0x%08x)" % header["magic"])
+    if header["version"] != VERSION:
+        raise ValueError("unsupported image version %d" % header["version"])
+    if header["header_len"] + header["capacity"] > len(image) or header["used"] > header["capacity"]:
+        raise ValueError("image truncated or corrupt")
+    return header
+
+
+def records(image, header):
+    """Yield (time_us, psdu, channel, rssi, lqi), oldest first."""
+    data = header["header_len"]
+    capacity = header["capacity"]
+    pos = header["tail"]
+
+    def byte():
+        nonlocal pos
+        value = image[data + pos]
+        pos = pos + 1 if pos + 1 < capacity else 0
+        return value
+
+    def take(count):
+        return bytes(byte() for _ in range(count))
+
+    time_us = header["tail_time_us"]
+    for index in range(header["records"]):
+        psdu_len = byte()
+        delta_us = 0
+        shift = 0
+        while True:
+            value = byte()
+            delta_us |= (value & 0x7F) << shift
+            shift += 7
+            if not value & 0x80:
+                break
+        channel, rssi, lqi = struct.unpack("<BbB", take(META_LEN))
+        psdu = take(psdu_len)
+        # The oldest record's delta points at an evicted record
+        if index:
+            time_us += delta_us
+        yield time_us, psdu, channel, rssi, lqi
+
+
+def tlv(tlv_type, value):
+    padded = value + b"\0" * (-len(value) % 4)
+    return struct.pack("<HH", tlv_type, len(value)) + padded
+
+
+def tap_packet(psdu, channel, rssi, lqi):
+    tlvs = (tlv(TAP_FCS_TYPE, b"\0") + tlv(TAP_RSS, struct.pack("<f", rssi)) +
+            tlv(TAP_CHANNEL, struct.pack("<HB", channel, 0)) + tlv(TAP_LQI, bytes([lqi])))
+    return struct.pack("<HH", 0, 4 + len(tlvs)) + tlvs + psdu[:-2]
+
+
+def convert(image, out):
+    header = read_header(image)
+    out.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 0xFFFF, LINKTYPE_IEEE802_15_4_TAP))
+    count = 0
+    for time_us, psdu, channel, rssi, lqi in records(image, header):
+        packet = tap_packet(psdu, channel, rssi, lqi)
+        unix_us = time_us + header["epoch_offset_us"]
+        out.write(struct.pack("<IIII", unix_us // 1000000, unix_us % 1000000, len(packet), len(packet)))
+        out.write(packet)
+        count += 1
+    return header, count
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", help="capture ring image or partition dump")
+    parser.add_argument("pcap", help="pcap file to write")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as image_file:
+        image = mmap.mmap(image_file.fileno(), 0, access=mmap.ACCESS_READ)
+        try:
+            with open(args.pcap, "wb") as out:
+                header, count = convert(image, out)
+        except ValueError as error:
+            sys.exit("%s: %s" % (args.image, error))
+        finally:
+            image.close()
+
+    span_s = (header["head_time_us"] - header["tail_time_us"]) / 1e6 if count else 0
+    print("%d frames over %.3f s%s%s" % (count, span_s,
+                                         ", frozen" if header["flags"] & FLAG_FROZEN else "",
+                                         ", trigger at %+.3f s" % ((header["trigger_time_us"] - header["head_time_us"]) / 1e6)
+                                         if header["flags"] & FLAG_TRIGGERED else ""))
+
+
+if __name__ == "__main__":
+    main()